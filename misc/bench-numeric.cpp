@@ -0,0 +1,59 @@
+// Micro benchmark for integer exponentiation. Compares the old
+// `**` kernel (float std::pow cast back to int) against exponentiation
+// by squaring and double precision std::pow.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=c++17 misc/bench-numeric.cpp -o bench-numeric && ./bench-numeric
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+static int
+old_pow(int b, int e) {
+    return static_cast<int>(std::pow(static_cast<float>(b), static_cast<float>(e)));
+}
+
+static int64_t
+squaring_pow(int64_t b, int64_t e) {
+    int64_t res = 1;
+    while (e) {
+        if (e & 1)
+            res *= b;
+        e >>= 1;
+        if (e)
+            b *= b;
+    }
+    return res;
+}
+
+template <typename F>
+static double
+bench(const char *name, F f) {
+    auto start = std::chrono::steady_clock::now();
+    volatile int64_t sink = 0;
+    for (int rep = 0; rep < 200; ++rep)
+        for (int64_t b = 2; b < 64; ++b)
+            for (int64_t e = 0; e < 10; ++e)
+                sink = sink + f(b, e);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+    printf("%-10s %8.3f ms\n", name, ms);
+    return ms;
+}
+
+int
+main(void) {
+    bench("old", [](int64_t b, int64_t e) { return static_cast<int64_t>(old_pow(b, e)); });
+    bench("squaring", squaring_pow);
+    bench("double", [](int64_t b, int64_t e) { return static_cast<int64_t>(std::pow(double(b), double(e))); });
+
+    // Everything above 2^24 loses bits when routed through float.
+    int mismatches = 0;
+    for (int64_t b = 2; b < 64; ++b)
+        for (int64_t e = 0; e < 10; ++e)
+            if (static_cast<int64_t>(old_pow(b, e)) != squaring_pow(b, e))
+                ++mismatches;
+    printf("old kernel wrong on %d of %d inputs\n", mismatches, 62*10);
+    return 0;
+}
@@ -0,0 +1,15 @@
+module Classes
+
+# Constructing class instances with members computed from the parameters.
+
+class Point [x, y] {
+    @pub let x = x;
+    @pub let y = y;
+    @pub let norm1 = x + y;
+}
+
+let n = 0;
+for i in 0 to 5000 {
+    let p = Point(i, i+1);
+    n += p.norm1;
+}
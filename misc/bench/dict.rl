@@ -0,0 +1,20 @@
+module DictBench
+
+# `Dict` inserts followed by hits and misses.
+
+let d = Dict();
+for i in 0 to 5000 {
+    d.insert(i, i*2);
+}
+
+let hits = 0;
+for i in 0 to 10000 {
+    if d.has_key(i) {
+        hits += 1;
+    }
+}
+
+let sum = 0;
+for i in 0 to 5000 {
+    sum += d[i].unwrap();
+}
@@ -0,0 +1,345 @@
+// Runs the EARL micro-benchmarks in misc/bench/ against an `earl`
+// binary. Every `*.rl` file is run as a script, and every `*.args`
+// file gives the arguments for one run of `earl` (one per line), for
+// things like `-O` that are not a script. Each one is run a few times
+// to warm up the page cache and then timed over a number of
+// repetitions, more of them for the ones that only take a few
+// milliseconds, like the startup benchmarks.
+// The results are written as JSON and, given a baseline from an
+// earlier run, compared by median wall time. A benchmark that got
+// slower than the threshold (with even its fastest run slower than
+// the old median) makes the run fail.
+//
+// Normally run through CMake:
+//   cmake --build build --target earl-bench-baseline   # save a baseline
+//   cmake --build build --target earl-bench            # compare against it
+//
+// Or by hand:
+//   earl-bench-harness --earl build/earl --dir misc/bench --out now.json
+//                      [--baseline before.json] [--threshold 10]
+//                      [--warmup 2] [--reps 10] [--min-time 200] [--filter fib]
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Options {
+    std::string earl = "";
+    std::string dir = "";
+    std::string out = "";
+    std::string baseline = "";
+    std::string filter = "";
+    double threshold = 10.0;
+    double min_time_ms = 200.0;
+    int warmup = 2;
+    int reps = 10;
+};
+
+struct Bench {
+    std::string name;
+    std::vector<std::string> args;
+};
+
+struct Result {
+    std::string name;
+    std::vector<double> wall_ms;
+    std::vector<double> cpu_ms;
+    double min, median, mean, stddev, max;
+    double cpu_median;
+};
+
+static void
+usage(const char *prog) {
+    fprintf(stderr, "usage: %s --earl <path> --dir <corpus> [--out <file>] [--baseline <file>]\n", prog);
+    fprintf(stderr, "       [--threshold <percent>] [--warmup <n>] [--reps <n>] [--min-time <ms>] [--filter <substr>]\n");
+    std::exit(2);
+}
+
+static Options
+parse_args(int argc, char **argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i+1 >= argc)
+            usage(argv[0]);
+        std::string value = argv[++i];
+        if (arg == "--earl")
+            opts.earl = value;
+        else if (arg == "--dir")
+            opts.dir = value;
+        else if (arg == "--out")
+            opts.out = value;
+        else if (arg == "--baseline")
+            opts.baseline = value;
+        else if (arg == "--filter")
+            opts.filter = value;
+        else if (arg == "--threshold")
+            opts.threshold = std::atof(value.c_str());
+        else if (arg == "--warmup")
+            opts.warmup = std::atoi(value.c_str());
+        else if (arg == "--reps")
+            opts.reps = std::atoi(value.c_str());
+        else if (arg == "--min-time")
+            opts.min_time_ms = std::atof(value.c_str());
+        else
+            usage(argv[0]);
+    }
+    if (opts.earl == "" || opts.dir == "" || opts.reps < 1 || opts.warmup < 0)
+        usage(argv[0]);
+
+    // The scripts run from the corpus directory, so a relative
+    // path to `earl` would stop working.
+    char buf[PATH_MAX];
+    if (!realpath(opts.earl.c_str(), buf)) {
+        fprintf(stderr, "error: could not find `%s`: %s\n", opts.earl.c_str(), strerror(errno));
+        std::exit(2);
+    }
+    opts.earl = buf;
+    return opts;
+}
+
+static bool
+ends_with(const std::string &s, const std::string &suffix) {
+    return s.size() > suffix.size() && s.compare(s.size()-suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::vector<std::string>
+read_args(const std::string &path) {
+    std::vector<std::string> res = {};
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+        if (line != "" && line[0] != '#')
+            res.push_back(line);
+    return res;
+}
+
+static std::vector<Bench>
+find_benches(const Options &opts) {
+    std::vector<Bench> res = {};
+    DIR *dir = opendir(opts.dir.c_str());
+    if (!dir) {
+        fprintf(stderr, "error: could not open `%s`: %s\n", opts.dir.c_str(), strerror(errno));
+        std::exit(2);
+    }
+    while (struct dirent *ent = readdir(dir)) {
+        std::string file = ent->d_name;
+        if (opts.filter != "" && file.find(opts.filter) == std::string::npos)
+            continue;
+        if (ends_with(file, ".rl"))
+            res.push_back(Bench{file.substr(0, file.size()-3), {file}});
+        else if (ends_with(file, ".args"))
+            res.push_back(Bench{file.substr(0, file.size()-5), read_args(opts.dir+"/"+file)});
+    }
+    closedir(dir);
+    std::sort(res.begin(), res.end(), [](const Bench &a, const Bench &b) { return a.name < b.name; });
+    return res;
+}
+
+// Run `earl <args>` once from the corpus directory with its output
+// thrown away. Fills in the wall and CPU (user+sys) time of the child.
+static bool
+run_once(const Options &opts, const Bench &bench, double &wall_ms, double &cpu_ms) {
+    std::vector<char *> argv = {const_cast<char *>(opts.earl.c_str())};
+    for (const std::string &arg : bench.args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull != -1) {
+            dup2(devnull, STDOUT_FILENO);
+            dup2(devnull, STDERR_FILENO);
+        }
+        if (chdir(opts.dir.c_str()) == -1)
+            _exit(127);
+        execv(opts.earl.c_str(), argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) == -1) {
+        perror("wait4");
+        return false;
+    }
+    wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+    cpu_ms = (usage.ru_utime.tv_sec+usage.ru_stime.tv_sec)*1e3
+        + (usage.ru_utime.tv_usec+usage.ru_stime.tv_usec)/1e3;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static double
+median_of(std::vector<double> xs) {
+    std::sort(xs.begin(), xs.end());
+    size_t n = xs.size();
+    return n%2 == 1 ? xs[n/2] : (xs[n/2-1]+xs[n/2])/2.0;
+}
+
+static void
+summarize(Result &res) {
+    auto &xs = res.wall_ms;
+    res.min = *std::min_element(xs.begin(), xs.end());
+    res.max = *std::max_element(xs.begin(), xs.end());
+    res.median = median_of(xs);
+    res.cpu_median = median_of(res.cpu_ms);
+    double sum = 0.0;
+    for (double x : xs)
+        sum += x;
+    res.mean = sum/xs.size();
+    double var = 0.0;
+    for (double x : xs)
+        var += (x-res.mean)*(x-res.mean);
+    res.stddev = xs.size() > 1 ? std::sqrt(var/(xs.size()-1)) : 0.0;
+}
+
+static void
+json_escape_into(std::string &res, const std::string &s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            res += '\\';
+        res += c;
+    }
+}
+
+static void
+write_json(const Options &opts, const std::vector<Result> &results) {
+    std::string json = "{\n  \"earl\": \"";
+    json_escape_into(json, opts.earl);
+    json += "\",\n  \"warmup\": "+std::to_string(opts.warmup)+",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        char buf[512];
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    {\"name\": \"%s\", \"runs\": %zu, \"median_ms\": %.3f, \"min_ms\": %.3f, \"mean_ms\": %.3f, "
+                      "\"stddev_ms\": %.3f, \"max_ms\": %.3f, \"cpu_median_ms\": %.3f}",
+                      i == 0 ? "" : ",", r.name.c_str(), r.wall_ms.size(), r.median, r.min, r.mean, r.stddev, r.max, r.cpu_median);
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    std::ofstream out(opts.out);
+    if (!out) {
+        fprintf(stderr, "error: could not write `%s`\n", opts.out.c_str());
+        std::exit(2);
+    }
+    out << json;
+}
+
+// Only reads back what `write_json` writes: the median of each name.
+static std::map<std::string, double>
+read_baseline(const std::string &path) {
+    std::map<std::string, double> res = {};
+    std::ifstream in(path);
+    if (!in)
+        return res;
+    std::stringstream buf;
+    buf << in.rdbuf();
+    const std::string s = buf.str();
+
+    const std::string name_key = "\"name\": \"", median_key = "\"median_ms\": ";
+    size_t pos = 0;
+    while ((pos = s.find(name_key, pos)) != std::string::npos) {
+        pos += name_key.size();
+        size_t end = s.find('"', pos);
+        size_t median = s.find(median_key, end);
+        if (end == std::string::npos || median == std::string::npos)
+            break;
+        res[s.substr(pos, end-pos)] = std::atof(s.c_str()+median+median_key.size());
+        pos = median;
+    }
+    return res;
+}
+
+int
+main(int argc, char **argv) {
+    Options opts = parse_args(argc, argv);
+    std::vector<Bench> benches = find_benches(opts);
+    if (benches.empty()) {
+        fprintf(stderr, "error: no benchmarks found in `%s`\n", opts.dir.c_str());
+        return 2;
+    }
+
+    std::map<std::string, double> baseline = {};
+    if (opts.baseline != "") {
+        baseline = read_baseline(opts.baseline);
+        if (baseline.empty())
+            printf("no baseline at `%s`, only measuring\n", opts.baseline.c_str());
+    }
+
+    printf("%-22s %10s %10s %10s %10s %9s\n", "benchmark", "median", "min", "stddev", "baseline", "change");
+
+    std::vector<Result> results = {};
+    int regressions = 0, failures = 0;
+    for (const Bench &bench : benches) {
+        Result res;
+        res.name = bench.name;
+
+        bool ok = true;
+        double wall = 0.0, cpu = 0.0, total = 0.0;
+        for (int i = 0; ok && i < opts.warmup; ++i)
+            ok = run_once(opts, bench, wall, cpu);
+        for (int i = 0; ok && (i < opts.reps || total < opts.min_time_ms); ++i) {
+            ok = run_once(opts, bench, wall, cpu);
+            res.wall_ms.push_back(wall);
+            res.cpu_ms.push_back(cpu);
+            total += wall;
+        }
+        if (!ok) {
+            std::string cmd = opts.earl;
+            for (const std::string &arg : bench.args)
+                cmd += " "+arg;
+            printf("%-22s FAILED (run `%s` from `%s`)\n", res.name.c_str(), cmd.c_str(), opts.dir.c_str());
+            ++failures;
+            continue;
+        }
+        summarize(res);
+
+        printf("%-22s %8.2fms %8.2fms %8.2fms", res.name.c_str(), res.median, res.min, res.stddev);
+        auto it = baseline.find(res.name);
+        if (it != baseline.end() && it->second > 0.0) {
+            // The median alone moves by more than the threshold on a
+            // busy machine, so also require every run to be slower
+            // than what was typical before.
+            double change = (res.median-it->second)/it->second*100.0;
+            bool regressed = change > opts.threshold && res.min > it->second;
+            printf(" %8.2fms %+8.1f%%%s", it->second, change, regressed ? "  REGRESSION" : "");
+            regressions += regressed;
+        }
+        printf("\n");
+        results.push_back(std::move(res));
+    }
+
+    if (opts.out != "") {
+        write_json(opts, results);
+        printf("results written to `%s`\n", opts.out.c_str());
+    }
+
+    if (failures > 0 || regressions > 0) {
+        printf("%d failed, %d slower than the %.1f%% threshold\n", failures, regressions, opts.threshold);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+module Fib
+
+# Recursive calls: one user function call per node.
+
+fn fib(n) {
+    if n < 2 {
+        return n;
+    }
+    return fib(n-1) + fib(n-2);
+}
+
+let _ = fib(18);
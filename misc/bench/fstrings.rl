@@ -0,0 +1,12 @@
+module FStrings
+
+# Formatted strings with a few interpolated values each.
+
+let name = "earl";
+let total = 0;
+for i in 0 to 5000 {
+    let twice = i*2;
+    let rem = i%3;
+    let s = f"{name}: {i} of {twice} ({rem})";
+    total += len(s);
+}
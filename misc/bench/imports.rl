@@ -0,0 +1,23 @@
+module Imports
+
+# Startup dominated by reading, lexing and parsing the standard library.
+
+import "std/assert.rl";
+import "std/colors.rl";
+import "std/io.rl";
+import "std/math.rl";
+import "std/system.rl";
+import "std/time.rl";
+import "std/utils.rl";
+import "std/datatypes/char.rl";
+import "std/datatypes/dictionary.rl";
+import "std/datatypes/list.rl";
+import "std/datatypes/str.rl";
+import "std/containers/queue.rl";
+import "std/containers/set.rl";
+import "std/containers/stack.rl";
+import "std/containers/matrix.rl";
+import "std/containers/interval-tree.rl";
+import "std/algorithms/encryption.rl";
+import "std/parsers/basic-lexer.rl";
+import "std/parsers/toml.rl";
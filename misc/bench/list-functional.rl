@@ -0,0 +1,8 @@
+module ListFunctional
+
+# Closures driven by `map`, `filter` and `fold` over a large list.
+
+let lst = (0..15000);
+let mapped = lst.map(|x| { return x*3; });
+let evens = mapped.filter(|x| { return x%2 == 0; });
+let total = evens.fold(|x, acc| { return acc + x; }, 0);
@@ -0,0 +1,14 @@
+module Loops
+
+# Counted `for` and `while` loops with integer arithmetic in the body.
+
+let sum = 0;
+for i in 0 to 25000 {
+    sum += i%7;
+}
+
+let j = 0;
+while j < 12500 {
+    sum -= 1;
+    j += 1;
+}
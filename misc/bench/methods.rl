@@ -0,0 +1,25 @@
+module Methods
+
+# Method calls on one instance, public calling private.
+
+class Counter [start] {
+    let count = start;
+
+    fn step(by) {
+        this.count += by;
+    }
+
+    @pub fn incr() {
+        this.step(1);
+    }
+
+    @pub fn get() {
+        return this.count;
+    }
+}
+
+let c = Counter(0);
+for i in 0 to 8000 {
+    c.incr();
+}
+let _ = c.get();
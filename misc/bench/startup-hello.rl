@@ -0,0 +1,5 @@
+module StartupHello
+
+# Startup: everything before and after a single statement.
+
+println("hello");
@@ -0,0 +1,7 @@
+module StartupImport
+
+# Startup with the one stdlib import most scripts have.
+
+import "std/system.rl";
+
+println("hello");
@@ -0,0 +1,16 @@
+module Strings
+
+# Building a string one piece at a time and reading it back.
+
+let s = "";
+for i in 0 to 10000 {
+    s += "ab";
+    s += 'c';
+}
+
+let n = 0;
+foreach c in s {
+    if c == 'c' {
+        n += 1;
+    }
+}
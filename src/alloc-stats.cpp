@@ -0,0 +1,246 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "alloc-stats.hpp"
+#include "earl.hpp"
+
+// Rows of sites printed in the report.
+#define ALLOC_STATS_SITE_ROWS 25
+
+bool alloc_stats::active = false;
+uint8_t alloc_stats::site = 0;
+
+// Values may be made and freed by worker threads.
+struct Counters {
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> freed_bytes{0};
+};
+
+struct Snapshot {
+    std::string name;
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t bytes;
+    uint64_t freed_bytes;
+};
+
+static Counters types[UINT8_MAX+1];
+static Counters sites[UINT8_MAX+1];
+
+// Sites are `<none>`, then the statements, the binary and
+// unary expressions and the terms, in the order of their enums.
+#define STMT_SITES 1
+#define EXPR_SITES (STMT_SITES+static_cast<int>(StmtType::Try)+1)
+#define TERM_SITES (EXPR_SITES+static_cast<int>(ExprType::Unary)+1)
+#define N_SITES    (TERM_SITES+static_cast<int>(ExprTermType::Case)+1)
+
+static const char *site_names[] = {
+    "<none>",
+    "stmt:def", "stmt:let", "stmt:block", "stmt:mut", "stmt:expr", "stmt:if",
+    "stmt:return", "stmt:break", "stmt:while", "stmt:loop", "stmt:for",
+    "stmt:foreach", "stmt:import", "stmt:mod", "stmt:class", "stmt:match",
+    "stmt:enum", "stmt:continue", "stmt:bash", "stmt:info", "stmt:pipe",
+    "stmt:multiline-bash", "stmt:use", "stmt:exec", "stmt:with", "stmt:try",
+    "expr:term", "expr:binary", "expr:unary",
+    "term:ident", "term:int", "term:str", "term:char", "term:call", "term:list",
+    "term:range", "term:slice", "term:get", "term:mod-access", "term:index",
+    "term:bool", "term:none", "term:closure", "term:tuple", "term:float",
+    "term:dict", "term:fstr", "term:power", "term:case",
+};
+static_assert(sizeof(site_names)/sizeof(*site_names) == N_SITES, "a site is missing a name");
+
+// `type_to_str` has no names for the control flow values
+// and gives `return` the same one as `unit`.
+static std::string
+type_name(int type) {
+    switch (static_cast<earl::value::Type>(type)) {
+    case earl::value::Type::Break:    return "<break>";
+    case earl::value::Type::Continue: return "<continue>";
+    case earl::value::Type::Return:   return "<return>";
+    default: return earl::value::type_to_str(static_cast<earl::value::Type>(type));
+    }
+}
+
+static bool report_registered = false;
+
+static void
+report_atexit(void) {
+    alloc_stats::report();
+}
+
+bool
+alloc_stats::enable(bool report) {
+    if (!compiled)
+        return false;
+    if (report && !report_registered) {
+        std::atexit(report_atexit);
+        report_registered = true;
+    }
+    active = true;
+    return true;
+}
+
+uint8_t
+alloc_stats::stmt_site(StmtType type) {
+    return static_cast<uint8_t>(STMT_SITES+static_cast<int>(type));
+}
+
+uint8_t
+alloc_stats::expr_site(ExprType type) {
+    return static_cast<uint8_t>(EXPR_SITES+static_cast<int>(type));
+}
+
+uint8_t
+alloc_stats::term_site(ExprTermType type) {
+    return static_cast<uint8_t>(TERM_SITES+static_cast<int>(type));
+}
+
+void
+alloc_stats::on_alloc(int type, uint8_t site, size_t size) {
+    types[type].allocs.fetch_add(1, std::memory_order_relaxed);
+    types[type].bytes.fetch_add(size, std::memory_order_relaxed);
+    sites[site].allocs.fetch_add(1, std::memory_order_relaxed);
+    sites[site].bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void
+alloc_stats::on_free(int type, uint8_t site, size_t size) {
+    types[type].frees.fetch_add(1, std::memory_order_relaxed);
+    types[type].freed_bytes.fetch_add(size, std::memory_order_relaxed);
+    sites[site].frees.fetch_add(1, std::memory_order_relaxed);
+    sites[site].freed_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// The counters that were ever used, most allocations first.
+static std::vector<Snapshot>
+snapshot(Counters *counters, bool of_types) {
+    std::vector<Snapshot> res = {};
+    for (int i = 0; i <= UINT8_MAX; ++i) {
+        uint64_t allocs = counters[i].allocs.load(std::memory_order_relaxed);
+        if (allocs == 0)
+            continue;
+        std::string name = of_types
+            ? type_name(i)
+            : (i < N_SITES ? site_names[i] : "site "+std::to_string(i));
+        res.push_back(Snapshot{name,
+                               allocs,
+                               counters[i].frees.load(std::memory_order_relaxed),
+                               counters[i].bytes.load(std::memory_order_relaxed),
+                               counters[i].freed_bytes.load(std::memory_order_relaxed)});
+    }
+    std::sort(res.begin(), res.end(), [](const Snapshot &a, const Snapshot &b) {
+        return a.allocs != b.allocs ? a.allocs > b.allocs : a.name < b.name;
+    });
+    return res;
+}
+
+static std::shared_ptr<earl::value::Obj>
+snapshot_to_dict(const std::vector<Snapshot> &rows) {
+    auto int_of = [](uint64_t n) {
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(n));
+    };
+    auto dict = std::make_shared<earl::value::Dict<std::string>>(earl::value::Type::Str);
+    for (const Snapshot &row : rows) {
+        auto entry = std::make_shared<earl::value::Dict<std::string>>(earl::value::Type::Str);
+        entry->insert("allocs", int_of(row.allocs));
+        entry->insert("frees", int_of(row.frees));
+        entry->insert("live", int_of(row.allocs-row.frees));
+        entry->insert("bytes", int_of(row.bytes));
+        entry->insert("live_bytes", int_of(row.bytes-row.freed_bytes));
+        dict->insert(row.name, entry);
+    }
+    return dict;
+}
+
+std::shared_ptr<earl::value::Obj>
+alloc_stats::to_dict(void) {
+    // Taken before the dictionary is built so that
+    // it does not count its own allocations.
+    auto type_rows = snapshot(types, true);
+    auto site_rows = snapshot(sites, false);
+
+    auto dict = std::make_shared<earl::value::Dict<std::string>>(earl::value::Type::Str);
+    dict->insert("compiled", std::make_shared<earl::value::Bool>(compiled));
+    dict->insert("active", std::make_shared<earl::value::Bool>(active));
+    dict->insert("types", snapshot_to_dict(type_rows));
+    dict->insert("sites", snapshot_to_dict(site_rows));
+    return dict;
+}
+
+std::vector<alloc_stats::TypeTotals>
+alloc_stats::type_totals(void) {
+    std::vector<TypeTotals> res = {};
+    for (const Snapshot &row : snapshot(types, true))
+        res.push_back(TypeTotals{row.name, row.allocs, row.frees, row.bytes, row.freed_bytes});
+    return res;
+}
+
+static void
+write_table(const char *title, const std::vector<Snapshot> &rows, size_t limit) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-20s %12s %12s %12s %14s %14s",
+                  title, "allocs", "frees", "live", "bytes", "live bytes");
+    std::cerr << line << std::endl;
+    for (size_t i = 0; i < rows.size() && i < limit; ++i) {
+        const Snapshot &row = rows[i];
+        std::snprintf(line, sizeof(line), "%-20s %12llu %12llu %12llu %14llu %14llu",
+                      row.name.c_str(),
+                      static_cast<unsigned long long>(row.allocs),
+                      static_cast<unsigned long long>(row.frees),
+                      static_cast<unsigned long long>(row.allocs-row.frees),
+                      static_cast<unsigned long long>(row.bytes),
+                      static_cast<unsigned long long>(row.bytes-row.freed_bytes));
+        std::cerr << line << std::endl;
+    }
+    if (rows.size() > limit)
+        std::cerr << "... " << rows.size()-limit << " more" << std::endl;
+}
+
+void
+alloc_stats::report(void) {
+    auto type_rows = snapshot(types, true);
+    auto site_rows = snapshot(sites, false);
+    uint64_t allocs = 0, frees = 0;
+    for (const Snapshot &row : type_rows) {
+        allocs += row.allocs;
+        frees += row.frees;
+    }
+
+    std::cout.flush();
+    std::cerr << "[EARL alloc-stats] " << allocs << " values allocated, "
+              << allocs-frees << " still live (bytes are the size of the value objects only)" << std::endl;
+    write_table("type", type_rows, type_rows.size());
+    std::cerr << std::endl;
+    write_table("site", site_rows, ALLOC_STATS_SITE_ROWS);
+}
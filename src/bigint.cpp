@@ -0,0 +1,400 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bigint.hpp"
+
+using Mag = std::vector<uint32_t>;
+
+// Below this many limbs in the smaller operand the schoolbook
+// method beats Karatsuba's extra additions and allocations.
+#define KARATSUBA_THRESHOLD 32
+
+static void
+trim(Mag &m) {
+    while (!m.empty() && m.back() == 0)
+        m.pop_back();
+}
+
+static int
+mag_cmp(const Mag &a, const Mag &b) {
+    if (a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;)
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+static Mag
+mag_add(const uint32_t *a, size_t na, const uint32_t *b, size_t nb) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    Mag res(na + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < na; ++i) {
+        uint64_t sum = carry + a[i] + (i < nb ? b[i] : 0);
+        res[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    res[na] = static_cast<uint32_t>(carry);
+    trim(res);
+    return res;
+}
+
+// Requires a >= b.
+static Mag
+mag_sub(const Mag &a, const Mag &b) {
+    Mag res(a.size());
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        int64_t diff = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = diff < 0;
+        res[i] = static_cast<uint32_t>(diff + (borrow << 32));
+    }
+    assert(borrow == 0);
+    trim(res);
+    return res;
+}
+
+// res += x * B^off
+static void
+mag_add_at(Mag &res, const Mag &x, size_t off) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < x.size(); ++i) {
+        uint64_t sum = carry + res[off+i] + x[i];
+        res[off+i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    for (; carry; ++i) {
+        assert(off+i < res.size());
+        uint64_t sum = carry + res[off+i];
+        res[off+i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+}
+
+static Mag
+mag_mul_school(const uint32_t *a, size_t na, const uint32_t *b, size_t nb) {
+    Mag res(na + nb, 0);
+    for (size_t i = 0; i < na; ++i) {
+        uint64_t carry = 0;
+        const uint64_t ai = a[i];
+        for (size_t j = 0; j < nb; ++j) {
+            uint64_t cur = ai * b[j] + res[i+j] + carry;
+            res[i+j] = static_cast<uint32_t>(cur);
+            carry = cur >> 32;
+        }
+        res[i+nb] = static_cast<uint32_t>(carry);
+    }
+    trim(res);
+    return res;
+}
+
+// Karatsuba: with a = a1*B^m + a0 and b = b1*B^m + b0,
+//   a*b = z2*B^2m + ((a0+a1)(b0+b1) - z2 - z0)*B^m + z0
+// which needs three half-size products instead of four.
+static Mag
+mag_mul(const uint32_t *a, size_t na, const uint32_t *b, size_t nb) {
+    while (na > 0 && a[na-1] == 0) --na;
+    while (nb > 0 && b[nb-1] == 0) --nb;
+    if (na == 0 || nb == 0)
+        return {};
+    if (std::min(na, nb) < KARATSUBA_THRESHOLD)
+        return mag_mul_school(a, na, b, nb);
+
+    const size_t m = std::max(na, nb) / 2;
+    const size_t a0n = std::min(na, m), a1n = na > m ? na - m : 0;
+    const size_t b0n = std::min(nb, m), b1n = nb > m ? nb - m : 0;
+
+    Mag z0 = mag_mul(a, a0n, b, b0n);
+    Mag z2 = mag_mul(a + m, a1n, b + m, b1n);
+    Mag sa = mag_add(a, a0n, a + m, a1n);
+    Mag sb = mag_add(b, b0n, b + m, b1n);
+    Mag z1 = mag_mul(sa.data(), sa.size(), sb.data(), sb.size());
+    z1 = mag_sub(mag_sub(z1, z0), z2);
+
+    Mag res(na + nb + 1, 0);
+    mag_add_at(res, z0, 0);
+    mag_add_at(res, z1, m);
+    mag_add_at(res, z2, 2*m);
+    trim(res);
+    return res;
+}
+
+// a = a*mul + add, in place.
+static void
+mag_muladd_small(Mag &a, uint32_t mul, uint32_t add) {
+    uint64_t carry = add;
+    for (auto &limb : a) {
+        uint64_t cur = static_cast<uint64_t>(limb) * mul + carry;
+        limb = static_cast<uint32_t>(cur);
+        carry = cur >> 32;
+    }
+    if (carry)
+        a.push_back(static_cast<uint32_t>(carry));
+}
+
+// a = a / d, in place, returning the remainder.
+static uint32_t
+mag_divmod_small(Mag &a, uint32_t d) {
+    uint64_t rem = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        uint64_t cur = (rem << 32) | a[i];
+        a[i] = static_cast<uint32_t>(cur / d);
+        rem = cur % d;
+    }
+    trim(a);
+    return static_cast<uint32_t>(rem);
+}
+
+static void
+mag_divmod(const Mag &a, const Mag &b, Mag &q, Mag &r) {
+    assert(!b.empty());
+    if (mag_cmp(a, b) < 0) {
+        q.clear();
+        r = a;
+        return;
+    }
+    if (b.size() == 1) {
+        q = a;
+        uint32_t rem = mag_divmod_small(q, b[0]);
+        r = rem ? Mag{rem} : Mag{};
+        return;
+    }
+
+    // Shift-subtract long division, one bit of the quotient at a time.
+    q.assign(a.size(), 0);
+    r.clear();
+    for (size_t i = a.size()*32; i-- > 0;) {
+        uint32_t bit = (a[i/32] >> (i%32)) & 1;
+        uint32_t carry = bit;
+        for (auto &limb : r) {
+            uint32_t next = limb >> 31;
+            limb = (limb << 1) | carry;
+            carry = next;
+        }
+        if (carry)
+            r.push_back(carry);
+        if (mag_cmp(r, b) >= 0) {
+            r = mag_sub(r, b);
+            q[i/32] |= 1u << (i%32);
+        }
+    }
+    trim(q);
+}
+
+static BigInt
+make(bool neg, Mag mag) {
+    BigInt res;
+    trim(mag);
+    res.m_mag = std::move(mag);
+    res.m_neg = neg && !res.m_mag.empty();
+    return res;
+}
+
+BigInt::BigInt(int64_t value) : m_neg(value < 0) {
+    uint64_t u = m_neg ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (u) {
+        m_mag.push_back(static_cast<uint32_t>(u));
+        u >>= 32;
+    }
+}
+
+BigInt
+BigInt::from_str(const std::string &s) {
+    size_t i = 0;
+    bool neg = false;
+    if (!s.empty() && (s[0] == '-' || s[0] == '+')) {
+        neg = s[0] == '-';
+        ++i;
+    }
+    Mag mag;
+    // Consume up to nine digits at a time so each step is one
+    // multiply-add over the limbs.
+    while (i < s.size()) {
+        size_t n = std::min<size_t>(9, s.size() - i);
+        uint32_t chunk = 0, scale = 1;
+        for (size_t j = 0; j < n; ++j) {
+            chunk = chunk*10 + static_cast<uint32_t>(s[i+j] - '0');
+            scale *= 10;
+        }
+        mag_muladd_small(mag, scale, chunk);
+        i += n;
+    }
+    return make(neg, std::move(mag));
+}
+
+bool
+BigInt::fits_i64(void) const {
+    if (m_mag.size() > 2)
+        return false;
+    uint64_t u = 0;
+    for (size_t i = m_mag.size(); i-- > 0;)
+        u = (u << 32) | m_mag[i];
+    return m_neg ? u <= (static_cast<uint64_t>(INT64_MAX) + 1) : u <= static_cast<uint64_t>(INT64_MAX);
+}
+
+int64_t
+BigInt::to_i64(void) const {
+    uint64_t u = 0;
+    for (size_t i = m_mag.size(); i-- > 0;)
+        u = (u << 32) | m_mag[i];
+    return m_neg ? static_cast<int64_t>(0 - u) : static_cast<int64_t>(u);
+}
+
+double
+BigInt::to_double(void) const {
+    double d = 0.0;
+    for (size_t i = m_mag.size(); i-- > 0;)
+        d = d*4294967296.0 + m_mag[i];
+    return m_neg ? -d : d;
+}
+
+std::string
+BigInt::to_string(void) const {
+    if (m_mag.empty())
+        return "0";
+    Mag tmp = m_mag;
+    std::vector<uint32_t> chunks;
+    while (!tmp.empty())
+        chunks.push_back(mag_divmod_small(tmp, 1000000000u));
+
+    std::string res = m_neg ? "-" : "";
+    res += std::to_string(chunks.back());
+    for (size_t i = chunks.size()-1; i-- > 0;) {
+        std::string part = std::to_string(chunks[i]);
+        res += std::string(9 - part.size(), '0') + part;
+    }
+    return res;
+}
+
+size_t
+BigInt::hash(void) const {
+    size_t seed = m_neg;
+    for (auto limb : m_mag)
+        seed ^= std::hash<uint32_t>()(limb) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+bool
+BigInt::is_zero(void) const {
+    return m_mag.empty();
+}
+
+int
+BigInt::cmp(const BigInt &other) const {
+    if (m_neg != other.m_neg)
+        return m_neg ? -1 : 1;
+    int c = mag_cmp(m_mag, other.m_mag);
+    return m_neg ? -c : c;
+}
+
+BigInt
+BigInt::operator-(void) const {
+    return make(!m_neg, m_mag);
+}
+
+BigInt
+BigInt::operator+(const BigInt &other) const {
+    if (m_neg == other.m_neg)
+        return make(m_neg, mag_add(m_mag.data(), m_mag.size(), other.m_mag.data(), other.m_mag.size()));
+    if (mag_cmp(m_mag, other.m_mag) >= 0)
+        return make(m_neg, mag_sub(m_mag, other.m_mag));
+    return make(other.m_neg, mag_sub(other.m_mag, m_mag));
+}
+
+BigInt
+BigInt::operator-(const BigInt &other) const {
+    return *this + (-other);
+}
+
+BigInt
+BigInt::operator*(const BigInt &other) const {
+    return make(m_neg != other.m_neg, mag_mul(m_mag.data(), m_mag.size(), other.m_mag.data(), other.m_mag.size()));
+}
+
+BigInt
+BigInt::operator/(const BigInt &other) const {
+    Mag q, r;
+    mag_divmod(m_mag, other.m_mag, q, r);
+    return make(m_neg != other.m_neg, std::move(q));
+}
+
+BigInt
+BigInt::operator%(const BigInt &other) const {
+    Mag q, r;
+    mag_divmod(m_mag, other.m_mag, q, r);
+    return make(m_neg, std::move(r));
+}
+
+BigInt
+BigInt::operator<<(size_t bits) const {
+    if (m_mag.empty())
+        return *this;
+    const size_t limbs = bits / 32, rem = bits % 32;
+    Mag res(limbs, 0);
+    uint32_t carry = 0;
+    for (auto limb : m_mag) {
+        res.push_back(rem ? (limb << rem) | carry : limb);
+        carry = rem ? limb >> (32 - rem) : 0;
+    }
+    if (carry)
+        res.push_back(carry);
+    return make(m_neg, std::move(res));
+}
+
+BigInt
+BigInt::gcd(const BigInt &a, const BigInt &b) {
+    BigInt x = make(false, a.m_mag), y = make(false, b.m_mag);
+    while (!y.is_zero()) {
+        BigInt r = x % y;
+        x = std::move(y);
+        y = std::move(r);
+    }
+    return x;
+}
+
+BigInt
+BigInt::powmod(const BigInt &base, const BigInt &exp, const BigInt &mod) {
+    BigInt b = base % mod;
+    if (b.m_neg)
+        b = b + mod;
+    BigInt res(1);
+    res = res % mod;
+    for (size_t i = 0; i < exp.m_mag.size()*32; ++i) {
+        if ((exp.m_mag[i/32] >> (i%32)) & 1)
+            res = (res * b) % mod;
+        b = (b * b) % mod;
+    }
+    return res;
+}
@@ -88,30 +88,36 @@ struct etopy {
     }
 };
 
-static const std::unordered_map<std::string, etopy> earl_to_py_equiv = {
-    {"println", etopy("print(~)", {"sep=''"},         {})},
-    {"print", etopy("print(~)", {"sep=''", "end=''"}, {})},
-    {"input", etopy("input(~)", {},                   {})},
-    {"int", etopy("int(~)", {},                       {})},
-    {"float", etopy("float(~)", {},                   {})},
-    {"str", etopy("str(~)", {},                       {})},
-    {"bool", etopy("bool(~)", {},                     {})},
-    {"tuple", etopy("(~,)", {},                       {})},
-    {"list", etopy("[~]", {},                         {})},
-    {"Dict", etopy("dict()", {},                      {})},
-    {"len", etopy("len(~)", {},                       {})},
-    {"some", etopy("~", {},                           {})},
-    {"type", etopy("type(~).__name__", {},            {})},
-    {"typeof", etopy("type(~)", {},                   {})},
-    {"argv", etopy("sys.argv", {},                    "sys")},
-    {"open", etopy("open(~)", {},                     {})},
-    {"unimplemented", etopy("assert False, \"UNIMPLEMENTED: \" + ~", {}, {})},
-    {"sleep", etopy("time.sleep(~*1000)", {},         "time")},
-    {"env", etopy("os.getenv(~)", {},                 "os")},
-    {"datetime", etopy("datetime.datetime.now()", {}, "datetime")},
-    {"assert", etopy("assert(~)", {}, {})},
-    {"panic", etopy("assert False, \"PANIC: \" + ~", {}, {})}
-};
+// Only `--to-py` needs this, so it is built on first use
+// instead of at every startup.
+static const std::unordered_map<std::string, etopy> &
+earl_to_py_equiv(void) {
+    static const std::unordered_map<std::string, etopy> equiv = {
+        {"println", etopy("print(~)", {"sep=''"},         {})},
+        {"print", etopy("print(~)", {"sep=''", "end=''"}, {})},
+        {"input", etopy("input(~)", {},                   {})},
+        {"int", etopy("int(~)", {},                       {})},
+        {"float", etopy("float(~)", {},                   {})},
+        {"str", etopy("str(~)", {},                       {})},
+        {"bool", etopy("bool(~)", {},                     {})},
+        {"tuple", etopy("(~,)", {},                       {})},
+        {"list", etopy("[~]", {},                         {})},
+        {"Dict", etopy("dict()", {},                      {})},
+        {"len", etopy("len(~)", {},                       {})},
+        {"some", etopy("~", {},                           {})},
+        {"type", etopy("type(~).__name__", {},            {})},
+        {"typeof", etopy("type(~)", {},                   {})},
+        {"argv", etopy("sys.argv", {},                    "sys")},
+        {"open", etopy("open(~)", {},                     {})},
+        {"unimplemented", etopy("assert False, \"UNIMPLEMENTED: \" + ~", {}, {})},
+        {"sleep", etopy("time.sleep(~*1000)", {},         "time")},
+        {"env", etopy("os.getenv(~)", {},                 "os")},
+        {"datetime", etopy("datetime.datetime.now()", {}, "datetime")},
+        {"assert", etopy("assert(~)", {}, {})},
+        {"panic", etopy("assert False, \"PANIC: \" + ~", {}, {})}
+    };
+    return equiv;
+}
 
 static void
 add_ctx_py_import(const std::string &py_import, Context &ctx) {
@@ -126,10 +132,10 @@ static std::string
 earl_intrinsic_to_py_intrinsic(const std::string &orig_funccall,
                                const std::string &comma_sep_params_str,
                                Context &ctx) {
-    auto it = earl_to_py_equiv.find(orig_funccall);
+    auto it = earl_to_py_equiv().find(orig_funccall);
 
     // Function was called without checking first.
-    if (it == earl_to_py_equiv.end()) {
+    if (it == earl_to_py_equiv().end()) {
         std::cerr <<
             "EARL intrinsic `"+orig_funccall+"` does not have an equivalent Python intrinsic"
                   << std::endl;
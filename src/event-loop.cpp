@@ -0,0 +1,446 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "event-loop.hpp"
+#include "process.hpp"
+#include "profiler.hpp"
+
+// Every task gets this much address space for its stack. Pages
+// are only backed once they are touched, so this is mostly free.
+#define EVENT_LOOP_STACK_SIZE (8*1024*1024)
+
+// How often children are polled for when pidfd_open(2) is not available.
+#define EVENT_LOOP_REAP_INTERVAL_MS 5
+
+#define EVENT_LOOP_MAX_EVENTS 64
+#define EVENT_LOOP_READ_BUFSZ (64*1024)
+
+using namespace earl::value;
+
+namespace event_loop {
+    struct Coroutine {
+        ucontext_t ctx;
+        void *stack = nullptr;
+        std::function<std::shared_ptr<Obj>(void)> body;
+        std::shared_ptr<Task> task;
+        // The calls running in the task while it is not.
+        std::shared_ptr<profiler::Stack> prof;
+
+        ~Coroutine() {
+            if (stack)
+                munmap(stack, EVENT_LOOP_STACK_SIZE);
+        }
+    };
+
+    struct Timer {
+        uint64_t deadline;
+        uint64_t seq;
+        std::shared_ptr<Task> task;
+
+        bool operator>(const Timer &other) const {
+            return deadline != other.deadline ? deadline > other.deadline : seq > other.seq;
+        }
+    };
+
+    struct Child {
+        pid_t pid;
+        std::function<void(int)> on_exit;
+    };
+
+    static ucontext_t g_main;
+    static std::shared_ptr<Coroutine> g_running = nullptr;
+    static std::deque<std::shared_ptr<Coroutine>> g_ready;
+    static std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> g_timers;
+    static uint64_t g_timer_seq = 0;
+    static int g_epfd = -1;
+    static std::unordered_map<int, std::function<void(void)>> g_watches;
+    static std::unordered_map<int, std::vector<std::shared_ptr<Task>>> g_readers;
+    static std::vector<Child> g_children;
+    static std::vector<std::shared_ptr<Task>> g_failed;
+};
+
+static uint64_t
+now_us(void) {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+static int
+epfd(void) {
+    if (event_loop::g_epfd == -1) {
+        event_loop::g_epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (event_loop::g_epfd == -1)
+            throw std::runtime_error(std::string("could not create the event loop: ")+strerror(errno));
+    }
+    return event_loop::g_epfd;
+}
+
+static bool
+watch(int fd, std::function<void(void)> handler) {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd(), EPOLL_CTL_ADD, fd, &ev) == -1)
+        return false;
+    event_loop::g_watches[fd] = std::move(handler);
+    return true;
+}
+
+static void
+unwatch(int fd) {
+    (void)epoll_ctl(event_loop::g_epfd, EPOLL_CTL_DEL, fd, nullptr);
+    event_loop::g_watches.erase(fd);
+}
+
+static int
+wait_for(pid_t pid) {
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR)
+            return -1;
+    }
+    return status;
+}
+
+static void
+trampoline(void) {
+    auto co = event_loop::g_running.get();
+    try {
+        auto value = co->body();
+        co->body = nullptr;
+        co->task->resolve(value);
+    } catch (...) {
+        co->body = nullptr;
+        event_loop::g_failed.push_back(co->task);
+        co->task->reject(std::current_exception());
+    }
+    // Returning switches back to `g_main` through `uc_link`.
+}
+
+static void
+resume(std::shared_ptr<event_loop::Coroutine> co) {
+    event_loop::g_running = co;
+    profiler::swap_stack(co->prof.get());
+    swapcontext(&event_loop::g_main, &co->ctx);
+    profiler::swap_stack(co->prof.get());
+    event_loop::g_running = nullptr;
+}
+
+static bool
+pending(void) {
+    return !event_loop::g_ready.empty()
+        || !event_loop::g_timers.empty()
+        || !event_loop::g_watches.empty()
+        || !event_loop::g_children.empty();
+}
+
+static void
+fire_timers(void) {
+    uint64_t now = now_us();
+    while (!event_loop::g_timers.empty() && event_loop::g_timers.top().deadline <= now) {
+        auto task = event_loop::g_timers.top().task;
+        event_loop::g_timers.pop();
+        task->resolve(nullptr);
+    }
+}
+
+static void
+reap_children(void) {
+    auto &children = event_loop::g_children;
+    for (size_t i = 0; i < children.size();) {
+        int status;
+        pid_t res = waitpid(children[i].pid, &status, WNOHANG);
+        if (res == 0 || (res == -1 && errno == EINTR)) {
+            ++i;
+            continue;
+        }
+        auto on_exit = std::move(children[i].on_exit);
+        children.erase(children.begin()+i);
+        on_exit(res == -1 ? -1 : status);
+    }
+}
+
+// Run one ready task, or if there are none, block until
+// a timer, file descriptor or child makes progress.
+static void
+run_once(void) {
+    fire_timers();
+    reap_children();
+
+    int timeout = -1;
+    if (!event_loop::g_ready.empty())
+        timeout = 0;
+    else {
+        if (!event_loop::g_timers.empty()) {
+            uint64_t now = now_us(), deadline = event_loop::g_timers.top().deadline;
+            timeout = deadline <= now ? 0 : static_cast<int>((deadline-now+999)/1000);
+        }
+        if (!event_loop::g_children.empty() && (timeout == -1 || timeout > EVENT_LOOP_REAP_INTERVAL_MS))
+            timeout = EVENT_LOOP_REAP_INTERVAL_MS;
+    }
+
+    if (timeout != 0 || !event_loop::g_watches.empty()) {
+        struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+        int n = epoll_wait(epfd(), events, EVENT_LOOP_MAX_EVENTS, timeout);
+        if (n == -1 && errno != EINTR)
+            throw std::runtime_error(std::string("event loop failed: ")+strerror(errno));
+        for (int i = 0; i < n; ++i) {
+            auto it = event_loop::g_watches.find(events[i].data.fd);
+            if (it == event_loop::g_watches.end())
+                continue;
+            // The handler may unwatch itself.
+            auto handler = it->second;
+            handler();
+        }
+        fire_timers();
+    }
+
+    if (!event_loop::g_ready.empty()) {
+        auto co = event_loop::g_ready.front();
+        event_loop::g_ready.pop_front();
+        resume(co);
+    }
+}
+
+std::shared_ptr<Task>
+event_loop::spawn(std::function<std::shared_ptr<Obj>(void)> body) {
+    auto co = std::make_shared<Coroutine>();
+    co->body = std::move(body);
+    co->task = std::make_shared<Task>();
+    co->prof = profiler::new_stack();
+
+    void *stack = mmap(nullptr, EVENT_LOOP_STACK_SIZE, PROT_READ|PROT_WRITE,
+                       MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE|MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED)
+        throw std::runtime_error(std::string("could not allocate a stack for a task: ")+strerror(errno));
+    co->stack = stack;
+
+    // Guard page so that running out of stack faults instead of
+    // silently writing into whatever is mapped below.
+    (void)mprotect(stack, sysconf(_SC_PAGESIZE), PROT_NONE);
+
+    getcontext(&co->ctx);
+    co->ctx.uc_stack.ss_sp = stack;
+    co->ctx.uc_stack.ss_size = EVENT_LOOP_STACK_SIZE;
+    co->ctx.uc_link = &g_main;
+    makecontext(&co->ctx, trampoline, 0);
+
+    g_ready.push_back(co);
+    return co->task;
+}
+
+bool
+event_loop::in_task(void) {
+    return g_running != nullptr;
+}
+
+std::shared_ptr<Obj>
+event_loop::await(std::shared_ptr<Task> task) {
+    if (in_task()) {
+        if (!task->done()) {
+            auto self = g_running;
+            task->on_done([self]() {
+                g_ready.push_back(self);
+            });
+            swapcontext(&self->ctx, &g_main);
+        }
+        return task->result();
+    }
+
+    while (!task->done()) {
+        if (!pending())
+            throw std::runtime_error("awaited task can never finish, nothing is left that could complete it");
+        run_once();
+    }
+    return task->result();
+}
+
+std::shared_ptr<Task>
+event_loop::timer(uint64_t us) {
+    auto task = std::make_shared<Task>();
+    if (us == 0)
+        task->resolve(nullptr);
+    else
+        g_timers.push(Timer{now_us()+us, g_timer_seq++, task});
+    return task;
+}
+
+std::shared_ptr<Task>
+event_loop::readable(int fd) {
+    auto task = std::make_shared<Task>();
+
+    auto it = g_readers.find(fd);
+    if (it != g_readers.end()) {
+        it->second.push_back(task);
+        return task;
+    }
+
+    bool ok = watch(fd, [fd]() {
+        auto readers = std::move(g_readers[fd]);
+        g_readers.erase(fd);
+        unwatch(fd);
+        for (auto &t : readers)
+            t->resolve(nullptr);
+    });
+
+    if (!ok) {
+        // Regular files cannot be polled, but are always readable.
+        if (errno == EPERM) {
+            task->resolve(nullptr);
+            return task;
+        }
+        throw std::runtime_error("cannot wait on file descriptor "+std::to_string(fd)+": "+strerror(errno));
+    }
+
+    g_readers[fd].push_back(task);
+    return task;
+}
+
+std::shared_ptr<Task>
+event_loop::command(const std::string &cmd) {
+    struct Pending {
+        std::shared_ptr<Task> task;
+        std::string out, err;
+        int open = 2;
+        bool exited = false;
+        int status = -1;
+    };
+
+    int out[2], err[2];
+    if (pipe2(out, O_CLOEXEC) == -1)
+        throw std::runtime_error(std::string("could not create a pipe: ")+strerror(errno));
+    if (pipe2(err, O_CLOEXEC) == -1) {
+        close(out[0]);
+        close(out[1]);
+        throw std::runtime_error(std::string("could not create a pipe: ")+strerror(errno));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, out[1], 1);
+    posix_spawn_file_actions_adddup2(&actions, err[1], 2);
+    pid_t pid = process::start(cmd, &actions);
+    posix_spawn_file_actions_destroy(&actions);
+
+    close(out[1]);
+    close(err[1]);
+
+    if (pid == -1) {
+        close(out[0]);
+        close(err[0]);
+        throw std::runtime_error("could not start `"+cmd+"`");
+    }
+
+    auto p = std::make_shared<Pending>();
+    p->task = std::make_shared<Task>();
+
+    auto finish = [p]() {
+        if (p->open != 0 || !p->exited)
+            return;
+        int code = p->status == -1 ? -1
+            : WIFEXITED(p->status) ? WEXITSTATUS(p->status) : 128+WTERMSIG(p->status);
+        std::vector<std::shared_ptr<Obj>> values = {
+            std::make_shared<Int>(code),
+            std::make_shared<Str>(std::move(p->out)),
+            std::make_shared<Str>(std::move(p->err)),
+        };
+        p->task->resolve(std::make_shared<Tuple>(std::move(values)));
+    };
+
+    for (int i = 0; i < 2; ++i) {
+        int fd = i == 0 ? out[0] : err[0];
+        std::string *dst = i == 0 ? &p->out : &p->err;
+        (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL)|O_NONBLOCK);
+        (void)watch(fd, [p, fd, dst, finish]() {
+            static std::vector<char> buf(EVENT_LOOP_READ_BUFSZ);
+            ssize_t n = read(fd, buf.data(), buf.size());
+            if (n > 0) {
+                dst->append(buf.data(), n);
+                return;
+            }
+            if (n == -1 && (errno == EAGAIN || errno == EINTR))
+                return;
+            unwatch(fd);
+            close(fd);
+            --p->open;
+            finish();
+        });
+    }
+
+    auto on_exit = [p, finish](int status) {
+        p->status = status;
+        p->exited = true;
+        finish();
+    };
+
+    int pidfd = -1;
+#ifdef SYS_pidfd_open
+    pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#endif
+    if (pidfd != -1 && fcntl(pidfd, F_SETFD, FD_CLOEXEC) != -1
+        && watch(pidfd, [pid, pidfd, on_exit]() {
+            unwatch(pidfd);
+            close(pidfd);
+            on_exit(wait_for(pid));
+        })) {
+        return p->task;
+    }
+    if (pidfd != -1)
+        close(pidfd);
+
+    g_children.push_back(Child{pid, on_exit});
+    return p->task;
+}
+
+void
+event_loop::drain(void) {
+    while (pending())
+        run_once();
+
+    auto failed = std::move(g_failed);
+    g_failed.clear();
+    for (auto &task : failed) {
+        if (task->unobserved_error())
+            (void)task->result();
+    }
+}
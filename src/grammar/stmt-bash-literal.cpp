@@ -27,8 +27,8 @@
 
 #include "ast.hpp"
 
-StmtBashLiteral::StmtBashLiteral(std::unique_ptr<Expr> expr)
-    : m_expr(std::move(expr)) {}
+StmtBashLiteral::StmtBashLiteral(std::unique_ptr<Expr> expr, std::shared_ptr<Token> tok)
+    : m_expr(std::move(expr)), m_tok(tok) {}
 
 StmtType StmtBashLiteral::stmt_type() const {
     return StmtType::Bash_Literal;
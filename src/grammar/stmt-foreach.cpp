@@ -30,11 +30,13 @@
 StmtForeach::StmtForeach(std::vector<std::shared_ptr<Token>> enumerators,
                          std::unique_ptr<Expr> expr,
                          std::unique_ptr<StmtBlock> block,
-                         uint32_t attrs)
+                         uint32_t attrs,
+                         bool bash_lines)
     : m_enumerators(enumerators),
       m_expr(std::move(expr)),
       m_block(std::move(block)),
-      m_attrs(attrs) {}
+      m_attrs(attrs),
+      m_bash_lines(bash_lines) {}
 
 StmtType
 StmtForeach::stmt_type() const {
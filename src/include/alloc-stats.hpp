@@ -0,0 +1,152 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: alloc-stats.hpp
+// Description:
+//   Allocation counters for `earl::value` objects. They are only built
+//   in with `-DALLOC_STATS=ON`, which gives every value a `Counted`
+//   member, and only count once `--alloc-stats` turns them on.
+//
+//   Every allocation and free is counted per value type and per
+//   allocation site. The site is the kind of AST node that the
+//   evaluator was in when the value was made.
+
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "ast.hpp"
+
+#ifdef EARL_ALLOC_STATS
+/// @brief Declares the counter of a value, must be the last member
+///        so that `type()` can be called while it is initialised
+#define ALLOC_STATS_MEMBER alloc_stats::Counted __m_alloc_stats{static_cast<int>(this->type()), sizeof(*this)}
+/// @brief Attributes the allocations in the enclosing scope to `site`
+#define ALLOC_STATS_SITE(site) alloc_stats::Site __alloc_stats_site(site)
+#else
+#define ALLOC_STATS_MEMBER
+#define ALLOC_STATS_SITE(site)
+#endif
+
+namespace earl { namespace value { struct Obj; }; };
+
+namespace alloc_stats {
+    /// @brief Whether the counters were built in
+    constexpr bool compiled =
+#ifdef EARL_ALLOC_STATS
+        true;
+#else
+        false;
+#endif
+
+    /// @brief Whether allocations are being counted
+    extern bool active;
+
+    /// @brief The site that allocations are attributed to
+    extern uint8_t site;
+
+    /// @brief Start counting
+    /// @param report Write a report to stderr when the program exits
+    /// @return False if the counters were not built in
+    bool enable(bool report=true);
+
+    /// @brief The site of a statement
+    uint8_t stmt_site(StmtType type);
+
+    /// @brief The site of a binary or unary expression
+    uint8_t expr_site(ExprType type);
+
+    /// @brief The site of a term
+    uint8_t term_site(ExprTermType type);
+
+    void on_alloc(int type, uint8_t site, size_t size);
+    void on_free(int type, uint8_t site, size_t size);
+
+    /// @brief The counters as a dictionary of `types` and `sites`, each
+    ///        a dictionary of names to `allocs`, `frees`, `live`,
+    ///        `bytes` and `live_bytes`
+    std::shared_ptr<earl::value::Obj> to_dict(void);
+
+    /// @brief Write the counters to stderr
+    void report(void);
+
+    /// @brief The counters of one value type
+    struct TypeTotals {
+        std::string name;
+        uint64_t allocs;
+        uint64_t frees;
+        uint64_t bytes;
+        uint64_t freed_bytes;
+    };
+
+    /// @brief The counters of every type that was allocated
+    std::vector<TypeTotals> type_totals(void);
+
+    /// @brief Counts the value that it is a member of. Values that
+    ///        were made while counting was off are never counted.
+    struct Counted {
+        Counted(int type, size_t size)
+            : m_type(static_cast<uint8_t>(type)), m_site(site), m_counted(active), m_size(static_cast<uint32_t>(size)) {
+            if (m_counted)
+                on_alloc(m_type, m_site, m_size);
+        }
+
+        /// @brief A copied value is a new allocation of the same type
+        Counted(const Counted &other)
+            : Counted(other.m_type, other.m_size) {}
+
+        Counted &operator=(const Counted &) { return *this; }
+
+        ~Counted() {
+            if (m_counted)
+                on_free(m_type, m_site, m_size);
+        }
+
+    private:
+        uint8_t m_type;
+        uint8_t m_site;
+        bool m_counted;
+        uint32_t m_size;
+    };
+
+    /// @brief Sets the allocation site for as long as it is alive
+    struct Site {
+        Site(uint8_t s) : m_prev(site) { site = s; }
+        ~Site() { site = m_prev; }
+
+        Site(const Site &) = delete;
+        Site &operator=(const Site &) = delete;
+
+    private:
+        uint8_t m_prev;
+    };
+};
+
+#endif // ALLOC_STATS_H
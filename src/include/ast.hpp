@@ -365,6 +365,10 @@ struct Stmt {
     virtual StmtType stmt_type() const = 0;
 
     bool m_evald = false;
+
+    /// @brief The line profiler's id for the line the statement
+    ///        starts on, only set when it was on during parsing
+    uint32_t m_line = UINT32_MAX;
 };
 
 struct StmtInfo : public Stmt {
@@ -385,7 +389,8 @@ struct StmtTry : public Stmt {
 
 struct StmtBashLiteral : public Stmt {
     std::unique_ptr<Expr> m_expr;
-    StmtBashLiteral(std::unique_ptr<Expr> expr);
+    std::shared_ptr<Token> m_tok;
+    StmtBashLiteral(std::unique_ptr<Expr> expr, std::shared_ptr<Token> tok);
     StmtType stmt_type() const override;
 };
 
@@ -579,10 +584,15 @@ struct StmtForeach : public Stmt {
 
     uint32_t m_attrs;
 
+    /// @brief Set for `foreach line in $"cmd" |> lines`, in
+    ///        which case `m_expr` is the command to run
+    bool m_bash_lines;
+
     StmtForeach(std::vector<std::shared_ptr<Token>> enumerators,
                 std::unique_ptr<Expr> expr,
                 std::unique_ptr<StmtBlock> block,
-                uint32_t attrs);
+                uint32_t attrs,
+                bool bash_lines = false);
 
     StmtType stmt_type() const override;
 };
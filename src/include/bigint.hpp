@@ -0,0 +1,90 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * Provides an arbitrary precision signed integer. EARL
+ * integers are 64 bits and only fall back to this type
+ * when an operation overflows, see primitives/int.cpp.
+ */
+
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief A sign-magnitude integer of unbounded size. The
+///        magnitude is stored as base 2^32 limbs, least
+///        significant first, with no leading zero limbs.
+struct BigInt {
+    explicit BigInt(int64_t value = 0);
+
+    /// @brief Parse a base 10 integer with an optional leading `-`
+    /// @note It is expected that `s` is a valid integer literal
+    static BigInt from_str(const std::string &s);
+
+    /// @brief Check if the value fits in an int64_t
+    bool fits_i64(void) const;
+
+    /// @note It is expected to call `fits_i64` before calling this function
+    int64_t to_i64(void) const;
+    double to_double(void) const;
+    std::string to_string(void) const;
+    size_t hash(void) const;
+    bool is_zero(void) const;
+
+    /// @brief Compare with `other`
+    /// @return <0 if less than, 0 if equal, >0 if greater than
+    int cmp(const BigInt &other) const;
+
+    BigInt operator-(void) const;
+    BigInt operator+(const BigInt &other) const;
+    BigInt operator-(const BigInt &other) const;
+
+    /// @brief Multiply, using Karatsuba once both operands are large
+    BigInt operator*(const BigInt &other) const;
+
+    /// @brief Truncating division (rounds toward zero like C)
+    /// @note It is expected that `other` is not zero
+    BigInt operator/(const BigInt &other) const;
+
+    /// @brief Remainder with the sign of the dividend (like C)
+    /// @note It is expected that `other` is not zero
+    BigInt operator%(const BigInt &other) const;
+    BigInt operator<<(size_t bits) const;
+
+    /// @brief Greatest common divisor, always non-negative
+    static BigInt gcd(const BigInt &a, const BigInt &b);
+
+    /// @brief Compute (base ** exp) mod `mod` by squaring
+    /// @note It is expected that `exp` >= 0 and `mod` > 0
+    static BigInt powmod(const BigInt &base, const BigInt &exp, const BigInt &mod);
+
+    bool m_neg;
+    std::vector<uint32_t> m_mag;
+};
+
+#endif // BIGINT_H
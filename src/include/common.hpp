@@ -131,6 +131,16 @@ extern std::string repl_welcome_msg;
 #define COMMON_EARL2ARG_REPL_WELCOME             "repl-welcome"
 #define COMMON_EARL2ARG_TIME                     "time"
 #define COMMON_EARL2ARG_CLEAR_MEM_FILE           "clear-mem"
+#define COMMON_EARL2ARG_STDOUT_BUFFER            "stdout-buffer"
+#define COMMON_EARL2ARG_PROFILE                  "profile"
+#define COMMON_EARL2ARG_SAMPLE_PROFILE           "sample-profile"
+#define COMMON_EARL2ARG_LINE_PROFILE             "line-profile"
+#define COMMON_EARL2ARG_COVERAGE                 "coverage"
+#define COMMON_EARL2ARG_ALLOC_STATS              "alloc-stats"
+#define COMMON_EARL2ARG_TRACE                    "trace"
+#define COMMON_EARL2ARG_METRICS                  "metrics"
+#define COMMON_EARL2ARG_SHELL_STATS              "shell-stats"
+#define COMMON_EARL2ARG_SLOW_BASH                "slow-bash"
 
 #define COMMON_EARL2ARG_ASCPL {                         \
         COMMON_EARL2ARG_HELP,                           \
@@ -158,8 +168,18 @@ extern std::string repl_welcome_msg;
             COMMON_EARL2ARG_ONE_SHOT,                   \
             COMMON_EARL2ARG_PORTABLE,                   \
             COMMON_EARL2ARG_REPL_WELCOME,               \
-            COMMON_EARL2ARG_TIME                        \
-            COMMON_EARL2ARG_CLEAR_MEM_FILE              \
+            COMMON_EARL2ARG_TIME,                       \
+            COMMON_EARL2ARG_CLEAR_MEM_FILE,             \
+            COMMON_EARL2ARG_STDOUT_BUFFER,              \
+            COMMON_EARL2ARG_PROFILE,                    \
+            COMMON_EARL2ARG_SAMPLE_PROFILE,             \
+            COMMON_EARL2ARG_LINE_PROFILE,               \
+            COMMON_EARL2ARG_COVERAGE,                   \
+            COMMON_EARL2ARG_ALLOC_STATS,                \
+            COMMON_EARL2ARG_TRACE,                      \
+            COMMON_EARL2ARG_METRICS,                    \
+            COMMON_EARL2ARG_SHELL_STATS,                \
+            COMMON_EARL2ARG_SLOW_BASH                   \
             }
 
 #define COMMON_EARL1ARG_HELP               'h'
@@ -198,13 +218,15 @@ void handle_1flag(char flag, bool set);
 #define COMMON_EARLATTR_REF          "ref"
 #define COMMON_EARLATTR_CONST        "const"
 #define COMMON_EARLATTR_EXPERIMENTAL "experimental"
+#define COMMON_EARLATTR_ASYNC        "async"
 
 #define COMMON_EARLATTR_ASCPL {                 \
         COMMON_EARLATTR_WORLD,                  \
             COMMON_EARLATTR_PUB,                \
             COMMON_EARLATTR_REF,                \
             COMMON_EARLATTR_CONST,              \
-            COMMON_EARLATTR_EXPERIMENTAL        \
+            COMMON_EARLATTR_EXPERIMENTAL,       \
+            COMMON_EARLATTR_ASYNC               \
             }
 
 #define COMMON_EARL_REPL_THEME_DEFAULT       "default"
@@ -229,6 +251,7 @@ enum class Attr {
     Ref = 1 << 2,
     Const = 1 << 3,
     Experimental = 1 << 4,
+    Async = 1 << 5,
 };
 
 // Keywords
@@ -313,6 +336,7 @@ enum class Attr {
 #define COMMON_EARLTY_CLOSURE "closure"
 #define COMMON_EARLTY_OPTION  "option"
 #define COMMON_EARLTY_SLICE   "slice"
+#define COMMON_EARLTY_BYTES   "bytes"
 #define COMMON_EARLTY_DICT    "dictionary"
 #define COMMON_EARLTY_TYPE    "type"
 #define COMMON_EARLTY_REAL    "real"
@@ -331,6 +355,7 @@ enum class Attr {
             COMMON_EARLTY_CLOSURE,              \
             COMMON_EARLTY_OPTION,               \
             COMMON_EARLTY_SLICE,                \
+            COMMON_EARLTY_BYTES,                \
             COMMON_EARLTY_DICT,                 \
             COMMON_EARLTY_TYPE,                 \
             COMMON_EARLTY_REAL,                 \
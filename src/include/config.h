@@ -0,0 +1,7 @@
+#pragma once
+
+#define PREFIX "/usr/local"
+#define VERSION "0.9.7"
+#define COMPILER_INFO "GNU 12.2.0"
+
+
@@ -27,13 +27,28 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <ctime>
+#include <exception>
+#include <functional>
 
 #include "ast.hpp"
 #include "token.hpp"
+#include "bigint.hpp"
+#include "alloc-stats.hpp"
+
+namespace earl { namespace value { struct DictKey; } }
+
+namespace std {
+    /// @brief Dictionary keys carry their own (cached) hash
+    template <>
+    struct hash<earl::value::DictKey> {
+        size_t operator()(const earl::value::DictKey &key) const;
+    };
+}
 
 /// \brief Make sure that both obj0 and obj1 are compatible with
 /// all binary opterations.
@@ -179,6 +194,30 @@ namespace earl {
 
             /** EARL class reference type */
             ClassRef,
+
+            /** EARL hashed set type */
+            Set,
+
+            /** EARL double-ended queue type */
+            Deque,
+
+            /** EARL priority queue (binary heap) type */
+            PriorityQueue,
+
+            /** EARL dense matrix of doubles */
+            Matrix,
+
+            /** EARL dictionary type keyed by any hashable value */
+            DictAny,
+
+            /** EARL pool of concurrently running shell commands */
+            ProcPool,
+
+            /** EARL handle to the result of an @async function or event */
+            Task,
+
+            /** EARL buffer of raw bytes */
+            Bytes,
         };
 
         struct Obj;
@@ -186,11 +225,36 @@ namespace earl {
 
         using ListIterator      = std::vector<std::shared_ptr<Obj>>::iterator;
         using StrIterator       = std::vector<std::shared_ptr<Char>>::iterator;
-        using DictIntIterator   = std::unordered_map<int, std::shared_ptr<Obj>>::iterator;
+        using DictIntIterator   = std::unordered_map<int64_t, std::shared_ptr<Obj>>::iterator;
         using DictCharIterator  = std::unordered_map<char, std::shared_ptr<Obj>>::iterator;
         using DictFloatIterator = std::unordered_map<double, std::shared_ptr<Obj>>::iterator;
         using DictStrIterator   = std::unordered_map<std::string, std::shared_ptr<Obj>>::iterator;
-        using Iterator          = std::variant<ListIterator, StrIterator, DictIntIterator, DictCharIterator, DictFloatIterator, DictStrIterator>;
+
+        /// @brief Hashes value objects for hashed containers
+        struct ObjHash {
+            size_t operator()(const std::shared_ptr<Obj> &obj) const;
+        };
+
+        /// @brief Compares value objects for hashed containers
+        struct ObjEq {
+            bool operator()(const std::shared_ptr<Obj> &obj1, const std::shared_ptr<Obj> &obj2) const;
+        };
+
+        /// @brief A key of a `DictAny` dictionary. The hash is computed
+        ///        once on construction so that rehashing the table and
+        ///        probing collisions never re-walk composite keys.
+        struct DictKey {
+            DictKey(std::shared_ptr<Obj> value);
+
+            bool operator==(const DictKey &other) const;
+
+            std::shared_ptr<Obj> value;
+            size_t hash;
+        };
+
+        using SetIterator       = std::unordered_set<std::shared_ptr<Obj>, ObjHash, ObjEq>::iterator;
+        using DictAnyIterator   = std::unordered_map<DictKey, std::shared_ptr<Obj>>::iterator;
+        using Iterator          = std::variant<ListIterator, StrIterator, DictIntIterator, DictCharIterator, DictFloatIterator, DictStrIterator, SetIterator, DictAnyIterator>;
 
         /// @brief The base abstract class that all
         ///        EARL value objects inherit from
@@ -251,6 +315,17 @@ namespace earl {
             /// @return true on equal, false otherwise
             virtual bool eq(Obj *other);
 
+            /// @brief Check if this value can be hashed i.e., used
+            ///        as an element of a set
+            /// @return True if hashable, false if otherwise
+            virtual bool is_hashable(void) const;
+
+            /// @brief Hash the underlying value. Values that are `eq`
+            ///        must produce the same hash.
+            /// @note It is expected to call `is_hashable` before calling this function
+            /// @return The hash of the value
+            virtual size_t hash(void);
+
             /// @brief Convert the value of an object to a cxx std::string
             /// @return The stringified version of the value
             virtual std::string to_cxxstring(void);
@@ -365,6 +440,8 @@ namespace earl {
         private:
             /// @brief The actual EARL function
             std::shared_ptr<earl::function::Obj> m_fun;
+
+            ALLOC_STATS_MEMBER;
         };
 
         /// @brief The class reference value object. It is created
@@ -387,6 +464,8 @@ namespace earl {
 
         private:
             StmtClass *m_stmt;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct TypeKW : public Obj {
@@ -405,19 +484,35 @@ namespace earl {
 
         private:
             Type m_ty;
+
+            ALLOC_STATS_MEMBER;
         };
 
         /// @brief The structure that represents EARL 32bit integers
         struct Int : public Obj {
-            Int(int value = 0);
+            Int(int64_t value = 0);
+
+            /// @brief Create an integer from an arbitrary precision
+            ///        value. It is stored as a plain 64 bit integer
+            ///        if it fits.
+            Int(const BigInt &value);
 
             /// @brief Fill the underlying data with some data
             /// @param value The value to use to fill
-            void fill(int value);
+            void fill(int64_t value);
 
             /// @brief Get the underlying integer value
-            /// @return a copy of m_value
-            int value(void);
+            /// @return a copy of m_value (saturated if this is a big integer)
+            int64_t value(void);
+
+            /// @brief Check if the value has outgrown 64 bits
+            bool is_big(void) const;
+
+            /// @brief Get the value as an arbitrary precision integer
+            BigInt as_big(void) const;
+
+            /// @brief Get the value as a double (big integers included)
+            double as_double(void) const;
 
             /// @brief Increment m_value by 1
             void incr(void);
@@ -429,6 +524,8 @@ namespace earl {
             void mutate(Obj *other, StmtMut *stmt)                                        override;
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
             std::string to_cxxstring(void)                                                override;
             void spec_mutate(Token *op, Obj *other, StmtMut *stmt)                        override;
             std::shared_ptr<Obj> unaryop(Token *op)                                       override;
@@ -445,7 +542,12 @@ namespace earl {
             std::shared_ptr<Obj> bitshift(Token *op, Obj *other)                          override;
 
         private:
-            int m_value;
+            int64_t m_value;
+
+            // Only set once arithmetic overflows 64 bits.
+            std::shared_ptr<BigInt> m_big;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Float : public Obj {
@@ -465,6 +567,8 @@ namespace earl {
             void mutate(Obj *other, StmtMut *stmt)                                        override;
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
             std::string to_cxxstring(void)                                                override;
             void spec_mutate(Token *op, Obj *other, StmtMut *stmt)                        override;
             std::shared_ptr<Obj> unaryop(Token *op)                                       override;
@@ -479,6 +583,8 @@ namespace earl {
 
         private:
             double m_value;
+
+            ALLOC_STATS_MEMBER;
         };
 
         /// @brief The structure that represents EARL 32bit integers
@@ -496,12 +602,16 @@ namespace earl {
             void mutate(Obj *other, StmtMut *stmt)                                        override;
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
             std::string to_cxxstring(void)                                                override;
             std::shared_ptr<Obj> unaryop(Token *op)                                       override;
             std::shared_ptr<Obj> equality(Token *op, Obj *other)                          override;
 
         private:
             bool m_value;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Char : public Obj {
@@ -521,12 +631,16 @@ namespace earl {
             void mutate(Obj *other, StmtMut *stmt)                                        override;
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
             std::string to_cxxstring(void)                                                override;
             std::shared_ptr<Obj> equality(Token *op, Obj *other)                          override;
             std::shared_ptr<Obj> add(Token *op, Obj *other)                               override;
 
         private:
             char m_value;
+
+            ALLOC_STATS_MEMBER;
         };
 
         /// @brief The structure that represents EARL UNITs
@@ -540,6 +654,8 @@ namespace earl {
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
             std::string to_cxxstring(void)                                                override;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Closure : public Obj {
@@ -564,6 +680,8 @@ namespace earl {
             ExprClosure *m_expr_closure;
             std::vector<std::pair<Token *, uint32_t>> m_params;
             std::shared_ptr<Ctx> m_owner;
+
+            ALLOC_STATS_MEMBER;
         };
 
         /// @brief The structure that represents EARL lists.
@@ -621,6 +739,8 @@ namespace earl {
 
         private:
             std::vector<std::shared_ptr<Obj>> m_value;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Slice : public Obj {
@@ -639,6 +759,8 @@ namespace earl {
         private:
             std::shared_ptr<Obj> m_start;
             std::shared_ptr<Obj> m_end;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Tuple : public Obj {
@@ -659,6 +781,8 @@ namespace earl {
             bool boolean(void)                                                            override;
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
             std::string to_cxxstring(void)                                                override;
             Iterator iter_begin(void)                                                     override;
             Iterator iter_end(void)                                                       override;
@@ -668,6 +792,8 @@ namespace earl {
 
         private:
             std::vector<std::shared_ptr<Obj>> m_values;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Time : public Obj {
@@ -695,6 +821,8 @@ namespace earl {
 
         private:
             std::time_t m_now;
+
+            ALLOC_STATS_MEMBER;
         };
 
         /// @brief The structure that represents EARL strings
@@ -721,7 +849,7 @@ namespace earl {
             std::shared_ptr<Bool> contains(Char *value);
             void update_changed(void);
             std::shared_ptr<earl::value::Str> trim(Expr *expr);
-            void remove_char(int idx, Expr *expr);
+            void remove_char(int64_t idx, Expr *expr);
             std::shared_ptr<Bool> startswith(const Str *const str) const;
             std::shared_ptr<Bool> endswith(const Str *const str) const;
 
@@ -732,6 +860,8 @@ namespace earl {
             void mutate(Obj *other, StmtMut *stmt)                                        override;
             std::shared_ptr<Obj> copy(void)                                               override;
             bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
             std::string to_cxxstring(void)                                                override;
             void spec_mutate(Token *op, Obj *other, StmtMut *stmt)                        override;
             Iterator iter_begin(void)                                                     override;
@@ -744,6 +874,8 @@ namespace earl {
             std::string m_value;
             std::vector<std::shared_ptr<Char>> m_chars;
             std::vector<unsigned> m_changed;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Module : public Obj {
@@ -757,6 +889,8 @@ namespace earl {
 
         private:
             std::shared_ptr<Ctx> m_value;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Class : public Obj {
@@ -790,6 +924,8 @@ namespace earl {
             std::vector<std::shared_ptr<variable::Obj>> m_members;
             std::vector<std::shared_ptr<function::Obj>> m_methods;
             std::vector<Token *> m_member_assignees;
+
+            ALLOC_STATS_MEMBER;
         };
 
         template <typename T>
@@ -817,6 +953,266 @@ namespace earl {
         private:
             std::unordered_map<T, std::shared_ptr<Obj>> m_map;
             Type m_kty;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL sets. Any
+        ///        hashable value can be an element and values of
+        ///        different types may be mixed.
+        struct Set : public Obj {
+            Set(void);
+
+            std::unordered_set<std::shared_ptr<Obj>, ObjHash, ObjEq> &extract(void);
+
+            /// @brief Insert a copy of `value` into the set
+            /// @param value The value to insert (must be hashable)
+            /// @param expr Used for error reporting
+            void insert(std::shared_ptr<Obj> value, Expr *expr);
+
+            /// @brief Remove `value` from the set
+            /// @return True if the value was in the set, false if otherwise
+            bool remove(const std::shared_ptr<Obj> &value);
+            std::shared_ptr<Bool> contains(const std::shared_ptr<Obj> &value);
+            std::shared_ptr<Set> set_union(Set *other);
+            std::shared_ptr<Set> intersection(Set *other);
+            std::shared_ptr<Set> difference(Set *other);
+            size_t size(void) const;
+            bool empty(void) const;
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(Obj *other)                                                           override;
+            std::string to_cxxstring(void)                                                override;
+            Iterator iter_begin(void)                                                     override;
+            Iterator iter_end(void)                                                       override;
+            void iter_next(Iterator &it)                                                  override;
+            std::shared_ptr<Obj> equality(Token *op, Obj *other)                          override;
+
+        private:
+            std::unordered_set<std::shared_ptr<Obj>, ObjHash, ObjEq> m_set;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL double-ended
+        ///        queues. Elements are kept in a ring buffer so that
+        ///        pushing and popping at either end is O(1).
+        struct Deque : public Obj {
+            Deque(std::vector<std::shared_ptr<Obj>> values = {});
+
+            void push_back(std::shared_ptr<Obj> value);
+            void push_front(std::shared_ptr<Obj> value);
+            std::shared_ptr<Obj> pop_back(Expr *expr);
+            std::shared_ptr<Obj> pop_front(Expr *expr);
+            std::shared_ptr<Obj> front(Expr *expr);
+            std::shared_ptr<Obj> back(Expr *expr);
+
+            /// @brief Get the `idx`th element counting from the front
+            std::shared_ptr<Obj> &at(size_t idx);
+            size_t size(void) const;
+            bool empty(void) const;
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(Obj *other)                                                           override;
+            std::string to_cxxstring(void)                                                override;
+
+        private:
+            /// @brief Double the capacity of the ring buffer and
+            ///        move the elements so that m_head is 0
+            void grow(void);
+
+            /// @brief Ring buffer, its size is always a power of 2
+            std::vector<std::shared_ptr<Obj>> m_buf;
+            size_t m_head;
+            size_t m_size;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL priority queues.
+        ///        It is a binary heap where `pop` yields the smallest
+        ///        value, or the value that should come first according
+        ///        to an optional comparator closure `|a, b| -> bool`.
+        struct PriorityQueue : public Obj {
+            PriorityQueue(std::shared_ptr<Closure> cmp = nullptr);
+
+            void push(std::shared_ptr<Obj> value, std::shared_ptr<Ctx> &ctx, Expr *expr);
+            std::shared_ptr<Obj> pop(std::shared_ptr<Ctx> &ctx, Expr *expr);
+            std::shared_ptr<Obj> top(Expr *expr);
+            size_t size(void) const;
+            bool empty(void) const;
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            std::string to_cxxstring(void)                                                override;
+
+        private:
+            /// @brief Check if `obj1` should be popped before `obj2`
+            bool before(const std::shared_ptr<Obj> &obj1,
+                        const std::shared_ptr<Obj> &obj2,
+                        std::shared_ptr<Ctx> &ctx,
+                        Expr *expr);
+            void sift_up(size_t idx, std::shared_ptr<Ctx> &ctx, Expr *expr);
+            void sift_down(size_t idx, std::shared_ptr<Ctx> &ctx, Expr *expr);
+
+            std::vector<std::shared_ptr<Obj>> m_heap;
+            std::shared_ptr<Closure> m_cmp;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL matrices. The
+        ///        elements are stored as contiguous doubles in
+        ///        row-major order.
+        struct Matrix : public Obj {
+            Matrix(size_t rows, size_t cols, std::vector<double> data = {});
+
+            size_t rows(void) const;
+            size_t cols(void) const;
+            std::vector<double> &data(void);
+
+            /// @brief Get the element at [i][j]
+            /// @param expr Used for error reporting
+            std::shared_ptr<Float> at(Obj *i, Obj *j, Expr *expr);
+
+            /// @brief Set the element at [i][j] to `value`
+            /// @param expr Used for error reporting
+            void set(Obj *i, Obj *j, Obj *value, Expr *expr);
+            std::shared_ptr<Matrix> transpose(void);
+
+            /// @brief Matrix multiplication (THIS x other)
+            /// @param other The right-hand-side matrix
+            /// @param nthreads The number of threads to split the rows
+            ///                 across, 0 lets the size of the product decide
+            /// @param expr Used for error reporting
+            std::shared_ptr<Matrix> matmul(Matrix *other, size_t nthreads, Expr *expr);
+            std::shared_ptr<List> to_list(void);
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(Obj *other)                                                           override;
+            std::string to_cxxstring(void)                                                override;
+            std::shared_ptr<Obj> add(Token *op, Obj *other)                               override;
+            std::shared_ptr<Obj> sub(Token *op, Obj *other)                               override;
+            std::shared_ptr<Obj> multiply(Token *op, Obj *other)                          override;
+            std::shared_ptr<Obj> divide(Token *op, Obj *other)                            override;
+            std::shared_ptr<Obj> equality(Token *op, Obj *other)                          override;
+
+        private:
+            /// @brief Apply `f` elementwise with either another matrix
+            ///        of the same shape or a scalar int/float
+            template <typename F>
+            std::shared_ptr<Obj> elementwise(Token *op, Obj *other, F f);
+
+            size_t m_rows;
+            size_t m_cols;
+            std::vector<double> m_data;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL process pools.
+        ///        Commands are started like inline BASH, at most `limit`
+        ///        at a time, and their stdout, stderr and exit code
+        ///        are collected. Copies share the same pool.
+        struct ProcPool : public Obj {
+            ProcPool(size_t limit);
+
+            /// @brief Queue `cmd`, starting it right away if fewer
+            ///        than `limit` commands are running
+            /// @param expr Used for error reporting
+            /// @return The handle to pass to `wait`
+            size_t spawn(const std::string &cmd, Expr *expr);
+
+            /// @brief Block until the command of `handle` finishes
+            /// @param expr Used for error reporting
+            /// @return (exit code, stdout, stderr)
+            std::shared_ptr<Tuple> wait(Obj *handle, Expr *expr);
+
+            /// @brief Block until any outstanding command finishes
+            /// @param expr Used for error reporting
+            /// @return (handle, exit code, stdout, stderr)
+            std::shared_ptr<Tuple> wait_any(Expr *expr);
+
+            /// @brief Block until every outstanding command finishes
+            /// @param expr Used for error reporting
+            /// @return A list of (exit code, stdout, stderr) in the
+            ///         order the commands were spawned
+            std::shared_ptr<List> wait_all(Expr *expr);
+
+            /// @brief The number of commands not yet waited on
+            size_t pending(void) const;
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            std::string to_cxxstring(void)                                                override;
+
+        private:
+            struct State;
+            std::shared_ptr<State> m_state;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL tasks. A task is
+        ///        the eventual result of an @async function call, a
+        ///        timer, an fd becoming readable or a command. Copies
+        ///        share the same result.
+        struct Task : public Obj {
+            Task();
+
+            bool done(void) const;
+
+            /// @brief Finish the task with `value` and run the `on_done` callbacks
+            void resolve(std::shared_ptr<Obj> value);
+
+            /// @brief Finish the task with an error that `result` rethrows
+            void reject(std::exception_ptr error);
+
+            /// @brief Run `f` once the task is done (now, if it already is)
+            void on_done(std::function<void(void)> f);
+
+            /// @brief Get the value of a finished task, rethrowing its error
+            std::shared_ptr<Obj> result(void);
+
+            /// @brief Check if the task failed and nobody asked for its result
+            bool unobserved_error(void) const;
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            std::string to_cxxstring(void)                                                override;
+
+        private:
+            struct State {
+                bool done = false;
+                bool observed = false;
+                std::shared_ptr<Obj> value = nullptr;
+                std::exception_ptr error = nullptr;
+                std::vector<std::function<void(void)>> on_done;
+            };
+            std::shared_ptr<State> m_state;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Enum : public Obj {
@@ -844,6 +1240,55 @@ namespace earl {
             Token *m_id;
             uint32_t m_attrs;
             std::vector<std::string> m_info;
+
+            ALLOC_STATS_MEMBER;
+        };
+
+        /// @brief The structure that represents EARL bytes. The buffer
+        ///        is never changed once made, so slices and copies only
+        ///        point into it instead of copying it.
+        struct Bytes : public Obj {
+            Bytes(std::vector<uint8_t> data = {});
+            Bytes(std::shared_ptr<const std::vector<uint8_t>> buf, size_t offset, size_t len);
+
+            const uint8_t *data(void) const;
+            size_t size(void) const;
+            std::shared_ptr<Obj> nth(Obj *idx, Expr *expr);
+
+            /// @brief View of the bytes in [start, end), sharing the buffer
+            std::shared_ptr<Bytes> slice(Obj *start, Obj *end, Expr *expr);
+
+            /// @brief Find `needle` at or after `start`
+            /// @return The offset of the first match, or -1 if there is none
+            int64_t find(const uint8_t *needle, size_t len, size_t start) const;
+
+            /// @brief Lowercase hexadecimal, two digits per byte
+            std::string hex(void) const;
+
+            /// @brief Decode the unsigned `width` byte integer at `offset`
+            uint64_t decode_uint(size_t offset, size_t width, bool big_endian) const;
+
+            /// @brief The CRC-32 (IEEE 802.3) checksum of the bytes
+            uint32_t crc32(void) const;
+
+            // Implements
+            Type type(void) const                                                         override;
+            bool boolean(void)                                                            override;
+            void mutate(Obj *other, StmtMut *stmt)                                        override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(Obj *other)                                                           override;
+            bool is_hashable(void) const                                                  override;
+            size_t hash(void)                                                             override;
+            std::string to_cxxstring(void)                                                override;
+            std::shared_ptr<Obj> add(Token *op, Obj *other)                               override;
+            std::shared_ptr<Obj> equality(Token *op, Obj *other)                          override;
+
+        private:
+            std::shared_ptr<const std::vector<uint8_t>> m_buf;
+            size_t m_offset;
+            size_t m_len;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct File : public Obj {
@@ -857,12 +1302,45 @@ namespace earl {
                  std::shared_ptr<Str> mode,
                  std::fstream stream);
 
+            /// @brief Flushes whatever is left in the write buffer
+            ~File();
+
             void set_open(void);
             void set_closed(void);
             void dump(void);
             void close(void);
+
+            /// @brief Collect writes in a buffer of `size` bytes and
+            ///        hand them to the file with as few `writev` calls
+            ///        as possible, instead of going through the stream
+            void set_write_buffer(size_t size);
+
+            /// @brief Write out everything that has been buffered
+            void flush(void);
+
+            /// @brief Read the whole file. Regular files are mapped
+            ///        and copied straight out of the mapping.
             std::shared_ptr<Str> read(void);
+
+            /// @brief Go back to the start of the file to read it line by line
+            void rewind(void);
+
+            /// @brief Read the next line, without its trailing newline.
+            ///        Only the stream buffer is held, not the file.
+            /// @return false once the end of the file is reached
+            bool next_line(std::string &line);
+
+            /// @brief Read up to `n` bytes from the current position,
+            ///        or everything that is left if `n` is negative
+            std::shared_ptr<Bytes> read_bytes(int64_t n);
+
             void write(std::shared_ptr<Obj> value);
+
+            /// @brief Write the bytes as they are
+            void write_bytes(Bytes *value);
+
+            /// @brief Write every element of `value` on its own line,
+            ///        formatted into one buffer and written at once
             void writelines(std::shared_ptr<List> &value);
 
             // Implements
@@ -877,6 +1355,15 @@ namespace earl {
             std::fstream m_stream;
             bool m_open;
             uint32_t m_mode_actual;
+
+            // Only used with a write buffer, see `set_write_buffer`.
+            int m_wfd;
+            std::string m_wbuf;
+            size_t m_wbuf_cap;
+
+            void write_raw(const char *data, size_t len);
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Option : public Obj {
@@ -900,6 +1387,8 @@ namespace earl {
 
         private:
             std::shared_ptr<Obj> m_value;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Break : public Obj {
@@ -907,6 +1396,8 @@ namespace earl {
 
             // Implements
             Type type(void) const                                                         override;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Continue : public Obj {
@@ -914,6 +1405,8 @@ namespace earl {
 
             // Implements
             Type type(void) const                                                         override;
+
+            ALLOC_STATS_MEMBER;
         };
 
         struct Return : public Obj {
@@ -922,6 +1415,8 @@ namespace earl {
             // Implements
             Type type(void) const                                                         override;
             std::shared_ptr<Obj> copy(void)                                               override;
+
+            ALLOC_STATS_MEMBER;
         };
 
         std::string type_to_str(earl::value::Type ty);
@@ -1041,9 +1536,24 @@ namespace earl {
 #include "utils.hpp"
 #include "err.hpp"
 
+inline
+earl::value::DictKey::DictKey(std::shared_ptr<earl::value::Obj> value)
+    : value(std::move(value)), hash(this->value->hash()) {}
+
+inline bool
+earl::value::DictKey::operator==(const earl::value::DictKey &other) const {
+    return hash == other.hash
+        && value->type() == other.value->type()
+        && value->eq(other.value.get());
+}
+
+inline size_t
+std::hash<earl::value::DictKey>::operator()(const earl::value::DictKey &key) const {
+    return key.hash;
+}
+
 template <typename T>
-earl::value::Dict<T>::Dict::Dict(earl::value::Type kty) {
-    m_kty = kty;
+earl::value::Dict<T>::Dict::Dict(earl::value::Type kty) : m_kty(kty) {
     m_iterable = true;
 }
 
@@ -1060,14 +1570,16 @@ earl::value::Dict<T>::ktype(void) const {
 template <typename T>
 std::shared_ptr<earl::value::Obj>
 earl::value::Dict<T>::nth(earl::value::Obj *key, Expr *expr) {
-    if constexpr (std::is_same_v<T, int>) {
+    if constexpr (std::is_same_v<T, int64_t>) {
         if (key->type() != earl::value::Type::Int) {
             Err::err_wexpr(expr);
             const std::string msg = "key must be of type int";
             throw InterpreterException(msg);
         }
-        int k = dynamic_cast<earl::value::Int *>(key)->value();
-        auto value = m_map.find(k);
+        auto *i = dynamic_cast<earl::value::Int *>(key);
+        if (i->is_big())
+            return std::make_shared<earl::value::Option>();
+        auto value = m_map.find(i->value());
         if (value == m_map.end())
             return std::make_shared<earl::value::Option>();
         return std::make_shared<earl::value::Option>(value->second);
@@ -1108,6 +1620,18 @@ earl::value::Dict<T>::nth(earl::value::Obj *key, Expr *expr) {
             return std::make_shared<earl::value::Option>();
         return std::make_shared<earl::value::Option>(value->second);
     }
+    else if constexpr (std::is_same_v<T, earl::value::DictKey>) {
+        if (!key->is_hashable()) {
+            Err::err_wexpr(expr);
+            const std::string msg = "key of type `"+earl::value::type_to_str(key->type())+"` is not hashable";
+            throw InterpreterException(msg);
+        }
+        // Non-owning pointer, the probe key only lives for the lookup.
+        auto value = m_map.find(earl::value::DictKey(std::shared_ptr<earl::value::Obj>(std::shared_ptr<earl::value::Obj>{}, key)));
+        if (value == m_map.end())
+            return std::make_shared<earl::value::Option>();
+        return std::make_shared<earl::value::Option>(value->second);
+    }
     assert(false && "unreachable");
     return nullptr; // unreachable
 }
@@ -1138,6 +1662,8 @@ earl::value::Dict<T>::empty(void) const {
 // Implements
 template <typename T> earl::value::Type
 earl::value::Dict<T>::type(void) const {
+    if constexpr (std::is_same_v<T, earl::value::DictKey>)
+        return Type::DictAny;
     switch (m_kty) {
     case earl::value::Type::Int: return Type::DictInt;
     case earl::value::Type::Str: return Type::DictStr;
@@ -1173,7 +1699,7 @@ earl::value::Dict<T>::to_cxxstring(void) {
     int i = 0;
     for (auto it = map.begin(); it != map.end(); ++it) {
         using Tx = std::decay_t<T>;
-        if constexpr (std::is_same_v<Tx, int>)
+        if constexpr (std::is_same_v<Tx, int64_t>)
             res += std::to_string(it->first);
         else if constexpr (std::is_same_v<Tx, double>)
             res += std::to_string(it->first);
@@ -1181,6 +1707,8 @@ earl::value::Dict<T>::to_cxxstring(void) {
             res += std::string(1, it->first);
         else if constexpr (std::is_same_v<Tx, std::string>)
             res += it->first;
+        else if constexpr (std::is_same_v<Tx, earl::value::DictKey>)
+            res += it->first.value->to_cxxstring();
         else
             res += it->first;
         res += ": ";
@@ -1195,10 +1723,11 @@ earl::value::Dict<T>::to_cxxstring(void) {
 
 template <typename T> earl::value::Iterator
 earl::value::Dict<T>::iter_begin(void) {
-    if constexpr (std::is_same_v<std::decay_t<T>, int> ||
+    if constexpr (std::is_same_v<std::decay_t<T>, int64_t> ||
                   std::is_same_v<std::decay_t<T>, double> ||
                   std::is_same_v<std::decay_t<T>, char> ||
-                  std::is_same_v<std::decay_t<T>, std::string>)
+                  std::is_same_v<std::decay_t<T>, std::string> ||
+                  std::is_same_v<std::decay_t<T>, earl::value::DictKey>)
         return m_map.begin();
     else
         static_assert("Dictionary Iterator: Unsupported BEGIN type");
@@ -1207,10 +1736,11 @@ earl::value::Dict<T>::iter_begin(void) {
 
 template <typename T> earl::value::Iterator
 earl::value::Dict<T>::iter_end(void) {
-    if constexpr (std::is_same_v<std::decay_t<T>, int> ||
+    if constexpr (std::is_same_v<std::decay_t<T>, int64_t> ||
                   std::is_same_v<std::decay_t<T>, double> ||
                   std::is_same_v<std::decay_t<T>, char> ||
-                  std::is_same_v<std::decay_t<T>, std::string>)
+                  std::is_same_v<std::decay_t<T>, std::string> ||
+                  std::is_same_v<std::decay_t<T>, earl::value::DictKey>)
         return m_map.end();
     else
         static_assert("Dictionary Iterator: Unsupported END type");
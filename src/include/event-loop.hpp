@@ -0,0 +1,74 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: event-loop.hpp
+// Description:
+//   The event loop behind `@async` functions. Every task runs on
+//   its own stack and is suspended whenever it awaits something that
+//   is not done yet. While the main program awaits, the loop runs
+//   ready tasks and otherwise blocks in epoll until a timer expires,
+//   a file descriptor becomes readable or a child process exits.
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "earl.hpp"
+
+namespace event_loop {
+    /// @brief Create a task that runs `body` on its own stack. It does
+    ///        not start until something awaits or the loop is drained.
+    std::shared_ptr<earl::value::Task> spawn(std::function<std::shared_ptr<earl::value::Obj>(void)> body);
+
+    /// @brief Check if we are currently running inside of a task
+    bool in_task(void);
+
+    /// @brief Wait for `task` to finish and get its value. Inside of a
+    ///        task this suspends it, otherwise the loop is run until
+    ///        `task` is done.
+    /// @note Throws std::runtime_error if nothing is left that could
+    ///       ever finish `task`.
+    std::shared_ptr<earl::value::Obj> await(std::shared_ptr<earl::value::Task> task);
+
+    /// @brief A task that is done after `us` microseconds
+    std::shared_ptr<earl::value::Task> timer(uint64_t us);
+
+    /// @brief A task that is done once `fd` has something to read
+    std::shared_ptr<earl::value::Task> readable(int fd);
+
+    /// @brief Run `cmd` in the background
+    /// @return A task that resolves to the tuple (exit code, stdout, stderr)
+    std::shared_ptr<earl::value::Task> command(const std::string &cmd);
+
+    /// @brief Run the loop until there is nothing left to do
+    /// @note Rethrows the error of the first failed task whose
+    ///       result was never asked for.
+    void drain(void);
+};
+
+#endif // EVENT_LOOP_H
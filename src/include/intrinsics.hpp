@@ -185,6 +185,13 @@ namespace Intrinsics {
     extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_dict_member_functions;
     extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_time_member_functions;
     extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_bool_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_set_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_deque_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_priorityqueue_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_matrix_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_procpool_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_task_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_bytes_member_functions;
 
     /// @brief Check if an identifier is the name of an intrinsic function
     /// @param id The identifier to check
@@ -284,6 +291,16 @@ namespace Intrinsics {
                     std::shared_ptr<Ctx> &ctx,
                     Expr *expr);
 
+    /// @brief Change when stdout is flushed
+    /// @param params One of `auto`, `line`, `full` or `none` (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return unit
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_set_stdout_buffer__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                             std::shared_ptr<Ctx> &ctx,
+                                             Expr *expr);
+
     /// @brief Unset a runtime flag
     /// @param params All flags as strings (size: any)
     /// @param ctx The context
@@ -429,6 +446,58 @@ namespace Intrinsics {
                    std::shared_ptr<Ctx> &ctx,
                    Expr *expr);
 
+    /// @brief Create a set
+    /// @param params An optional list of initial elements (size: 0|1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return Set EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_set__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    /// @brief Create a double-ended queue
+    /// @param params An optional list of initial elements (size: 0|1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return Deque EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_deque__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    /// @brief Create a priority queue
+    /// @param params An optional comparator closure (size: 0|1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return PriorityQueue EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_priority_queue__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                          std::shared_ptr<Ctx> &ctx,
+                                          Expr *expr);
+
+    /// @brief Create a dense matrix of floats
+    /// @param params The rows, the columns and an optional flat or
+    ///               nested list of initial elements (size: 2|3)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return Matrix EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_matrix__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr);
+
+    /// @brief Create a pool for running shell commands concurrently
+    /// @param params The maximum number of commands running at
+    ///               once, defaults to the number of CPUs (size: 0|1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return ProcPool EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_procpool__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic_assert(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                      std::shared_ptr<Ctx> &ctx,
@@ -449,11 +518,30 @@ namespace Intrinsics {
                     std::shared_ptr<Ctx> &ctx,
                     Expr *expr);
 
+    /// @brief Print every element of a list followed by a newline,
+    ///        all in one write
+    /// @param params The list and an optional separator that goes
+    ///               between the elements, `"\n"` by default (size: 1|2)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return unit
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_print_all__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic_fprint(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                      std::shared_ptr<Ctx> &ctx,
                      Expr *expr);
 
+    /// @brief Open a file
+    /// @param params The path, the mode (any of `r`, `w` and `b`) and
+    ///               optionally the size of a write buffer in bytes,
+    ///               which makes writes go out in batches (size: 2|3)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return File EARL value object
     std::shared_ptr<earl::value::Obj>
     intrinsic_open(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                    std::shared_ptr<Ctx> &ctx,
@@ -549,6 +637,40 @@ namespace Intrinsics {
                                 std::shared_ptr<Ctx> &ctx,
                                 Expr *expr);
 
+    /// @brief Make bytes out of a str, a list of ints in 0..255 or other bytes
+    /// @param params The value to convert (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return The bytes
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_bytes__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    /// @brief Recursively list a directory
+    /// @param params The directory and an optional dictionary of
+    ///               options: `ext` (str or list of str), `glob` (str),
+    ///               `max_depth` (int), `threads` (int, 0 for one per CPU)
+    ///               and `dirs` (bool, also list directories) (size: 1|2)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return A sorted list of paths
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_walk__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr);
+
+    /// @brief Get the value allocation counters of `--alloc-stats`
+    /// @param params Unused (size: 0)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return A dictionary of `compiled`, `active`, and the counters
+    ///         per value type (`types`) and per AST node kind (`sites`)
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___stats__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                        std::shared_ptr<Ctx> &ctx,
+                        Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic___internal_ls__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                               std::shared_ptr<Ctx> &ctx,
@@ -569,6 +691,112 @@ namespace Intrinsics {
                                                std::shared_ptr<Ctx> &ctx,
                                                Expr *expr);
 
+    /// @brief Run commands concurrently with the output of each
+    ///        stage connected to the input of the next
+    /// @param params A list of stages, each a command or a closure
+    ///               that maps a chunk of output to a new one, and
+    ///               an optional bool to collect the output (size: 1|2)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return A tuple of the exit codes of the commands and the output
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_pipeline__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr);
+
+    /// @brief Wait for a task to finish. Inside of an @async
+    ///        function this lets other tasks run in the meantime.
+    /// @param params The task (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return The value of the task
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_await__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    /// @brief Wait for every task in a list to finish
+    /// @param params A list of tasks (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return A list of the values of the tasks, in order
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_await_all__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr);
+
+    /// @brief Wait for the first task in a list to finish
+    /// @param params A list of tasks (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return A tuple of the index of the task and its value
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_await_any__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr);
+
+    /// @brief Create a task that finishes after some time
+    /// @param params The number of milliseconds (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return Task EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_timer__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    /// @brief Create a task that finishes once a file
+    ///        descriptor has something to read
+    /// @param params The file descriptor (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return Task EARL value object
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_fd_readable__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr);
+
+    /// @brief Run a shell command in the background
+    /// @param params The command (size: 1)
+    /// @param ctx The context
+    /// @param expr Used for error reporting
+    /// @return A task that resolves to a tuple of the exit code,
+    ///         stdout and stderr of the command
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_bash_async__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                      std::shared_ptr<Ctx> &ctx,
+                                      Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_gcd__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_lcm__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_powmod__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_pow__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_floor__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic___internal_ceil__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr);
+
     /*** INTRINSIC MEMBER FUNCTION IMPLEMENTATIONS ***/
 
     std::shared_ptr<earl::value::Obj>
@@ -721,6 +949,30 @@ namespace Intrinsics {
                                 std::shared_ptr<Ctx> &ctx,
                                 Expr *expr);
 
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_flush(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_read_bytes(std::shared_ptr<earl::value::Obj> obj,
+                                std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_write_bytes(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_lines(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic_member_ascii(std::shared_ptr<earl::value::Obj> obj,
                            std::vector<std::shared_ptr<earl::value::Obj>> &unused,
@@ -840,6 +1092,186 @@ namespace Intrinsics {
                              std::vector<std::shared_ptr<earl::value::Obj>> &unused,
                              std::shared_ptr<Ctx> &ctx,
                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_remove(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_union(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_intersection(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_difference(std::shared_ptr<earl::value::Obj> obj,
+                                std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_push_back(std::shared_ptr<earl::value::Obj> obj,
+                               std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_push_front(std::shared_ptr<earl::value::Obj> obj,
+                                std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_pop_back(std::shared_ptr<earl::value::Obj> obj,
+                              std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                              std::shared_ptr<Ctx> &ctx,
+                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_pop_front(std::shared_ptr<earl::value::Obj> obj,
+                               std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_front(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_push(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_top(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_at(std::shared_ptr<earl::value::Obj> obj,
+                        std::vector<std::shared_ptr<earl::value::Obj>> &idxs,
+                        std::shared_ptr<Ctx> &ctx,
+                        Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_set(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &values,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_rows(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_cols(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_transpose(std::shared_ptr<earl::value::Obj> obj,
+                               std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_matmul(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_to_list(std::shared_ptr<earl::value::Obj> obj,
+                             std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                             std::shared_ptr<Ctx> &ctx,
+                             Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_spawn(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_wait(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_wait_any(std::shared_ptr<earl::value::Obj> obj,
+                              std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                              std::shared_ptr<Ctx> &ctx,
+                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_wait_all(std::shared_ptr<earl::value::Obj> obj,
+                              std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                              std::shared_ptr<Ctx> &ctx,
+                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_pending(std::shared_ptr<earl::value::Obj> obj,
+                             std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                             std::shared_ptr<Ctx> &ctx,
+                             Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_done(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_find(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_hex(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_int_le(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_int_be(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_crc32(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_decode(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
 };
 
 #endif // INTRINSICS_H
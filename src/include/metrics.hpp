@@ -0,0 +1,72 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// File: metrics.hpp
+// Description:
+//   The `--metrics[=<file>]` mode, for scripts that run for a long
+//   time. Counters are kept while the script runs and a background
+//   thread rewrites the file with them every few seconds in the
+//   Prometheus text format, so the node exporter textfile collector
+//   (or anything else) can read them without stopping the script.
+//
+//   Counted are statements, calls, shell commands with a latency
+//   histogram of the ones that were waited on, and the resident set
+//   size. A build with `-DALLOC_STATS=ON` also gives allocations and
+//   values that are still referenced, per type.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace metrics {
+    /// @brief Whether anything is counted
+    extern bool active;
+
+    extern std::atomic<uint64_t> statements;
+    extern std::atomic<uint64_t> function_calls;
+    extern std::atomic<uint64_t> closure_calls;
+    extern std::atomic<uint64_t> intrinsic_calls;
+    extern std::atomic<uint64_t> shell_spawned;
+
+    /// @brief Start counting and writing the counters to `out`
+    void enable(const std::string &out);
+
+    /// @brief Add one to `counter`, if counting
+    inline void count(std::atomic<uint64_t> &counter) {
+        if (active)
+            counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Call before starting a shell command that will be waited on
+    /// @return When it started, or 0 if not counting
+    int64_t shell_start(void);
+
+    /// @brief Record a shell command from `shell_start` that finished
+    ///        with the wait status `status`
+    void shell_finish(int64_t start, int status);
+};
+
+#endif // METRICS_H
@@ -0,0 +1,60 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: output.hpp
+// Description:
+//   The buffer behind `std::cout`. Everything the interpreter prints
+//   goes through it, and its flush policy decides how often that turns
+//   into a write(2). Commands that are started flush it first so that
+//   their output lands after whatever was printed before them.
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <string>
+
+namespace output {
+    enum class Policy {
+        Auto, // `Line` for a terminal, `Full` otherwise
+        Line, // flush after every newline
+        Full, // flush only when the buffer fills up
+        None, // flush after every write
+    };
+
+    /// @brief Install the buffer on `std::cout`
+    void init(void);
+
+    /// @brief Change when stdout is flushed. Whatever is buffered is
+    ///        flushed first.
+    void set_policy(Policy policy);
+
+    /// @brief Get a policy from its name (auto|line|full|none)
+    /// @return false if `name` is not a policy
+    bool policy_from_str(const std::string &name, Policy &policy);
+
+    /// @brief Write everything that is buffered
+    void flush(void);
+};
+
+#endif // OUTPUT_H
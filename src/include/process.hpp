@@ -0,0 +1,115 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: process.hpp
+// Description:
+//   Running external commands. Commands that are a plain list of
+//   words are started directly with posix_spawnp, everything else
+//   goes through `/bin/sh -c`.
+
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <spawn.h>
+#include <sys/types.h>
+
+namespace process {
+    /// @brief Split `cmd` into words if it does not need a shell
+    /// @return false if `cmd` uses any shell syntax (pipes, redirects,
+    ///         expansions, globs, assignments, etc.) or starts with a
+    ///         shell builtin
+    /// @note Single quotes, and double quotes without `$`, `\`` or `\\`
+    ///       inside of them, are understood.
+    bool split_simple(const std::string &cmd, std::vector<std::string> &argv);
+
+    /// @brief Start `cmd` without waiting for it
+    /// @param actions File actions applied in the child, may be null
+    /// @param attr Spawn attributes, may be null
+    /// @return The pid of the child, or -1 if it could not be started
+    pid_t start(const std::string &cmd,
+                posix_spawn_file_actions_t *actions,
+                posix_spawnattr_t *attr = nullptr);
+
+    /// @brief Run `cmd` and wait for it to finish
+    /// @return The wait status, or -1 if it could not be started (like `system()`)
+    int run(const std::string &cmd);
+
+    /// @brief Run `cmd`, collecting everything it writes to stdout in `out`
+    /// @return The wait status, or -1 if it could not be started (like `pclose()`)
+    int run_capture(const std::string &cmd, std::string &out);
+
+    /// @brief Reads the stdout of a command one line at a time. Only
+    ///        a fixed size buffer is held, so a command that writes
+    ///        faster than lines are consumed blocks on the full pipe.
+    struct LineReader {
+        LineReader(const std::string &cmd);
+
+        /// @brief Stops the command if it is still running
+        ~LineReader();
+
+        /// @brief Check if the command was started
+        bool ok(void) const;
+
+        /// @brief Read the next line, without its trailing newline
+        /// @return false once the command closed its stdout
+        bool next(std::string &line);
+
+        /// @brief Close the pipe and wait for the command
+        /// @return The wait status, or -1 if it could not be waited on
+        int finish(void);
+
+    private:
+        pid_t m_pid;
+        int m_fd;
+        bool m_eof;
+        std::vector<char> m_buf;
+        size_t m_start;
+        size_t m_end;
+        int64_t m_started;
+    };
+
+    /// @brief One stage of a pipeline. Either a command, or a
+    ///        `filter` that is given every chunk read from the
+    ///        previous stage and returns what to pass on.
+    struct Stage {
+        std::string cmd;
+        std::function<std::string(std::string &chunk)> filter;
+    };
+
+    /// @brief Run all `stages` at once with the stdout of each one
+    ///        connected to the stdin of the next. Neighbouring commands
+    ///        share a pipe directly, the interpreter only sees the
+    ///        bytes that go through a filter.
+    /// @param out Collects the output of the last stage. If null, the
+    ///            output goes to stdout.
+    /// @return The wait status of every command, in order
+    /// @note The first stage must be a command.
+    std::vector<int> run_pipeline(const std::vector<Stage> &stages, std::string *out);
+};
+
+#endif // PROCESS_H
@@ -0,0 +1,180 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: profiler.hpp
+// Description:
+//   The `--profile` function profiler and the `--sample-profile`
+//   sampler. Every call to a user function, closure, intrinsic or
+//   member intrinsic is wrapped in a `Scope`.
+//
+//   The function profiler counts each call and measures its inclusive
+//   time (with callees) and self time (without them). A table is
+//   printed to stderr when the program exits and the full data is
+//   written as JSON.
+//
+//   The sampler keeps the names and call sites of the calls in a fixed
+//   array that a SIGPROF handler copies into a ring buffer. The stacks
+//   are written in the collapsed format that flamegraph.pl reads.
+//
+//   The line profiler (`--line-profile`, `--coverage`) counts every
+//   statement that is evaluated under the file and row it starts on,
+//   and for `--line-profile` its self time too. It prints the source
+//   annotated with both, or writes the counts as lcov.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "token.hpp"
+
+namespace profiler {
+    enum class Kind {
+        Function,
+        Closure,
+        Intrinsic,
+        Member,
+    };
+
+    /// @brief Whether calls are being recorded, by either profiler.
+    ///        Checked before anything else so that it costs one
+    ///        branch when both are off.
+    extern bool active;
+
+    /// @brief Start recording calls. The report is written when
+    ///        the program exits.
+    /// @param out The file to write the JSON report to
+    void enable(const std::string &out);
+
+    /// @brief Start sampling the call stack `hz` times per second of
+    ///        CPU time. The stacks are written when the program exits.
+    /// @param out The file to write the collapsed stacks to
+    void enable_sampling(const std::string &out, int hz);
+
+    /// @brief Record the start of a call
+    /// @param site Where the call was made, if known
+    /// @return The depth of the call, which is given back to `leave`
+    size_t enter(Kind kind, const std::string &name, Token *site);
+
+    /// @brief Same as `enter`, for the member intrinsic `name` of
+    ///        the value type `type` (an `earl::value::Type`)
+    size_t enter_member(int type, const std::string &name, Token *site);
+
+    /// @brief Record the end of the call at `depth`
+    void leave(size_t depth);
+
+    /// @brief Whether statements are being counted, by either
+    ///        `--line-profile` or `--coverage`
+    extern bool lines_active;
+
+    /// @brief Start counting and timing statements. The annotated
+    ///        source is written when the program exits.
+    /// @param out The file to write it to, or stderr if empty
+    void enable_lines(const std::string &out);
+
+    /// @brief Start counting statements. The counts are written
+    ///        as lcov when the program exits.
+    /// @param out The file to write the tracefile to
+    void enable_coverage(const std::string &out);
+
+    /// @brief Make the line of the statement starting at `tok` known
+    ///        with no hits, so that lines that never run are reported
+    /// @return The id of the line, given to `line_enter`
+    uint32_t line_id(const Token *tok);
+
+    /// @brief Record the start of a statement on the line `id`
+    /// @return The depth of the statement, which is given back to `line_leave`
+    size_t line_enter(uint32_t id);
+
+    /// @brief Record the end of the statement at `depth`
+    void line_leave(size_t depth);
+
+    /// @brief Stop all of the profilers and write their reports
+    void report(void);
+
+    /// @brief The calls and statements running on a stack other than
+    ///        the current one, such as an `@async` task's
+    struct Stack;
+
+    /// @brief An empty stack for a new task. Its first call is counted
+    ///        as called from the call that is running now.
+    /// @return nullptr if nothing is being profiled
+    std::shared_ptr<Stack> new_stack(void);
+
+    /// @brief Exchange the current calls and statements with the ones
+    ///        saved in `stack`. Called when switching to a task and
+    ///        again when switching back. Time spent on the other stack
+    ///        is not counted as the self time of the calls left behind.
+    void swap_stack(Stack *stack);
+
+    /// @brief Records one call for as long as it is alive, so that
+    ///        calls that throw are finished as well.
+    struct Scope {
+        Scope(Kind kind, const std::string &name, Token *site = nullptr)
+            : m_depth(active ? enter(kind, name, site) : NONE) {}
+
+        /// @brief A member intrinsic, named `<type>.<name>`
+        Scope(int type, const std::string &name, Token *site = nullptr)
+            : m_depth(active ? enter_member(type, name, site) : NONE) {}
+
+        /// @brief A closure, named after where it was written (`tok`)
+        Scope(Token *tok, Token *site = nullptr)
+            : m_depth(active ? enter(Kind::Closure, "<closure "+tok->m_fp+":"+std::to_string(tok->m_row)+">", site) : NONE) {}
+
+        ~Scope() {
+            if (m_depth != NONE)
+                leave(m_depth);
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        static constexpr size_t NONE = static_cast<size_t>(-1);
+        size_t m_depth;
+    };
+
+    /// @brief Records one statement for as long as it is alive
+    struct LineScope {
+        LineScope(uint32_t id)
+            : m_depth(lines_active && id != UINT32_MAX ? line_enter(id) : NONE) {}
+
+        ~LineScope() {
+            if (m_depth != NONE)
+                line_leave(m_depth);
+        }
+
+        LineScope(const LineScope &) = delete;
+        LineScope &operator=(const LineScope &) = delete;
+
+    private:
+        static constexpr size_t NONE = static_cast<size_t>(-1);
+        size_t m_depth;
+    };
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,66 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// File: shell-stats.hpp
+// Description:
+//   Latency of the shell commands that a script runs (`$"..."`,
+//   multiline bash, pipes, `foreach ... in $"..." |> lines`, `use`
+//   and `exec`). Every command's wall time, exit code and captured
+//   bytes are recorded in an HDR style histogram and per source
+//   location.
+//
+//   `--shell-stats` prints the percentiles and the commands that took
+//   the most time in total when the program exits. `--slow-bash=<ms>`
+//   logs every command that took longer than <ms> as it finishes.
+
+#ifndef SHELL_STATS_H
+#define SHELL_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "token.hpp"
+
+namespace shell_stats {
+    /// @brief Whether commands are being recorded
+    extern bool active;
+
+    /// @brief Print a summary to stderr when the program exits
+    void enable_summary(void);
+
+    /// @brief Log the commands that take longer than `ms` to stderr
+    void enable_slow_log(double ms);
+
+    /// @brief Call before starting a command
+    /// @return When it started, or 0 if not recording
+    int64_t start(void);
+
+    /// @brief Record a command from `start` that has finished
+    /// @param site Where the command is in the source, can be null
+    /// @param status Its wait status, or -1 if it could not be run
+    /// @param bytes How much of its output was captured
+    void finish(int64_t start, const std::string &cmd, const Token *site, int status, size_t bytes);
+};
+
+#endif // SHELL_STATS_H
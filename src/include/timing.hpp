@@ -0,0 +1,87 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: timing.hpp
+// Description:
+//   The phase breakdown of `--time`. Loading the config and the
+//   `.earl_mem` file, reading, lexing and parsing sources, imports and
+//   interpretation are each wrapped in a `Scope`. A phase only gets the
+//   time that is not spent in the phases inside of it, so an import
+//   that is run from the interpreter is not counted twice. Running
+//   the top level of an imported module is part of its import, and
+//   imports are also timed as a whole per module.
+//
+//   Phases are always recorded, there are only a few per source file,
+//   because the config is loaded before `--time` is seen.
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <cstddef>
+#include <string>
+
+namespace timing {
+    enum class Phase {
+        HiddenFile = 0,
+        MemFile,
+        Read,
+        Lex,
+        Parse,
+        Import,
+        Interpret,
+    };
+
+    /// @brief Write the breakdown when the program exits
+    /// @param json_out A file to also write it to as JSON, or empty
+    void enable(const std::string &json_out);
+
+    /// @brief Record the start of a phase
+    /// @param module The module being imported, for `Phase::Import`
+    /// @return The depth of the phase, which is given back to `leave`
+    size_t enter(Phase phase, const std::string *module = nullptr);
+
+    /// @brief Record the end of the phase at `depth`
+    void leave(size_t depth);
+
+    /// @brief Write the breakdown to stdout
+    void report(void);
+
+    /// @brief Records one phase for as long as it is alive
+    struct Scope {
+        Scope(Phase phase) : m_depth(enter(phase)) {}
+
+        /// @brief The import of `module`
+        Scope(Phase phase, const std::string &module) : m_depth(enter(phase, &module)) {}
+
+        ~Scope() { leave(m_depth); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        size_t m_depth;
+    };
+};
+
+#endif // TIMING_H
@@ -0,0 +1,107 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: trace.hpp
+// Description:
+//   The `--trace=<file>` mode. Calls to user functions and closures,
+//   imports, shell commands and file IO are recorded as Chrome trace
+//   events (https://ui.perfetto.dev or chrome://tracing can open the
+//   file). Events are kept in memory and a background thread appends
+//   them to the file, so a long running script can be looked at
+//   while it is still running.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+#include "token.hpp"
+
+namespace trace {
+    /// @brief Whether events are being recorded
+    extern bool active;
+
+    /// @brief Start recording events into `out`. The file is
+    ///        finished when the program exits.
+    void enable(const std::string &out);
+
+    /// @brief Write the events that are left and finish the file
+    void finish(void);
+
+    /// @brief One event, from when it is made until it is destroyed.
+    ///        It does nothing when tracing is off.
+    struct Span {
+        /// @param cat The category, one of function|closure|import|shell|file
+        Span(const char *cat, const std::string &name)
+            : m_on(active) {
+            if (m_on)
+                begin(cat, name);
+        }
+
+        Span(const char *cat, const char *name)
+            : m_on(active) {
+            if (m_on)
+                begin(cat, name);
+        }
+
+        /// @brief A closure, named after where it was written (`tok`)
+        Span(Token *tok)
+            : m_on(active) {
+            if (m_on)
+                begin("closure", "<closure "+tok->m_fp+":"+std::to_string(tok->m_row)+">");
+        }
+
+        ~Span() {
+            if (m_on)
+                end();
+        }
+
+        /// @brief Attach a value to the event, shown when it is selected
+        void arg(const char *key, const std::string &value);
+        void arg(const char *key, int64_t value);
+
+        /// @brief Attach where the call was made from as `site`
+        void site(Token *tok);
+
+        /// @brief Attach the exit code (or signal) of a command from
+        ///        its wait status
+        void status(int status);
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        void begin(const char *cat, const std::string &name);
+        void end(void);
+
+        bool m_on;
+        const char *m_cat = nullptr;
+        std::string m_name = "";
+        std::string m_args = "";
+        int64_t m_start_ns = 0;
+    };
+};
+
+#endif // TRACE_H
@@ -0,0 +1,63 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// File: walk.hpp
+// Description:
+//   Recursively listing a directory tree. Entries are read with
+//   readdir(3) and their type comes from `d_type`, so a file is
+//   only ever stat'ed when the file system does not report it.
+
+#ifndef WALK_H
+#define WALK_H
+
+#include <string>
+#include <vector>
+
+namespace walk {
+    struct Options {
+        /// @brief Only keep files with one of these extensions (without the dot)
+        std::vector<std::string> exts;
+
+        /// @brief Only keep entries whose name matches this fnmatch(3) pattern
+        std::string glob;
+
+        /// @brief How many levels to descend, the entries of the
+        ///        root itself are level 1. Negative means no limit.
+        int max_depth = -1;
+
+        /// @brief How many threads read directories at once
+        size_t threads = 1;
+
+        /// @brief Also keep the directories themselves
+        bool dirs = false;
+    };
+
+    /// @brief Walk the tree under `root`. Symbolic links are not followed
+    ///        and directories that cannot be read are skipped.
+    /// @return The paths of all entries that were kept, sorted
+    /// @note Throws std::runtime_error if `root` itself cannot be read.
+    std::vector<std::string> walk(const std::string &root, const Options &opts);
+};
+
+#endif // WALK_H
@@ -42,6 +42,14 @@
 #include "common.hpp"
 #include "earl.hpp"
 #include "lexer.hpp"
+#include "process.hpp"
+#include "event-loop.hpp"
+#include "profiler.hpp"
+#include "alloc-stats.hpp"
+#include "timing.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+#include "shell-stats.hpp"
 
 using namespace Interpreter;
 
@@ -73,6 +81,15 @@ eval_stmt_def(StmtDef *stmt, std::shared_ptr<Ctx> &ctx, bool evaling_class_metho
 static std::shared_ptr<earl::value::Obj>
 unpack_ER(ER &er, std::shared_ptr<Ctx> &ctx, bool ref, PackedERPreliminary *perp = nullptr);
 
+static std::shared_ptr<earl::value::Obj>
+eval_stmt_foreach_bash_lines(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx);
+
+static std::shared_ptr<earl::value::Obj>
+eval_stmt_foreach_lines(StmtForeach *stmt,
+                        std::shared_ptr<Ctx> &ctx,
+                        const std::function<bool(std::string &)> &next,
+                        bool &exhausted);
+
 static std::string
 flatten_info(const std::vector<std::string> &lines) {
     std::string info = "";
@@ -137,10 +154,39 @@ method_not_declared(std::string given, std::shared_ptr<earl::value::Obj> accesso
     case earl::value::Type::DictInt:
     case earl::value::Type::DictStr:
     case earl::value::Type::DictFloat:
-    case earl::value::Type::DictChar: {
+    case earl::value::Type::DictChar:
+    case earl::value::Type::DictAny: {
         for (auto it = Intrinsics::intrinsic_dict_member_functions.begin(); it != Intrinsics::intrinsic_dict_member_functions.end(); ++it)
             possible.push_back(it->first);
     } break;
+    case earl::value::Type::Set: {
+        for (auto it = Intrinsics::intrinsic_set_member_functions.begin(); it != Intrinsics::intrinsic_set_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::Deque: {
+        for (auto it = Intrinsics::intrinsic_deque_member_functions.begin(); it != Intrinsics::intrinsic_deque_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::PriorityQueue: {
+        for (auto it = Intrinsics::intrinsic_priorityqueue_member_functions.begin(); it != Intrinsics::intrinsic_priorityqueue_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::Matrix: {
+        for (auto it = Intrinsics::intrinsic_matrix_member_functions.begin(); it != Intrinsics::intrinsic_matrix_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::ProcPool: {
+        for (auto it = Intrinsics::intrinsic_procpool_member_functions.begin(); it != Intrinsics::intrinsic_procpool_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::Task: {
+        for (auto it = Intrinsics::intrinsic_task_member_functions.begin(); it != Intrinsics::intrinsic_task_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::Bytes: {
+        for (auto it = Intrinsics::intrinsic_bytes_member_functions.begin(); it != Intrinsics::intrinsic_bytes_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
     default: {
         return identifier_not_declared(given, possible);
     } break;
@@ -435,6 +481,45 @@ evaluate_function_parameters_wrefs(ExprFuncCall *funccall,
     return res;
 }
 
+// Calling an @async function does not run its body, it hands back
+// a Task that the event loop runs once something awaits it. `after`
+// runs when the body is done, before the return type is checked.
+static std::shared_ptr<earl::value::Obj>
+spawn_async_call(ExprFuncCall *expr,
+                 std::shared_ptr<earl::function::Obj> func,
+                 std::shared_ptr<Ctx> mask,
+                 std::shared_ptr<Ctx> ctx,
+                 std::function<void(void)> after = nullptr) {
+    metrics::count(metrics::function_calls);
+
+    // Kept by the task, which runs after the call has returned.
+    std::shared_ptr<Token> site = expr ? expr->m_tok : nullptr;
+    try {
+        return event_loop::spawn([func, mask, ctx, after, site]() mutable -> std::shared_ptr<earl::value::Obj> {
+            std::shared_ptr<earl::value::Obj> res = nullptr;
+            {
+                profiler::Scope prof(profiler::Kind::Function, func->id(), site.get());
+                trace::Span span("function", func->id());
+                res = Interpreter::eval_stmt_block(func->block(), mask);
+            }
+            if (after)
+                after();
+            if (res && res->type() == earl::value::Type::Return)
+                res = std::make_shared<earl::value::Void>();
+            if (func->is_explicit_typed()) {
+                auto ty = func->get_explicit_type();
+                Interpreter::typecheck(ty, res.get(), ctx);
+            }
+            return res;
+        });
+    } catch (const std::runtime_error &e) {
+        if (expr)
+            Err::err_wexpr(expr);
+        const std::string msg = "cannot call async function `"+func->id()+"`: "+e.what();
+        throw InterpreterException(msg);
+    }
+}
+
 static std::shared_ptr<earl::value::Obj>
 eval_user_defined_function_wo_params(const std::string &id,
                                      ExprFuncCall *funccall,
@@ -513,6 +598,20 @@ eval_user_defined_function_wo_params(const std::string &id,
         }
 
         std::shared_ptr<Ctx> mask = fctx;
+
+        if ((func->attrs() & static_cast<uint32_t>(Attr::Async)) != 0) {
+            return spawn_async_call(funccall, func, mask, ctx, [params, originally_was_const]() {
+                for (size_t i = 0; i < originally_was_const.size(); ++i) {
+                    if (!originally_was_const[i])
+                        params[i]->unset_const();
+                }
+            });
+        }
+
+        profiler::Scope prof(profiler::Kind::Function, func->id(), funccall ? funccall->m_tok.get() : nullptr);
+        trace::Span span("function", func->id());
+        metrics::count(metrics::function_calls);
+        span.site(funccall ? funccall->m_tok.get() : nullptr);
         auto res = Interpreter::eval_stmt_block(func->block(), mask);
 
         for (size_t i = 0; i < originally_was_const.size(); ++i) {
@@ -541,6 +640,10 @@ eval_user_defined_function_wo_params(const std::string &id,
         }
         clvalue->load_parameters(params, clctx);
         std::shared_ptr<Ctx> mask = clctx;
+        profiler::Scope prof(clvalue->tok(), funccall ? funccall->m_tok.get() : nullptr);
+        trace::Span span(clvalue->tok());
+        metrics::count(metrics::closure_calls);
+        span.site(funccall ? funccall->m_tok.get() : nullptr);
         return Interpreter::eval_stmt_block(clvalue->block(), mask);
     }
 
@@ -618,6 +721,13 @@ eval_user_defined_function(ExprFuncCall *expr,
             WARN_WARGS("function `%s` is marked as experimental", nullptr, func->id().c_str());
         }
 
+        if ((func->attrs() & static_cast<uint32_t>(Attr::Async)) != 0)
+            return spawn_async_call(expr, func, mask, ctx);
+
+        profiler::Scope prof(profiler::Kind::Function, func->id(), expr ? expr->m_tok.get() : nullptr);
+        trace::Span span("function", func->id());
+        metrics::count(metrics::function_calls);
+        span.site(expr ? expr->m_tok.get() : nullptr);
         auto res = Interpreter::eval_stmt_block(func->block(), mask);
 
         if (func->is_explicit_typed()) {
@@ -640,6 +750,10 @@ eval_user_defined_function(ExprFuncCall *expr,
         }
         clvalue->load_parameters(params, clctx);
         std::shared_ptr<Ctx> mask = clctx;
+        profiler::Scope prof(clvalue->tok(), expr ? expr->m_tok.get() : nullptr);
+        trace::Span span(clvalue->tok());
+        metrics::count(metrics::closure_calls);
+        span.site(expr ? expr->m_tok.get() : nullptr);
         return Interpreter::eval_stmt_block(clvalue->block(), mask);
     }
 
@@ -669,21 +783,30 @@ unpack_ER(ER &er, std::shared_ptr<Ctx> &ctx, bool ref, PackedERPreliminary *perp
 
     // FUNCTIONS/MEMBERS/INTRINSICS
     if (er.is_function_ident()) {
+        // Calls are evaluated here rather than when their term is.
+        ALLOC_STATS_SITE(alloc_stats::term_site(ExprTermType::Func_Call));
         auto params = evaluate_function_parameters(static_cast<ExprFuncCall *>(er.extra), er.ctx, ref);
         if (!(perp && perp->lhs_getter_accessor) && er.is_intrinsic()) {
             Expr *expr = nullptr;
             if (er.extra)
                 expr = static_cast<Expr *>(er.extra);
+            profiler::Scope prof(profiler::Kind::Intrinsic, er.id, er.extra ? static_cast<ExprFuncCall *>(er.extra)->m_tok.get() : nullptr);
+            metrics::count(metrics::intrinsic_calls);
             auto call = Intrinsics::call(er.id, params, ctx, expr);
             if (call->type() == earl::value::Type::Return)
                 call = std::make_shared<earl::value::Void>();
             return call;
         }
 
-        if (er.is_member_intrinsic() && (perp && perp->lhs_getter_accessor)) {
+        // A member can share its name with an intrinsic function (like `flush`).
+        if ((er.is_member_intrinsic() || er.is_intrinsic()) && (perp && perp->lhs_getter_accessor)) {
             if (Intrinsics::is_member_intrinsic(er.id, static_cast<int>(perp->lhs_getter_accessor->type()))) {
                 Expr *expr = nullptr;
                 if (er.extra) expr = static_cast<Expr *>(er.extra);
+                profiler::Scope prof(static_cast<int>(perp->lhs_getter_accessor->type()),
+                                     er.id,
+                                     er.extra ? static_cast<ExprFuncCall *>(er.extra)->m_tok.get() : nullptr);
+                metrics::count(metrics::intrinsic_calls);
                 auto res = Intrinsics::call_member(er.id,
                                                    perp->lhs_getter_accessor->type(),
                                                    perp->lhs_getter_accessor,
@@ -829,10 +952,17 @@ static ER
 eval_expr_term_intlit(ExprIntLit *expr) {
     std::shared_ptr<earl::value::Obj> value = nullptr;
 
-    if (expr->m_base == 10)
-        value = std::make_shared<earl::value::Int>(std::stoi(expr->m_tok->lexeme()));
+    if (expr->m_base == 10) {
+        const std::string &lexeme = expr->m_tok->lexeme();
+        try {
+            value = std::make_shared<earl::value::Int>(static_cast<int64_t>(std::stoll(lexeme)));
+        }
+        catch (const std::out_of_range &) {
+            value = std::make_shared<earl::value::Int>(BigInt::from_str(lexeme));
+        }
+    }
     else
-        value = std::make_shared<earl::value::Int>(std::stoi(expr->m_tok->lexeme(), nullptr, 16));
+        value = std::make_shared<earl::value::Int>(static_cast<int64_t>(std::stoll(expr->m_tok->lexeme(), nullptr, 16)));
 
     return ER(value, ERT::Literal);
 }
@@ -1130,8 +1260,12 @@ eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bo
         auto tuple = dynamic_cast<earl::value::Tuple *>(left_value.get());
         return ER(tuple->nth(idx_value.get(), expr), static_cast<ERT>(ERT::Literal|ERT::TupleAccess));
     }
+    else if (left_value->type() == earl::value::Type::Bytes) {
+        auto bytes = dynamic_cast<earl::value::Bytes *>(left_value.get());
+        return ER(bytes->nth(idx_value.get(), expr), ERT::Literal);
+    }
     else if (left_value->type() == earl::value::Type::DictInt) {
-        auto dict = dynamic_cast<earl::value::Dict<int> *>(left_value.get());
+        auto dict = dynamic_cast<earl::value::Dict<int64_t> *>(left_value.get());
         return ER(dict->nth(idx_value.get(), expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
     }
     else if (left_value->type() == earl::value::Type::DictStr) {
@@ -1146,8 +1280,12 @@ eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bo
         auto dict = dynamic_cast<earl::value::Dict<double> *>(left_value.get());
         return ER(dict->nth(idx_value.get(), expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
     }
+    else if (left_value->type() == earl::value::Type::DictAny) {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(left_value.get());
+        return ER(dict->nth(idx_value.get(), expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
+    }
     else {
-        std::string msg = "cannot use `[]` on non-list, non-tuple, non-dict, or non-str type";
+        std::string msg = "cannot use `[]` on non-list, non-tuple, non-dict, non-bytes, or non-str type";
         Err::err_wexpr(expr);
         throw InterpreterException(msg);
     }
@@ -1180,7 +1318,7 @@ eval_expr_term_closure(ExprClosure *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
 static ER
 eval_expr_term_floatlit(ExprFloatLit *expr) {
-    auto value = std::make_shared<earl::value::Float>(std::stof(expr->m_tok->lexeme()));
+    auto value = std::make_shared<earl::value::Float>(std::stod(expr->m_tok->lexeme()));
     return ER(value, ERT::Literal);
 }
 
@@ -1202,11 +1340,15 @@ eval_expr_term_range(ExprRange *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
     switch (lvalue->type()) {
     case earl::value::Type::Int: {
-        int start = dynamic_cast<earl::value::Int *>(lvalue.get())->value();
-        int end = dynamic_cast<earl::value::Int *>(rvalue.get())->value();
+        int64_t start = dynamic_cast<earl::value::Int *>(lvalue.get())->value();
+        int64_t end = dynamic_cast<earl::value::Int *>(rvalue.get())->value();
         if (expr->m_inclusive) {
-            while (start <= end)
-                values.push_back(std::make_shared<earl::value::Int>(start++));
+            // Stop before incrementing so `end` can be INT64_MAX.
+            for (; start <= end; ++start) {
+                values.push_back(std::make_shared<earl::value::Int>(start));
+                if (start == end)
+                    break;
+            }
         }
         else {
             while (start < end)
@@ -1302,8 +1444,13 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
     switch (ty) {
     case earl::value::Type::Int: {
-        auto dict = std::make_shared<earl::value::Dict<int>>(ty);
-        int __first_key = dynamic_cast<earl::value::Int *>(first_key.get())->value();
+        auto dict = std::make_shared<earl::value::Dict<int64_t>>(ty);
+        if (dynamic_cast<earl::value::Int *>(first_key.get())->is_big()) {
+            const std::string msg = "integer key does not fit in 64 bits, use `Dict()` for arbitrary integer keys";
+            Err::err_wexpr(expr->m_values.at(0).first.get());
+            throw InterpreterException(msg);
+        }
+        int64_t __first_key = dynamic_cast<earl::value::Int *>(first_key.get())->value();
         dict->insert(__first_key, first_value);
 
         for (size_t i = 1; i < expr->m_values.size(); ++i) {
@@ -1318,7 +1465,13 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
                 throw InterpreterException(msg);
             }
 
-            int __key = dynamic_cast<earl::value::Int *>(key.get())->value();
+            if (dynamic_cast<earl::value::Int *>(key.get())->is_big()) {
+                const std::string msg = "integer key does not fit in 64 bits, use `Dict()` for arbitrary integer keys";
+                Err::err_wexpr(expr->m_values.at(i).first.get());
+                throw InterpreterException(msg);
+            }
+
+            int64_t __key = dynamic_cast<earl::value::Int *>(key.get())->value();
             dict->insert(__key, value);
         }
 
@@ -1394,6 +1547,30 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
         return ER(dict, ERT::Literal);
     } break;
     default: {
+        // Any other hashable key (tuples, bools) gets a generic
+        // dictionary, where keys of different types may be mixed.
+        if (first_key->is_hashable()) {
+            auto dict = std::make_shared<earl::value::Dict<earl::value::DictKey>>(earl::value::Type::DictAny);
+            dict->insert(earl::value::DictKey(first_key->copy()), first_value);
+
+            for (size_t i = 1; i < expr->m_values.size(); ++i) {
+                ER key_er = Interpreter::eval_expr(expr->m_values.at(i).first.get(), ctx, false);
+                ER value_er = Interpreter::eval_expr(expr->m_values.at(i).second.get(), ctx, false);
+                auto key = unpack_ER(key_er, ctx, false);
+                auto value = unpack_ER(value_er, ctx, false);
+
+                if (!key->is_hashable()) {
+                    const std::string msg = "type `"+earl::value::type_to_str(key->type())+"` is not hashable and cannot be a key in dictionaries";
+                    Err::err_wexpr(expr->m_values.at(i).first.get());
+                    throw InterpreterException(msg);
+                }
+
+                dict->insert(earl::value::DictKey(key->copy()), value);
+            }
+
+            return ER(dict, ERT::Literal);
+        }
+
         Err::err_wexpr(expr->m_values.at(0).first.get());
         const std::string msg = "type `"+earl::value::type_to_str(ty)+"` is not supported as a key in dictionaries";
         throw InterpreterException(msg);
@@ -1470,6 +1647,7 @@ eval_expr_term_case(ExprCase *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
 ER
 eval_expr_term(ExprTerm *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
+    ALLOC_STATS_SITE(alloc_stats::term_site(expr->get_term_type()));
     switch (expr->get_term_type()) {
     case ExprTermType::Ident:         return eval_expr_term_ident(dynamic_cast<ExprIdent *>(expr), ctx, ref);
     case ExprTermType::Int_Literal:   return eval_expr_term_intlit(dynamic_cast<ExprIntLit *>(expr));
@@ -1588,9 +1766,11 @@ Interpreter::eval_expr(Expr *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
         return eval_expr_term(dynamic_cast<ExprTerm *>(expr), ctx, ref);
     } break;
     case ExprType::Binary: {
+        ALLOC_STATS_SITE(alloc_stats::expr_site(ExprType::Binary));
         return eval_expr_bin(dynamic_cast<ExprBinary *>(expr), ctx, ref);
     } break;
     case ExprType::Unary: {
+        ALLOC_STATS_SITE(alloc_stats::expr_site(ExprType::Unary));
         return eval_expr_unary(dynamic_cast<ExprUnary *>(expr), ctx, ref);
     } break;
     default:
@@ -1656,11 +1836,13 @@ Interpreter::typecheck(__Type *ty, earl::value::Obj *value, std::shared_ptr<Ctx>
     else if (tyname == COMMON_EARLTY_CLOSURE && value->type() == earl::value::Type::Closure) return;
     else if (tyname == COMMON_EARLTY_OPTION && value->type() == earl::value::Type::Option)   return;
     else if (tyname == COMMON_EARLTY_SLICE && value->type() == earl::value::Type::Slice)     return;
+    else if (tyname == COMMON_EARLTY_BYTES && value->type() == earl::value::Type::Bytes)     return;
     else if (tyname == COMMON_EARLTY_DICT
              && (value->type() == earl::value::Type::DictInt
                  || value->type() == earl::value::Type::DictStr
                  || value->type() == earl::value::Type::DictFloat
-                 || value->type() == earl::value::Type::DictChar))                           return;
+                 || value->type() == earl::value::Type::DictChar
+                 || value->type() == earl::value::Type::DictAny))                            return;
     else if (tyname == COMMON_EARLTY_TYPE && value->type() == earl::value::Type::TypeKW)     return;
     else if (tyname == COMMON_EARLTY_REAL
              && (value->type() == earl::value::Type::Int
@@ -2127,12 +2309,24 @@ reset_enumerators(std::vector<std::shared_ptr<earl::variable::Obj>> &vars,
 
 std::shared_ptr<earl::value::Obj>
 eval_stmt_foreach(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx) {
+    if (stmt->m_bash_lines)
+        return eval_stmt_foreach_bash_lines(stmt, ctx);
+
     bool ref = (stmt->m_attrs & static_cast<uint32_t>(Attr::Ref)) != 0;
 
     std::shared_ptr<earl::value::Obj> result = nullptr;
     ER expr_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, ref);
     auto expr = unpack_ER(expr_er, ctx, ref);
 
+    // Files are read one line at a time instead of all at once.
+    if (expr->type() == earl::value::Type::File) {
+        auto file = std::dynamic_pointer_cast<earl::value::File>(expr);
+        bool exhausted = false;
+        return eval_stmt_foreach_lines(stmt, ctx, [&](std::string &line) {
+            return file->next_line(line);
+        }, exhausted);
+    }
+
     for (auto &enumer : stmt->m_enumerators) {
         const std::string &id = enumer->lexeme();
         if (ctx->variable_exists(id)) {
@@ -2156,11 +2350,18 @@ eval_stmt_foreach(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx) {
                           std::is_same_v<T, earl::value::StrIterator>) {
                 handle_enumerators(*it);
             }
+            else if constexpr (std::is_same_v<T, earl::value::SetIterator>) {
+                // Set elements are hashed, so never hand out the
+                // originals for the loop body to mutate.
+                auto element = (*it)->copy();
+                handle_enumerators(element);
+            }
             else {
                 static_assert(std::is_same_v<T, earl::value::DictIntIterator> ||
                               std::is_same_v<T, earl::value::DictCharIterator> ||
                               std::is_same_v<T, earl::value::DictFloatIterator> ||
-                              std::is_same_v<T, earl::value::DictStrIterator>);
+                              std::is_same_v<T, earl::value::DictStrIterator> ||
+                              std::is_same_v<T, earl::value::DictAnyIterator>);
                 std::vector<std::shared_ptr<earl::value::Obj>> elements = {};
                 if constexpr (std::is_same_v<T, earl::value::DictIntIterator>)
                     elements.push_back(std::make_shared<earl::value::Int>(it->first));
@@ -2170,6 +2371,8 @@ eval_stmt_foreach(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx) {
                     elements.push_back(std::make_shared<earl::value::Float>(it->first));
                 else if constexpr (std::is_same_v<T, earl::value::DictStrIterator>)
                     elements.push_back(std::make_shared<earl::value::Str>(it->first));
+                else if constexpr (std::is_same_v<T, earl::value::DictAnyIterator>)
+                    elements.push_back(it->first.value->copy());
                 else {
                     Err::err_wexpr(stmt->m_expr.get());
                     const std::string msg = "unknown dictionary iterator type";
@@ -2332,6 +2535,8 @@ eval_stmt_import(StmtImport *stmt, std::shared_ptr<Ctx> &ctx) {
     PackedERPreliminary perp;
     auto path_obj                     = unpack_ER(path_er, ctx, &perp);
     std::string path                  = path_obj->to_cxxstring();
+    timing::Scope timer(timing::Phase::Import, path);
+    trace::Span span("import", path);
     std::string src_code              = read_file(path.c_str(), config::prelude::include::dirs);
     std::unique_ptr<Lexer> lexer      = lex_file(src_code,
                                                  path,
@@ -2557,17 +2762,33 @@ eval_stmt_loop(StmtLoop *stmt, std::shared_ptr<Ctx> &ctx) {
 }
 
 static void
-system_bash(const std::string &cmd) {
+check_bash_status(int x);
+
+static void
+system_bash(const std::string &cmd, const Token *site) {
     if ((config::runtime::flags & __SHOWBASH) != 0)
         std::cout << "+ " << cmd << std::endl;
 
+    // `set -e` changes nothing for a single simple command, so only
+    // add it when the command needs the shell anyway.
+    std::vector<std::string> words;
     std::string full_command = "";
-    if ((config::runtime::flags & __ERROR_ON_BASH_FAIL) != 0)
+    if ((config::runtime::flags & __ERROR_ON_BASH_FAIL) != 0 && !process::split_simple(cmd, words))
         full_command = "set -e; " + cmd;
     else
         full_command = std::string(cmd);
 
-    int x = system(full_command.c_str());
+    trace::Span span("shell", cmd);
+    int64_t start = shell_stats::start();
+    int status = process::run(full_command);
+    shell_stats::finish(start, cmd, site, status, 0);
+    span.status(status);
+
+    check_bash_status(status);
+}
+
+static void
+check_bash_status(int x) {
     if (x == -1)
         goto warn;
 
@@ -2597,33 +2818,139 @@ ok:
     return;
 }
 
+// Runs the body of `stmt` once for every line that `next` gives.
+static std::shared_ptr<earl::value::Obj>
+eval_stmt_foreach_lines(StmtForeach *stmt,
+                        std::shared_ptr<Ctx> &ctx,
+                        const std::function<bool(std::string &)> &next,
+                        bool &exhausted) {
+    if (stmt->m_enumerators.size() != 1) {
+        Err::err_wexpr(stmt->m_expr.get());
+        const std::string msg = "a `foreach` over lines takes exactly one enumerator";
+        throw InterpreterException(msg);
+    }
+
+    auto &enumer = stmt->m_enumerators[0];
+    if (ctx->variable_exists(enumer->lexeme())) {
+        std::string msg = "variable `"+enumer->lexeme()+"` is already declared";
+        auto conflict = ctx->variable_get(enumer->lexeme());
+        Err::err_wconflict(enumer.get(), conflict->gettok());
+        throw InterpreterException(msg);
+    }
+
+    std::shared_ptr<earl::value::Obj> result = nullptr;
+    std::vector<std::shared_ptr<earl::variable::Obj>> enumerators(1, nullptr);
+    std::string line = "";
+    exhausted = false;
+
+    while (true) {
+        if (!next(line)) {
+            exhausted = true;
+            break;
+        }
+
+        auto value = std::make_shared<earl::value::Str>(line);
+        if (!enumerators[0]) {
+            destructure_enumerators(stmt->m_enumerators, enumerators, value, stmt->m_attrs, stmt->m_expr.get());
+            ctx->variable_add(enumerators[0]);
+        }
+        else
+            reset_enumerators(enumerators, value, stmt->m_expr.get());
+
+        result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
+
+        if (result && result->type() == earl::value::Type::Break) {
+            result = nullptr;
+            break;
+        }
+        if (result && result->type() == earl::value::Type::Continue)
+            continue;
+        if (result && result->type() != earl::value::Type::Void)
+            break;
+    }
+
+    if (enumerators[0])
+        ctx->variable_remove(enumerators[0]->id());
+
+    if (result && (result->type() == earl::value::Type::Continue || result->type() == earl::value::Type::Break))
+        result = std::make_shared<earl::value::Void>();
+
+    stmt->m_evald = true;
+    return result;
+}
+
+static std::shared_ptr<earl::value::Obj>
+eval_stmt_foreach_bash_lines(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx) {
+    ER cmd_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, false);
+    const std::string cmd = unpack_ER(cmd_er, ctx, false)->to_cxxstring();
+
+    if ((config::runtime::flags & __SHOWBASH) != 0)
+        std::cout << "+ " << cmd << std::endl;
+
+    trace::Span span("shell", cmd);
+    const Token *site = stmt->m_enumerators.empty() ? nullptr : stmt->m_enumerators[0].get();
+    int64_t start = shell_stats::start();
+    size_t bytes = 0;
+    process::LineReader reader(cmd);
+    if (!reader.ok()) {
+        shell_stats::finish(start, cmd, site, -1, 0);
+        Err::err_wexpr(stmt->m_expr.get());
+        throw InterpreterException("failed to execute bash `"+cmd+"`");
+    }
+
+    bool exhausted = false;
+    auto result = eval_stmt_foreach_lines(stmt, ctx, [&](std::string &line) {
+        if (!reader.next(line))
+            return false;
+        bytes += line.size()+1;
+        return true;
+    }, exhausted);
+
+    // Leaving the loop early kills the command, so its status
+    // says nothing about whether it worked.
+    if (exhausted) {
+        int status = reader.finish();
+        shell_stats::finish(start, cmd, site, status, bytes);
+        span.status(status);
+        check_bash_status(status);
+    }
+    else
+        shell_stats::finish(start, cmd, site, 0, bytes);
+
+    return result;
+}
+
 static std::shared_ptr<earl::value::Obj>
 eval_stmt_bash_lit(StmtBashLiteral *stmt, std::shared_ptr<Ctx> ctx) {
     ER bash_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, false);
     auto bash = unpack_ER(bash_er, ctx, false, nullptr);
-    system_bash(bash->to_cxxstring());
+    system_bash(bash->to_cxxstring(), stmt->m_tok.get());
     return std::make_shared<earl::value::Void>();
 }
 
 static std::shared_ptr<earl::value::Obj>
 eval_stmt_pipe(StmtPipe *stmt, std::shared_ptr<Ctx> ctx) {
+    const Token *site = std::visit([](auto &&cmd) -> const Token * {
+        using T = std::decay_t<decltype(cmd)>;
+        if constexpr (std::is_same_v<T, std::unique_ptr<StmtBashLiteral>>)
+            return cmd->m_tok.get();
+        else
+            return cmd->m_ident.get();
+    }, stmt->m_bash);
+
     auto get_bash_res = [&](std::string cmd, Stmt *stmt) {
         bool sanatize = (config::runtime::flags & __NO_SANITIZE_PIPES) == 0;
         std::string output = "";
-        std::array<char, 256> buffer;
-        FILE *pipe = popen(cmd.c_str(), "r");
-        if (!pipe) {
+        trace::Span span("shell", cmd);
+        int64_t start = shell_stats::start();
+        int ec = process::run_capture(cmd, output);
+        shell_stats::finish(start, cmd, site, ec, output.size());
+        span.status(ec);
+        span.arg("bytes", static_cast<int64_t>(output.size()));
+        if (ec == -1) {
             Err::err_wstmt(stmt);
             throw InterpreterException("failed to execute bash `"+cmd+"`");
         }
-        while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-            output += buffer.data();
-        }
-        int ec = pclose(pipe);
-        if (ec == -1) {
-            const std::string msg = "command `"+cmd+"` failed to exit";
-            throw InterpreterException(msg);
-        }
         if (sanatize && output.size() > 1
             && (output.back() == ' '
                 || output.back() == '\n'
@@ -2716,7 +3043,7 @@ static std::shared_ptr<earl::value::Obj>
 eval_stmt_multiline_bash(StmtMultilineBash *stmt, std::shared_ptr<Ctx> &ctx) {
     std::string cmd = stmt->m_sh->lexeme();
 
-    system_bash(cmd);
+    system_bash(cmd, stmt->m_sh.get());
 
     stmt->m_evald = true;
     return std::make_shared<earl::value::Void>();
@@ -2756,7 +3083,7 @@ eval_stmt_use(StmtUse *stmt, std::shared_ptr<Ctx> &ctx) {
     }
     // No alias found, execute now.
     else
-        system_bash(path);
+        system_bash(path, nullptr);
 
     stmt->m_evald = true;
     return std::make_shared<earl::value::Void>();
@@ -2767,7 +3094,7 @@ eval_stmt_exec(StmtExec *stmt, std::shared_ptr<Ctx> &ctx) {
     auto world = ctx->get_world();
     const std::string &script_path = world->get_external_script_path(stmt->m_ident->lexeme(), stmt);
 
-    system_bash(script_path);
+    system_bash(script_path, stmt->m_ident.get());
 
     stmt->m_evald = true;
     return std::make_shared<earl::value::Void>();
@@ -2864,6 +3191,9 @@ eval_stmt_try(StmtTry *stmt, std::shared_ptr<Ctx> ctx) {
 
 std::shared_ptr<earl::value::Obj>
 Interpreter::eval_stmt(Stmt *stmt, std::shared_ptr<Ctx> &ctx) {
+    profiler::LineScope prof(stmt->m_line);
+    ALLOC_STATS_SITE(alloc_stats::stmt_site(stmt->stmt_type()));
+    metrics::count(metrics::statements);
     switch (stmt->stmt_type()) {
     case StmtType::Def:             return eval_stmt_def(dynamic_cast<StmtDef *>(stmt), ctx);
     case StmtType::Let:             return eval_stmt_let(dynamic_cast<StmtLet *>(stmt), ctx);
@@ -2905,6 +3235,9 @@ import_cli_import_files(std::shared_ptr<Ctx> &ctx) {
     while (cli_import_copy.size() > 0) {
         auto f = cli_import_copy.at(0);
         cli_import_copy.erase(cli_import_copy.begin());
+        timing::Scope timer(timing::Phase::Import, f);
+        trace::Span span("import", f);
+        span.arg("from", std::string("command line"));
 
         if ((config::runtime::flags & __VERBOSE) != 0)
             std::cout << "[EARL] importing file `" << f << "` from command line flag" << std::endl;
@@ -31,7 +31,11 @@
 #include <filesystem>
 #include <ctime>
 #include <unistd.h>
+#include <sys/wait.h>
 #include <random>
+#include <thread>
+#include <cmath>
+#include <numeric>
 #include <variant>
 
 #include "intrinsics.hpp"
@@ -41,6 +45,12 @@
 #include "mem-file.hpp"
 #include "common.hpp"
 #include "repl.hpp"
+#include "process.hpp"
+#include "event-loop.hpp"
+#include "output.hpp"
+#include "walk.hpp"
+#include "alloc-stats.hpp"
+#include "trace.hpp"
 
 const std::unordered_map<std::string, Intrinsics::IntrinsicFunction>
 Intrinsics::intrinsic_functions = {
@@ -52,11 +62,13 @@ Intrinsics::intrinsic_functions = {
     {"flush", &Intrinsics::intrinsic_flush},
     {"unset_flag", &Intrinsics::intrinsic_unset_flag},
     {"set_flag", &Intrinsics::intrinsic_set_flag},
+    {"__internal_set_stdout_buffer__", &Intrinsics::intrinsic___internal_set_stdout_buffer__},
     {"sin", &Intrinsics::intrinsic_sin},
     {"cos", &Intrinsics::intrinsic_cos},
     {"help", &Intrinsics::intrinsic_help},
     {"print", &Intrinsics::intrinsic_print},
     {"println", &Intrinsics::intrinsic_println},
+    {"__internal_print_all__", &Intrinsics::intrinsic___internal_print_all__},
     {"assert", &Intrinsics::intrinsic_assert},
     {"len", &Intrinsics::intrinsic_len},
     {"copy", &Intrinsics::intrinsic_copy},
@@ -77,9 +89,25 @@ Intrinsics::intrinsic_functions = {
     {"__internal_move__", &Intrinsics::intrinsic___internal_move__},
     {"__internal_mkdir__", &Intrinsics::intrinsic___internal_mkdir__},
     {"__internal_ls__", &Intrinsics::intrinsic___internal_ls__},
+    {"__internal_walk__", &Intrinsics::intrinsic___internal_walk__},
+    {"__stats__", &Intrinsics::intrinsic___stats__},
+    {"__internal_bytes__", &Intrinsics::intrinsic___internal_bytes__},
     {"cd", &Intrinsics::intrinsic_cd},
     {"__internal_unix_system__", &Intrinsics::intrinsic___internal_unix_system__},
     {"__internal_unix_system_woutput__", &Intrinsics::intrinsic___internal_unix_system_woutput__},
+    {"__internal_pipeline__", &Intrinsics::intrinsic___internal_pipeline__},
+    {"__internal_await__", &Intrinsics::intrinsic___internal_await__},
+    {"__internal_await_all__", &Intrinsics::intrinsic___internal_await_all__},
+    {"__internal_await_any__", &Intrinsics::intrinsic___internal_await_any__},
+    {"__internal_timer__", &Intrinsics::intrinsic___internal_timer__},
+    {"__internal_fd_readable__", &Intrinsics::intrinsic___internal_fd_readable__},
+    {"__internal_bash_async__", &Intrinsics::intrinsic___internal_bash_async__},
+    {"__internal_gcd__", &Intrinsics::intrinsic___internal_gcd__},
+    {"__internal_lcm__", &Intrinsics::intrinsic___internal_lcm__},
+    {"__internal_powmod__", &Intrinsics::intrinsic___internal_powmod__},
+    {"__internal_pow__", &Intrinsics::intrinsic___internal_pow__},
+    {"__internal_floor__", &Intrinsics::intrinsic___internal_floor__},
+    {"__internal_ceil__", &Intrinsics::intrinsic___internal_ceil__},
     {"fprintln", &Intrinsics::intrinsic_fprintln},
     {"fprint", &Intrinsics::intrinsic_fprint},
     // Casting Functions
@@ -91,6 +119,11 @@ Intrinsics::intrinsic_functions = {
     {"list", &Intrinsics::intrinsic_list},
     {"unit", &Intrinsics::intrinsic_unit},
     {"Dict", &Intrinsics::intrinsic_Dict},
+    {"__internal_set__", &Intrinsics::intrinsic___internal_set__},
+    {"__internal_deque__", &Intrinsics::intrinsic___internal_deque__},
+    {"__internal_priority_queue__", &Intrinsics::intrinsic___internal_priority_queue__},
+    {"__internal_matrix__", &Intrinsics::intrinsic___internal_matrix__},
+    {"__internal_procpool__", &Intrinsics::intrinsic___internal_procpool__},
     {"datetime", &Intrinsics::intrinsic_datetime},
     {"sleep", &Intrinsics::intrinsic_sleep},
     {"env", &Intrinsics::intrinsic_env},
@@ -122,6 +155,10 @@ Intrinsics::intrinsic_member_functions = {
     {"read", &Intrinsics::intrinsic_member_read},
     {"write", &Intrinsics::intrinsic_member_write},
     {"writelines", &Intrinsics::intrinsic_member_writelines},
+    {"lines", &Intrinsics::intrinsic_member_lines},
+    {"flush", &Intrinsics::intrinsic_member_flush},
+    {"read_bytes", &Intrinsics::intrinsic_member_read_bytes},
+    {"write_bytes", &Intrinsics::intrinsic_member_write_bytes},
     // Char
     {"ascii", &Intrinsics::intrinsic_member_ascii},
     {"islower", &Intrinsics::intrinsic_member_islower},
@@ -140,6 +177,43 @@ Intrinsics::intrinsic_member_functions = {
     {"has_key", &Intrinsics::intrinsic_member_has_key},
     {"has_value", &Intrinsics::intrinsic_member_has_value},
     {"empty", &Intrinsics::intrinsic_member_empty},
+    // Set
+    {"remove", &Intrinsics::intrinsic_member_remove},
+    {"union", &Intrinsics::intrinsic_member_union},
+    {"intersection", &Intrinsics::intrinsic_member_intersection},
+    {"difference", &Intrinsics::intrinsic_member_difference},
+    // Deque
+    {"push_back", &Intrinsics::intrinsic_member_push_back},
+    {"push_front", &Intrinsics::intrinsic_member_push_front},
+    {"pop_back", &Intrinsics::intrinsic_member_pop_back},
+    {"pop_front", &Intrinsics::intrinsic_member_pop_front},
+    {"front", &Intrinsics::intrinsic_member_front},
+    // PriorityQueue
+    {"push", &Intrinsics::intrinsic_member_push},
+    {"top", &Intrinsics::intrinsic_member_top},
+    // Matrix
+    {"at", &Intrinsics::intrinsic_member_at},
+    {"set", &Intrinsics::intrinsic_member_set},
+    {"rows", &Intrinsics::intrinsic_member_rows},
+    {"cols", &Intrinsics::intrinsic_member_cols},
+    {"transpose", &Intrinsics::intrinsic_member_transpose},
+    {"matmul", &Intrinsics::intrinsic_member_matmul},
+    {"to_list", &Intrinsics::intrinsic_member_to_list},
+    // ProcPool
+    {"spawn", &Intrinsics::intrinsic_member_spawn},
+    {"wait", &Intrinsics::intrinsic_member_wait},
+    {"wait_any", &Intrinsics::intrinsic_member_wait_any},
+    {"wait_all", &Intrinsics::intrinsic_member_wait_all},
+    {"pending", &Intrinsics::intrinsic_member_pending},
+    // Task
+    {"done", &Intrinsics::intrinsic_member_done},
+    // Bytes
+    {"find", &Intrinsics::intrinsic_member_find},
+    {"hex", &Intrinsics::intrinsic_member_hex},
+    {"int_le", &Intrinsics::intrinsic_member_int_le},
+    {"int_be", &Intrinsics::intrinsic_member_int_be},
+    {"crc32", &Intrinsics::intrinsic_member_crc32},
+    {"decode", &Intrinsics::intrinsic_member_decode},
     // Bool
     {"ifelse", &Intrinsics::intrinsic_member_ifelse},
     {"toggle", &Intrinsics::intrinsic_member_toggle},
@@ -185,8 +259,16 @@ Intrinsics::is_member_intrinsic(const std::string &id, int ty) {
     case earl::value::Type::DictInt:
     case earl::value::Type::DictStr:
     case earl::value::Type::DictChar:
-    case earl::value::Type::DictFloat: return Intrinsics::intrinsic_dict_member_functions.find(id)   != Intrinsics::intrinsic_dict_member_functions.end();
+    case earl::value::Type::DictFloat:
+    case earl::value::Type::DictAny:   return Intrinsics::intrinsic_dict_member_functions.find(id)   != Intrinsics::intrinsic_dict_member_functions.end();
     case earl::value::Type::Time:      return Intrinsics::intrinsic_time_member_functions.find(id)   != Intrinsics::intrinsic_time_member_functions.end();
+    case earl::value::Type::Set:       return Intrinsics::intrinsic_set_member_functions.find(id)    != Intrinsics::intrinsic_set_member_functions.end();
+    case earl::value::Type::Deque:     return Intrinsics::intrinsic_deque_member_functions.find(id)  != Intrinsics::intrinsic_deque_member_functions.end();
+    case earl::value::Type::PriorityQueue: return Intrinsics::intrinsic_priorityqueue_member_functions.find(id) != Intrinsics::intrinsic_priorityqueue_member_functions.end();
+    case earl::value::Type::Matrix:    return Intrinsics::intrinsic_matrix_member_functions.find(id) != Intrinsics::intrinsic_matrix_member_functions.end();
+    case earl::value::Type::ProcPool:  return Intrinsics::intrinsic_procpool_member_functions.find(id) != Intrinsics::intrinsic_procpool_member_functions.end();
+    case earl::value::Type::Task:      return Intrinsics::intrinsic_task_member_functions.find(id) != Intrinsics::intrinsic_task_member_functions.end();
+    case earl::value::Type::Bytes:     return Intrinsics::intrinsic_bytes_member_functions.find(id) != Intrinsics::intrinsic_bytes_member_functions.end();
     default: return false;
     }
     return Intrinsics::intrinsic_member_functions.find(id) != Intrinsics::intrinsic_member_functions.end();
@@ -212,8 +294,16 @@ Intrinsics::call_member(const std::string &id,
     case earl::value::Type::DictInt:
     case earl::value::Type::DictStr:
     case earl::value::Type::DictChar:
-    case earl::value::Type::DictFloat: return Intrinsics::intrinsic_dict_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::DictFloat:
+    case earl::value::Type::DictAny:   return Intrinsics::intrinsic_dict_member_functions.at(id)(accessor, params, ctx, expr);
     case earl::value::Type::Time:      return Intrinsics::intrinsic_time_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Set:       return Intrinsics::intrinsic_set_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Deque:     return Intrinsics::intrinsic_deque_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::PriorityQueue: return Intrinsics::intrinsic_priorityqueue_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Matrix:    return Intrinsics::intrinsic_matrix_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::ProcPool:  return Intrinsics::intrinsic_procpool_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Task:      return Intrinsics::intrinsic_task_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Bytes:     return Intrinsics::intrinsic_bytes_member_functions.at(id)(accessor, params, ctx, expr);
     default: assert(false);
     }
 }
@@ -244,16 +334,25 @@ Intrinsics::intrinsic_int(std::vector<std::shared_ptr<earl::value::Obj>> &params
     }
     switch (params[0]->type()) {
     case earl::value::Type::Int: {
-        int i = dynamic_cast<earl::value::Int *>(params[0].get())->value();
-        return std::make_shared<earl::value::Int>(i);
+        return params[0]->copy();
     } break;
     case earl::value::Type::Float: {
         double f = dynamic_cast<earl::value::Float *>(params[0].get())->value();
-        return std::make_shared<earl::value::Int>(static_cast<int>(f));
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(f));
     } break;
     case earl::value::Type::Str: {
         std::string s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
-        return std::make_shared<earl::value::Int>(std::stoi(s));
+        try {
+            return std::make_shared<earl::value::Int>(static_cast<int64_t>(std::stoll(s)));
+        }
+        catch (const std::out_of_range &) {
+            // Too large for 64 bits, but only a plain decimal
+            // string can become a big integer.
+            size_t start = !s.empty() && (s[0] == '-' || s[0] == '+');
+            if (start == s.size() || s.find_first_not_of("0123456789", start) != std::string::npos)
+                throw;
+            return std::make_shared<earl::value::Int>(BigInt::from_str(s));
+        }
     } break;
     case earl::value::Type::Char: {
         char c = dynamic_cast<earl::value::Char *>(params[0].get())->value();
@@ -288,8 +387,8 @@ Intrinsics::intrinsic_float(std::vector<std::shared_ptr<earl::value::Obj>> &para
     }
     switch (params[0]->type()) {
     case earl::value::Type::Int: {
-        int i = dynamic_cast<earl::value::Int *>(params[0].get())->value();
-        return std::make_shared<earl::value::Float>(static_cast<double>(i));
+        double f = dynamic_cast<earl::value::Int *>(params[0].get())->as_double();
+        return std::make_shared<earl::value::Float>(f);
     } break;
     case earl::value::Type::Float: {
         double f = dynamic_cast<earl::value::Float *>(params[0].get())->value();
@@ -297,7 +396,7 @@ Intrinsics::intrinsic_float(std::vector<std::shared_ptr<earl::value::Obj>> &para
     } break;
     case earl::value::Type::Str: {
         std::string s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
-        return std::make_shared<earl::value::Float>(std::stof(s));
+        return std::make_shared<earl::value::Float>(std::stod(s));
     } break;
     default: {
         Err::err_wexpr(expr);
@@ -324,8 +423,8 @@ Intrinsics::intrinsic_bool(std::vector<std::shared_ptr<earl::value::Obj>> &param
     }
     switch (params[0]->type()) {
     case earl::value::Type::Int: {
-        int i = dynamic_cast<earl::value::Int *>(params[0].get())->value();
-        return std::make_shared<earl::value::Bool>(static_cast<bool>(i));
+        int64_t i = dynamic_cast<earl::value::Int *>(params[0].get())->value();
+        return std::make_shared<earl::value::Bool>(i != 0);
     } break;
     case earl::value::Type::Float: {
         double f = dynamic_cast<earl::value::Float *>(params[0].get())->value();
@@ -379,17 +478,28 @@ Intrinsics::intrinsic_Dict(std::vector<std::shared_ptr<earl::value::Obj>> &param
                            std::shared_ptr<Ctx> &ctx,
                            Expr *expr) {
     (void)ctx;
-    __INTR_ARGS_MUSTBE_SIZE(params, 1, "Dict", expr);
+    if (params.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `Dict` expects 0 or 1 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    // No key type, the dictionary accepts any hashable key.
+    if (params.size() == 0)
+        return std::make_shared<earl::value::Dict<earl::value::DictKey>>(earl::value::Type::DictAny);
+
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::TypeKW, 1, "Dict", expr);
 
     auto value = dynamic_cast<earl::value::TypeKW *>(params[0].get());
     earl::value::Type ty = value->ty();
 
     switch (ty) {
-    case earl::value::Type::Int: return std::make_shared<earl::value::Dict<int>>(ty);
+    case earl::value::Type::Int: return std::make_shared<earl::value::Dict<int64_t>>(ty);
     case earl::value::Type::Str: return std::make_shared<earl::value::Dict<std::string>>(ty);
     case earl::value::Type::Char: return std::make_shared<earl::value::Dict<char>>(ty);
-    case earl::value::Type::Float: return std::make_shared<earl::value::Dict<float>>(ty);
+    case earl::value::Type::Float: return std::make_shared<earl::value::Dict<double>>(ty);
+    case earl::value::Type::Bool:
+    case earl::value::Type::Tuple: return std::make_shared<earl::value::Dict<earl::value::DictKey>>(earl::value::Type::DictAny);
     default: {
         Err::err_wexpr(expr);
         const std::string msg = "cannot create an empty dictionary of type `"+earl::value::type_to_str(ty)+"` (unsupported)";
@@ -401,6 +511,158 @@ Intrinsics::intrinsic_Dict(std::vector<std::shared_ptr<earl::value::Obj>> &param
     return nullptr; // unreachable
 }
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_set__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    if (params.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_set__` expects 0 or 1 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    auto set = std::make_shared<earl::value::Set>();
+    if (params.size() == 1) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_OR(params[0], earl::value::Type::List, earl::value::Type::Tuple, 1, "__internal_set__", expr);
+        auto &values = params[0]->type() == earl::value::Type::List
+            ? dynamic_cast<earl::value::List *>(params[0].get())->value()
+            : dynamic_cast<earl::value::Tuple *>(params[0].get())->value();
+        for (auto &v : values)
+            set->insert(v, expr);
+    }
+    return set;
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_deque__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    if (params.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_deque__` expects 0 or 1 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    if (params.size() == 0)
+        return std::make_shared<earl::value::Deque>();
+
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_OR(params[0], earl::value::Type::List, earl::value::Type::Tuple, 1, "__internal_deque__", expr);
+    auto &values = params[0]->type() == earl::value::Type::List
+        ? dynamic_cast<earl::value::List *>(params[0].get())->value()
+        : dynamic_cast<earl::value::Tuple *>(params[0].get())->value();
+    return std::make_shared<earl::value::Deque>(values);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_priority_queue__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                                  std::shared_ptr<Ctx> &ctx,
+                                                  Expr *expr) {
+    (void)ctx;
+    if (params.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_priority_queue__` expects 0 or 1 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    if (params.size() == 0)
+        return std::make_shared<earl::value::PriorityQueue>();
+
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Closure, 1, "__internal_priority_queue__", expr);
+    return std::make_shared<earl::value::PriorityQueue>(std::dynamic_pointer_cast<earl::value::Closure>(params[0]));
+}
+
+static double
+matrix_element(std::shared_ptr<earl::value::Obj> &elem, Expr *expr) {
+    if (elem->type() == earl::value::Type::Int)
+        return static_cast<double>(dynamic_cast<earl::value::Int *>(elem.get())->value());
+    if (elem->type() == earl::value::Type::Float)
+        return dynamic_cast<earl::value::Float *>(elem.get())->value();
+    Err::err_wexpr(expr);
+    const std::string msg = "matrix elements must be of type `int` or `float` but got `"+earl::value::type_to_str(elem->type())+"`";
+    throw InterpreterException(msg);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_matrix__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                          std::shared_ptr<Ctx> &ctx,
+                                          Expr *expr) {
+    (void)ctx;
+    if (params.size() != 2 && params.size() != 3) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_matrix__` expects 2 or 3 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_matrix__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::Int, 2, "__internal_matrix__", expr);
+    int64_t rows = dynamic_cast<earl::value::Int *>(params[0].get())->value();
+    int64_t cols = dynamic_cast<earl::value::Int *>(params[1].get())->value();
+    if (rows < 0 || cols < 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_matrix__` expects non-negative dimensions but got "+std::to_string(rows)+"x"+std::to_string(cols);
+        throw InterpreterException(msg);
+    }
+    if (cols != 0 && static_cast<uint64_t>(rows) > SIZE_MAX/sizeof(double)/static_cast<uint64_t>(cols)) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_matrix__` cannot allocate a "+std::to_string(rows)+"x"+std::to_string(cols)+" matrix";
+        throw InterpreterException(msg);
+    }
+
+    if (params.size() == 2)
+        return std::make_shared<earl::value::Matrix>(rows, cols);
+
+    // Accept both a flat list of rows*cols elements and a list of rows.
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[2], earl::value::Type::List, 3, "__internal_matrix__", expr);
+    auto &init = dynamic_cast<earl::value::List *>(params[2].get())->value();
+    std::vector<double> data;
+    data.reserve(static_cast<size_t>(rows)*cols);
+    for (auto &elem : init) {
+        if (elem->type() == earl::value::Type::List) {
+            for (auto &e : dynamic_cast<earl::value::List *>(elem.get())->value())
+                data.push_back(matrix_element(e, expr));
+        }
+        else
+            data.push_back(matrix_element(elem, expr));
+    }
+
+    if (data.size() != static_cast<size_t>(rows)*cols) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_matrix__` expects "+std::to_string(rows*cols)+" elements for a "
+            +std::to_string(rows)+"x"+std::to_string(cols)+" matrix but got "+std::to_string(data.size());
+        throw InterpreterException(msg);
+    }
+
+    return std::make_shared<earl::value::Matrix>(rows, cols, std::move(data));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_procpool__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                            std::shared_ptr<Ctx> &ctx,
+                                            Expr *expr) {
+    (void)ctx;
+    if (params.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_procpool__` expects 0 or 1 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    if (params.size() == 0) {
+        size_t ncpus = std::thread::hardware_concurrency();
+        return std::make_shared<earl::value::ProcPool>(ncpus == 0 ? 1 : ncpus);
+    }
+
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_procpool__", expr);
+    int64_t limit = dynamic_cast<earl::value::Int *>(params[0].get())->value();
+    if (limit <= 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_procpool__` expects a positive limit but got "+std::to_string(limit);
+        throw InterpreterException(msg);
+    }
+    return std::make_shared<earl::value::ProcPool>(static_cast<size_t>(limit));
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_REPL_input(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                                  std::shared_ptr<Ctx> &ctx,
@@ -442,6 +704,8 @@ Intrinsics::intrinsic_persist(std::vector<std::shared_ptr<earl::value::Obj>> &pa
     __INTR_ARGS_MUSTBE_SIZE(params, 2, "persist", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "persist", expr);
 
+    load_mem_file();
+
     std::string id = params[0]->to_cxxstring();
     std::string value = params[1]->to_cxxstring();
 
@@ -460,6 +724,8 @@ Intrinsics::intrinsic_persist_lookup(std::vector<std::shared_ptr<earl::value::Ob
     __INTR_ARGS_MUSTBE_SIZE(params, 1, "persist_lookup", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "persist_lookup", expr);
 
+    load_mem_file();
+
     const std::string &id = dynamic_cast<earl::value::Str *>(params.at(0).get())->value();
 
     if (config::runtime::persistent_mem.find(id) == config::runtime::persistent_mem.end()) {
@@ -478,6 +744,8 @@ Intrinsics::intrinsic_persist_del(std::vector<std::shared_ptr<earl::value::Obj>>
     __INTR_ARGS_MUSTBE_SIZE(params, 1, "persist_lookup", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "persist_lookup", expr);
 
+    load_mem_file();
+
     const std::string &id = dynamic_cast<earl::value::Str *>(params.at(0).get())->value();
 
     auto it = config::runtime::persistent_mem.find(id);
@@ -505,6 +773,24 @@ Intrinsics::intrinsic_flush(std::vector<std::shared_ptr<earl::value::Obj>> &unus
 }
 
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_set_stdout_buffer__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                                     std::shared_ptr<Ctx> &ctx,
+                                                     Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_set_stdout_buffer__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "__internal_set_stdout_buffer__", expr);
+    output::Policy policy;
+    const std::string mode = params[0]->to_cxxstring();
+    if (!output::policy_from_str(mode, policy)) {
+        Err::err_wexpr(expr);
+        const std::string msg = "invalid stdout buffer mode `"+mode+"`, must be either auto|line|full|none";
+        throw InterpreterException(msg);
+    }
+    output::set_policy(policy);
+    return std::make_shared<earl::value::Void>();
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_unset_flag(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                                  std::shared_ptr<Ctx> &ctx,
@@ -597,7 +883,7 @@ Intrinsics::intrinsic_cos(std::vector<std::shared_ptr<earl::value::Obj>> &params
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Int, 1, "cos", expr);
     auto obj = params[0];
     if (obj->type() == earl::value::Type::Int) {
-        int value = dynamic_cast<earl::value::Int *>(obj.get())->value();
+        double value = dynamic_cast<earl::value::Int *>(obj.get())->as_double();
         return std::make_shared<earl::value::Float>(cos(value));
     }
     double value = dynamic_cast<earl::value::Float *>(obj.get())->value();
@@ -612,7 +898,7 @@ Intrinsics::intrinsic_sin(std::vector<std::shared_ptr<earl::value::Obj>> &params
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Int, 1, "sin", expr);
     auto obj = params[0];
     if (obj->type() == earl::value::Type::Int) {
-        int value = dynamic_cast<earl::value::Int *>(obj.get())->value();
+        double value = dynamic_cast<earl::value::Int *>(obj.get())->as_double();
         return std::make_shared<earl::value::Float>(sin(value));
     }
     double value = dynamic_cast<earl::value::Float *>(obj.get())->value();
@@ -626,21 +912,45 @@ Intrinsics::intrinsic_len(std::vector<std::shared_ptr<earl::value::Obj>> &params
     (void)ctx;
     __INTR_ARGS_MUSTBE_SIZE(params, 1, "len", expr);
     {
-        std::vector<earl::value::Type> lst = {earl::value::Type::List, earl::value::Type::Str, earl::value::Type::Tuple};
+        std::vector<earl::value::Type> lst = {
+            earl::value::Type::List,
+            earl::value::Type::Str,
+            earl::value::Type::Tuple,
+            earl::value::Type::Set,
+            earl::value::Type::Deque,
+            earl::value::Type::PriorityQueue,
+            earl::value::Type::Bytes,
+        };
         __MEMBER_INTR_ARG_MUSTBE_TYPE_COMPAT_OR_LST(params[0], lst, 1, "len", expr);
     }
     auto &item = params[0];
     if (item->type() == earl::value::Type::List) {
         size_t sz = dynamic_cast<earl::value::List *>(item.get())->value().size();
-        return std::make_shared<earl::value::Int>(static_cast<int>(sz));
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
     }
     else if (item->type() == earl::value::Type::Str) {
         size_t sz = dynamic_cast<earl::value::Str *>(item.get())->value().size();
-        return std::make_shared<earl::value::Int>(static_cast<int>(sz));
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
     }
     else if (item->type() == earl::value::Type::Tuple) {
         size_t sz = dynamic_cast<earl::value::Tuple *>(item.get())->value().size();
-        return std::make_shared<earl::value::Int>(static_cast<int>(sz));
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
+    }
+    else if (item->type() == earl::value::Type::Set) {
+        size_t sz = dynamic_cast<earl::value::Set *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
+    }
+    else if (item->type() == earl::value::Type::Deque) {
+        size_t sz = dynamic_cast<earl::value::Deque *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
+    }
+    else if (item->type() == earl::value::Type::PriorityQueue) {
+        size_t sz = dynamic_cast<earl::value::PriorityQueue *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
+    }
+    else if (item->type() == earl::value::Type::Bytes) {
+        size_t sz = dynamic_cast<earl::value::Bytes *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(sz));
     }
     assert(false && "unreachable");
     return nullptr;
@@ -719,6 +1029,149 @@ Intrinsics::intrinsic___internal_move__(std::vector<std::shared_ptr<earl::value:
     return std::make_shared<earl::value::Void>();
 }
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_bytes__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_bytes__", expr);
+    {
+        std::vector<earl::value::Type> tys = {
+            earl::value::Type::Str,
+            earl::value::Type::List,
+            earl::value::Type::Bytes,
+        };
+        __MEMBER_INTR_ARG_MUSTBE_TYPE_COMPAT_OR_LST(params[0], tys, 1, "__internal_bytes__", expr);
+    }
+
+    switch (params[0]->type()) {
+    case earl::value::Type::Bytes: {
+        return params[0]->copy();
+    } break;
+    case earl::value::Type::List: {
+        auto &elems = dynamic_cast<earl::value::List *>(params[0].get())->value();
+        std::vector<uint8_t> data;
+        data.reserve(elems.size());
+        for (size_t i = 0; i < elems.size(); ++i) {
+            int64_t b = -1;
+            if (elems[i]->type() == earl::value::Type::Int)
+                b = dynamic_cast<earl::value::Int *>(elems[i].get())->value();
+            if (b < 0 || b > 255) {
+                Err::err_wexpr(expr);
+                const std::string msg = "function `__internal_bytes__` expects a list of ints in 0..255 but element "
+                    +std::to_string(i)+" is `"+elems[i]->to_cxxstring()+"`";
+                throw InterpreterException(msg);
+            }
+            data.push_back(static_cast<uint8_t>(b));
+        }
+        return std::make_shared<earl::value::Bytes>(std::move(data));
+    } break;
+    default: {
+        // Str or Char
+        const std::string s = params[0]->to_cxxstring();
+        return std::make_shared<earl::value::Bytes>(std::vector<uint8_t>(s.begin(), s.end()));
+    } break;
+    }
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_walk__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                        std::shared_ptr<Ctx> &ctx,
+                                        Expr *expr) {
+    (void)ctx;
+    if (params.size() != 1 && params.size() != 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_walk__` expects 1 or 2 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "__internal_walk__", expr);
+
+    walk::Options opts;
+    if (params.size() == 2) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::DictStr, 2, "__internal_walk__", expr);
+        auto &map = dynamic_cast<earl::value::Dict<std::string> *>(params[1].get())->extract();
+
+        auto bad_option = [&](const std::string &key, const std::string &expected) {
+            Err::err_wexpr(expr);
+            const std::string msg = "`__internal_walk__` option `"+key+"` expects "+expected+" but got `"+earl::value::type_to_str(map.at(key)->type())+"`";
+            throw InterpreterException(msg);
+        };
+
+        for (auto &[key, value] : map) {
+            if (key == "ext") {
+                if (value->type() == earl::value::Type::Str)
+                    opts.exts.push_back(value->to_cxxstring());
+                else if (value->type() == earl::value::Type::List) {
+                    for (auto &ext : dynamic_cast<earl::value::List *>(value.get())->value()) {
+                        if (ext->type() != earl::value::Type::Str)
+                            bad_option(key, "a `str` or a list of `str`");
+                        opts.exts.push_back(ext->to_cxxstring());
+                    }
+                }
+                else
+                    bad_option(key, "a `str` or a list of `str`");
+                for (auto &ext : opts.exts)
+                    if (!ext.empty() && ext[0] == '.')
+                        ext.erase(0, 1);
+            }
+            else if (key == "glob") {
+                if (value->type() != earl::value::Type::Str)
+                    bad_option(key, "a `str`");
+                opts.glob = value->to_cxxstring();
+            }
+            else if (key == "max_depth") {
+                if (value->type() != earl::value::Type::Int)
+                    bad_option(key, "an `int`");
+                opts.max_depth = static_cast<int>(dynamic_cast<earl::value::Int *>(value.get())->value());
+            }
+            else if (key == "threads") {
+                if (value->type() != earl::value::Type::Int)
+                    bad_option(key, "an `int`");
+                int64_t n = dynamic_cast<earl::value::Int *>(value.get())->value();
+                if (n <= 0) {
+                    size_t ncpus = std::thread::hardware_concurrency();
+                    n = ncpus == 0 ? 1 : ncpus;
+                }
+                opts.threads = static_cast<size_t>(n);
+            }
+            else if (key == "dirs") {
+                if (value->type() != earl::value::Type::Bool)
+                    bad_option(key, "a `bool`");
+                opts.dirs = value->boolean();
+            }
+            else {
+                Err::err_wexpr(expr);
+                const std::string msg = "unknown `__internal_walk__` option `"+key+"`, expected one of ext|glob|max_depth|threads|dirs";
+                throw InterpreterException(msg);
+            }
+        }
+    }
+
+    std::vector<std::string> paths;
+    try {
+        paths = walk::walk(params[0]->to_cxxstring(), opts);
+    } catch (const std::runtime_error &e) {
+        Err::err_wexpr(expr);
+        const std::string msg = std::string("walk: ")+e.what();
+        throw InterpreterException(msg);
+    }
+
+    std::vector<std::shared_ptr<earl::value::Obj>> items = {};
+    items.reserve(paths.size());
+    for (auto &path : paths)
+        items.push_back(std::make_shared<earl::value::Str>(std::move(path)));
+    return std::make_shared<earl::value::List>(std::move(items));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___stats__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 0, "__stats__", expr);
+    return alloc_stats::to_dict();
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic___internal_ls__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                                       std::shared_ptr<Ctx> &ctx,
@@ -775,7 +1228,7 @@ Intrinsics::intrinsic___internal_unix_system__(std::vector<std::shared_ptr<earl:
     __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_unix_system__", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "__internal_unix_system__", expr);
     const std::string cmd = params[0]->to_cxxstring();
-    int exitcode = system(cmd.c_str());
+    int exitcode = process::run(cmd);
     if (exitcode == -1 && ((config::runtime::flags & __ERROR_ON_BASH_FAIL) != 0)) {
         Err::err_wexpr(expr);
         const std::string msg = "failed to execute system command `"+cmd+"`";
@@ -794,34 +1247,398 @@ Intrinsics::intrinsic___internal_unix_system_woutput__(
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "__internal_unix_system__woutput_", expr);
     const std::string cmd = params[0]->to_cxxstring();
 
-    std::array<char, 256> buffer;
     std::string output = "";
 
-    FILE *pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
+    int ec = process::run_capture(cmd, output);
+    if (ec == -1) {
         Err::err_wexpr(expr);
         const std::string msg = "failed to execute system command `" + cmd + "`";
         throw InterpreterException(msg);
     }
 
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        output += buffer.data();
+    std::vector<std::shared_ptr<earl::value::Obj>> res = {
+        std::make_shared<earl::value::Int>(ec),
+        std::make_shared<earl::value::Str>(output),
+    };
+    return std::make_shared<earl::value::Tuple>(std::move(res));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_pipeline__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                            std::shared_ptr<Ctx> &ctx,
+                                            Expr *expr) {
+    if (params.size() != 1 && params.size() != 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_pipeline__` expects 1 or 2 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::List, 1, "__internal_pipeline__", expr);
+    bool capture = true;
+    if (params.size() == 2) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::Bool, 2, "__internal_pipeline__", expr);
+        capture = params[1]->boolean();
     }
 
-    int ec = pclose(pipe);
-    if (ec == -1) {
+    auto &elems = dynamic_cast<earl::value::List *>(params[0].get())->value();
+    std::vector<process::Stage> stages;
+    std::string shown = "";
+
+    for (size_t i = 0; i < elems.size(); ++i) {
+        auto &elem = elems[i];
+        process::Stage stage;
+
+        if (elem->type() == earl::value::Type::Str) {
+            stage.cmd = elem->to_cxxstring();
+            shown += (i == 0 ? "" : " | ")+stage.cmd;
+        }
+        else if (elem->type() == earl::value::Type::Closure && i != 0) {
+            auto closure = std::dynamic_pointer_cast<earl::value::Closure>(elem);
+            stage.filter = [closure, &ctx, expr](std::string &chunk) {
+                std::vector<std::shared_ptr<earl::value::Obj>> values = {
+                    std::make_shared<earl::value::Str>(chunk),
+                };
+                auto result = closure->call(values, ctx);
+                if (result->type() != earl::value::Type::Str) {
+                    Err::err_wexpr(expr);
+                    const std::string msg = "a `__internal_pipeline__` closure must return a `str` but got `"+earl::value::type_to_str(result->type())+"`";
+                    throw InterpreterException(msg);
+                }
+                return result->to_cxxstring();
+            };
+            shown += " | <closure>";
+        }
+        else {
+            Err::err_wexpr(expr);
+            const std::string msg = i == 0
+                ? "the first stage of a `__internal_pipeline__` must be a command of type `str`"
+                : "a `__internal_pipeline__` stage must be a command of type `str` or a closure but got `"+earl::value::type_to_str(elem->type())+"`";
+            throw InterpreterException(msg);
+        }
+
+        stages.push_back(std::move(stage));
+    }
+
+    if (stages.empty()) {
         Err::err_wexpr(expr);
-        const std::string msg = "failed to execute system command `" + cmd + "`";
+        const std::string msg = "function `__internal_pipeline__` expects at least one stage";
+        throw InterpreterException(msg);
+    }
+
+    if ((config::runtime::flags & __SHOWBASH) != 0)
+        std::cout << "+ " << shown << std::endl;
+    std::cout.flush();
+
+    std::string output = "";
+    std::vector<int> statuses;
+    try {
+        statuses = process::run_pipeline(stages, capture ? &output : nullptr);
+    }
+    catch (const std::runtime_error &e) {
+        Err::err_wexpr(expr);
+        const std::string msg = std::string("pipeline: ")+e.what();
         throw InterpreterException(msg);
     }
 
+    std::vector<std::shared_ptr<earl::value::Obj>> codes;
+    for (int status : statuses) {
+        int code = status == -1 ? -1 : WIFEXITED(status) ? WEXITSTATUS(status) : 128+WTERMSIG(status);
+        if (code != 0 && (config::runtime::flags & __ERROR_ON_BASH_FAIL) != 0) {
+            Err::err_wexpr(expr);
+            const std::string msg = "BASH pipeline `"+shown+"` failed with exit code: "+std::to_string(code);
+            throw InterpreterException(msg);
+        }
+        codes.push_back(std::make_shared<earl::value::Int>(code));
+    }
+
     std::vector<std::shared_ptr<earl::value::Obj>> res = {
-        std::make_shared<earl::value::Int>(ec),
-        std::make_shared<earl::value::Str>(output),
+        std::make_shared<earl::value::List>(std::move(codes)),
+        std::make_shared<earl::value::Str>(std::move(output)),
     };
     return std::make_shared<earl::value::Tuple>(std::move(res));
 }
 
+// Errors that come from the event loop itself (and not from
+// the task that is being awaited) are reported at `expr`.
+static std::shared_ptr<earl::value::Obj>
+await_task(std::shared_ptr<earl::value::Task> task, const std::string &fn, Expr *expr) {
+    try {
+        return event_loop::await(task);
+    } catch (const std::runtime_error &e) {
+        Err::err_wexpr(expr);
+        const std::string msg = fn+": "+e.what();
+        throw InterpreterException(msg);
+    }
+}
+
+static std::vector<std::shared_ptr<earl::value::Task>>
+list_of_tasks(std::shared_ptr<earl::value::Obj> &param, const std::string &fn, Expr *expr) {
+    std::vector<std::shared_ptr<earl::value::Task>> tasks = {};
+    for (auto &elem : dynamic_cast<earl::value::List *>(param.get())->value()) {
+        if (elem->type() != earl::value::Type::Task) {
+            Err::err_wexpr(expr);
+            const std::string msg = "function `"+fn+"` expects a list of tasks but got an element of type `"+earl::value::type_to_str(elem->type())+"`";
+            throw InterpreterException(msg);
+        }
+        tasks.push_back(std::dynamic_pointer_cast<earl::value::Task>(elem));
+    }
+    return tasks;
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_await__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_await__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Task, 1, "__internal_await__", expr);
+    return await_task(std::dynamic_pointer_cast<earl::value::Task>(params[0]), "__internal_await__", expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_await_all__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                             std::shared_ptr<Ctx> &ctx,
+                                             Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_await_all__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::List, 1, "__internal_await_all__", expr);
+    std::vector<std::shared_ptr<earl::value::Obj>> values = {};
+    for (auto &task : list_of_tasks(params[0], "__internal_await_all__", expr))
+        values.push_back(await_task(task, "__internal_await_all__", expr));
+    return std::make_shared<earl::value::List>(std::move(values));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_await_any__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                             std::shared_ptr<Ctx> &ctx,
+                                             Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_await_any__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::List, 1, "__internal_await_any__", expr);
+    auto tasks = list_of_tasks(params[0], "__internal_await_any__", expr);
+    if (tasks.size() == 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_await_any__` expects at least one task";
+        throw InterpreterException(msg);
+    }
+
+    // A task of our own that finishes along with the first of `tasks`.
+    auto first = std::make_shared<earl::value::Task>();
+    auto winner = std::make_shared<size_t>(0);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i]->on_done([first, winner, i]() {
+            if (first->done())
+                return;
+            *winner = i;
+            first->resolve(nullptr);
+        });
+    }
+    (void)await_task(first, "__internal_await_any__", expr);
+
+    std::vector<std::shared_ptr<earl::value::Obj>> res = {
+        std::make_shared<earl::value::Int>(static_cast<int64_t>(*winner)),
+        tasks[*winner]->result(),
+    };
+    return std::make_shared<earl::value::Tuple>(std::move(res));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_timer__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_timer__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_timer__", expr);
+    auto ms = dynamic_cast<earl::value::Int *>(params[0].get())->value();
+    return event_loop::timer(ms < 0 ? 0 : static_cast<uint64_t>(ms)*1000);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_fd_readable__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                               std::shared_ptr<Ctx> &ctx,
+                                               Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_fd_readable__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_fd_readable__", expr);
+    try {
+        return event_loop::readable(static_cast<int>(dynamic_cast<earl::value::Int *>(params[0].get())->value()));
+    } catch (const std::runtime_error &e) {
+        Err::err_wexpr(expr);
+        const std::string msg = std::string("fd_readable: ")+e.what();
+        throw InterpreterException(msg);
+    }
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_bash_async__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                              std::shared_ptr<Ctx> &ctx,
+                                              Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_bash_async__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "__internal_bash_async__", expr);
+    const std::string cmd = params[0]->to_cxxstring();
+    if ((config::runtime::flags & __SHOWBASH) != 0)
+        std::cout << "+ " << cmd << std::endl;
+    try {
+        return event_loop::command(cmd);
+    } catch (const std::runtime_error &e) {
+        Err::err_wexpr(expr);
+        const std::string msg = std::string("bash_async: ")+e.what();
+        throw InterpreterException(msg);
+    }
+}
+
+static uint64_t
+uabs(int64_t x) {
+    return x < 0 ? 0-static_cast<uint64_t>(x) : static_cast<uint64_t>(x);
+}
+
+static BigInt
+babs(const BigInt &x) {
+    return x.m_neg ? -x : x;
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_gcd__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 2, "__internal_gcd__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_gcd__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::Int, 2, "__internal_gcd__", expr);
+    auto a = dynamic_cast<earl::value::Int *>(params[0].get());
+    auto b = dynamic_cast<earl::value::Int *>(params[1].get());
+
+    if (!a->is_big() && !b->is_big()) {
+        uint64_t g = std::gcd(uabs(a->value()), uabs(b->value()));
+        if (g <= static_cast<uint64_t>(INT64_MAX))
+            return std::make_shared<earl::value::Int>(static_cast<int64_t>(g));
+    }
+    return std::make_shared<earl::value::Int>(BigInt::gcd(a->as_big(), b->as_big()));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_lcm__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 2, "__internal_lcm__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_lcm__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::Int, 2, "__internal_lcm__", expr);
+    auto a = dynamic_cast<earl::value::Int *>(params[0].get());
+    auto b = dynamic_cast<earl::value::Int *>(params[1].get());
+
+    if (!a->is_big() && !b->is_big()) {
+        uint64_t x = uabs(a->value()), y = uabs(b->value());
+        if (x == 0 || y == 0)
+            return std::make_shared<earl::value::Int>(0);
+        uint64_t l;
+        if (!__builtin_mul_overflow(x / std::gcd(x, y), y, &l) && l <= static_cast<uint64_t>(INT64_MAX))
+            return std::make_shared<earl::value::Int>(static_cast<int64_t>(l));
+    }
+
+    BigInt x = babs(a->as_big()), y = babs(b->as_big());
+    if (x.is_zero() || y.is_zero())
+        return std::make_shared<earl::value::Int>(0);
+    return std::make_shared<earl::value::Int>(x / BigInt::gcd(x, y) * y);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_powmod__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                          std::shared_ptr<Ctx> &ctx,
+                                          Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 3, "__internal_powmod__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Int, 1, "__internal_powmod__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::Int, 2, "__internal_powmod__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[2], earl::value::Type::Int, 3, "__internal_powmod__", expr);
+    auto base = dynamic_cast<earl::value::Int *>(params[0].get());
+    auto exp = dynamic_cast<earl::value::Int *>(params[1].get());
+    auto mod = dynamic_cast<earl::value::Int *>(params[2].get());
+
+    if (exp->as_big().m_neg) {
+        Err::err_wexpr(expr);
+        const std::string msg = "powmod exponent must not be negative";
+        throw InterpreterException(msg);
+    }
+    if (mod->as_big().m_neg || mod->as_big().is_zero()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "powmod modulus must be positive";
+        throw InterpreterException(msg);
+    }
+
+    if (!base->is_big() && !exp->is_big() && !mod->is_big()) {
+        // Products of two residues below 2^63 always fit in 128 bits.
+        using u128 = unsigned __int128;
+        int64_t m = mod->value();
+        int64_t b = base->value() % m;
+        if (b < 0)
+            b += m;
+        u128 res = 1 % m, sq = b;
+        for (int64_t e = exp->value(); e; e >>= 1) {
+            if (e & 1)
+                res = res * sq % m;
+            sq = sq * sq % m;
+        }
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(res));
+    }
+    return std::make_shared<earl::value::Int>(BigInt::powmod(base->as_big(), exp->as_big(), mod->as_big()));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_pow__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 2, "__internal_pow__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_OR(params[0], earl::value::Type::Int, earl::value::Type::Float, 1, "__internal_pow__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_OR(params[1], earl::value::Type::Int, earl::value::Type::Float, 2, "__internal_pow__", expr);
+    auto as_double = [](earl::value::Obj *o) {
+        return o->type() == earl::value::Type::Int
+            ? dynamic_cast<earl::value::Int *>(o)->as_double()
+            : dynamic_cast<earl::value::Float *>(o)->value();
+    };
+    return std::make_shared<earl::value::Float>(std::pow(as_double(params[0].get()), as_double(params[1].get())));
+}
+
+static std::shared_ptr<earl::value::Obj>
+round_to_int(std::shared_ptr<earl::value::Obj> &x, double (*round)(double), Expr *expr) {
+    if (x->type() == earl::value::Type::Int)
+        return x->copy();
+
+    double d = round(dynamic_cast<earl::value::Float *>(x.get())->value());
+    if (!std::isfinite(d)) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot convert a non-finite float to an integer";
+        throw InterpreterException(msg);
+    }
+    if (d >= -9223372036854775808.0 && d < 9223372036854775808.0)
+        return std::make_shared<earl::value::Int>(static_cast<int64_t>(d));
+
+    char buf[400];
+    snprintf(buf, sizeof(buf), "%.0f", d);
+    return std::make_shared<earl::value::Int>(BigInt::from_str(buf));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_floor__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_floor__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_OR(params[0], earl::value::Type::Int, earl::value::Type::Float, 1, "__internal_floor__", expr);
+    return round_to_int(params[0], std::floor, expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_ceil__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                        std::shared_ptr<Ctx> &ctx,
+                                        Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "__internal_ceil__", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_OR(params[0], earl::value::Type::Int, earl::value::Type::Float, 1, "__internal_ceil__", expr);
+    return round_to_int(params[0], std::ceil, expr);
+}
+
 
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_type(std::vector<std::shared_ptr<earl::value::Obj>> &params,
@@ -997,6 +1814,36 @@ Intrinsics::intrinsic_print(std::vector<std::shared_ptr<earl::value::Obj>> &para
     return std::make_shared<earl::value::Void>();
 }
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic___internal_print_all__(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                             std::shared_ptr<Ctx> &ctx,
+                                             Expr *expr) {
+    (void)ctx;
+    if (params.size() != 1 && params.size() != 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `__internal_print_all__` expects 1 or 2 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::List, 1, "__internal_print_all__", expr);
+
+    std::string sep = "\n";
+    if (params.size() == 2) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT(params[1], earl::value::Type::Str, 2, "__internal_print_all__", expr);
+        sep = params[1]->to_cxxstring();
+    }
+
+    auto &elems = dynamic_cast<earl::value::List *>(params[0].get())->value();
+    std::string out = "";
+    for (size_t i = 0; i < elems.size(); ++i) {
+        if (i != 0)
+            out += sep;
+        out += elems[i]->to_cxxstring();
+    }
+    out += '\n';
+    std::cout.write(out.data(), out.size());
+    return std::make_shared<earl::value::Void>();
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_println(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                               std::shared_ptr<Ctx> &ctx,
@@ -1081,6 +1928,11 @@ Intrinsics::intrinsic_input(std::vector<std::shared_ptr<earl::value::Obj>> &para
     (void)ctx;
     intrinsic_print(params, ctx, expr);
     std::string in = "";
+    // Let other tasks run until there is a line to read.
+    if (event_loop::in_task() && std::cin.rdbuf()->in_avail() <= 0) {
+        std::cout.flush();
+        (void)await_task(event_loop::readable(STDIN_FILENO), "input", expr);
+    }
     std::getline(std::cin, in);
     return std::make_shared<earl::value::Str>(in);
 }
@@ -1101,7 +1953,12 @@ Intrinsics::intrinsic_sleep(std::vector<std::shared_ptr<earl::value::Obj>> &time
     (void)ctx;
     __INTR_ARGS_MUSTBE_SIZE(time, 1, "sleep", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(time[0], earl::value::Type::Int, 1, "sleep", expr);
-    usleep(dynamic_cast<earl::value::Int *>(time[0].get())->value());
+    auto us = dynamic_cast<earl::value::Int *>(time[0].get())->value();
+    // Inside of a task only that task sleeps, the others keep running.
+    if (event_loop::in_task())
+        (void)await_task(event_loop::timer(us < 0 ? 0 : static_cast<uint64_t>(us)), "sleep", expr);
+    else
+        usleep(us);
     return std::make_shared<earl::value::Void>();
 }
 
@@ -1133,10 +1990,25 @@ Intrinsics::intrinsic_open(std::vector<std::shared_ptr<earl::value::Obj>> &param
                            std::shared_ptr<Ctx> &ctx,
                            Expr *expr) {
     (void)ctx;
-    __INTR_ARGS_MUSTBE_SIZE(params, 2, "open", expr);
+    if (params.size() != 2 && params.size() != 3) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `open` expects 2 or 3 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "open", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(params[1], earl::value::Type::Str, 2, "open", expr);
 
+    int64_t bufsz = 0;
+    if (params.size() == 3) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[2], earl::value::Type::Int, 3, "open", expr);
+        bufsz = dynamic_cast<earl::value::Int *>(params[2].get())->value();
+        if (bufsz <= 0) {
+            Err::err_wexpr(expr);
+            const std::string msg = "function `open` expects a positive buffer size but got "+std::to_string(bufsz);
+            throw InterpreterException(msg);
+        }
+    }
+
     auto fp = dynamic_cast<earl::value::Str *>(params[0].get());
     auto mode = dynamic_cast<earl::value::Str *>(params[1].get());
     std::fstream stream;
@@ -1155,6 +2027,9 @@ Intrinsics::intrinsic_open(std::vector<std::shared_ptr<earl::value::Obj>> &param
         }
     }
 
+    trace::Span span("file", "open");
+    span.arg("path", fp->value_asref());
+    span.arg("mode", mode->value_asref());
     stream.open(fp->value(), om);
 
     if (!stream) {
@@ -1167,6 +2042,14 @@ Intrinsics::intrinsic_open(std::vector<std::shared_ptr<earl::value::Obj>> &param
                                                  std::dynamic_pointer_cast<earl::value::Str>(params[1]),
                                                  std::move(stream));
     f->set_open();
+    if (bufsz > 0) {
+        try {
+            f->set_write_buffer(static_cast<size_t>(bufsz));
+        } catch (const InterpreterException &) {
+            Err::err_wexpr(expr);
+            throw;
+        }
+    }
     return f;
 }
 
@@ -36,6 +36,7 @@
 #include "utils.hpp"
 #include "common.hpp"
 #include "config.h"
+#include "timing.hpp"
 #ifdef PORTABLE
 #include "bake.hpp"
 #endif
@@ -167,6 +168,7 @@ sanatize_stdlib_bake_fp(const char *fp) {
 
 const char *
 read_file(const char *filepath, std::vector<std::string> &include_dirs) {
+    timing::Scope timer(timing::Phase::Read);
 #ifdef PORTABLE
     auto baked_path = sanatize_stdlib_bake_fp(filepath);
     auto it = baked_stdlib.find(baked_path);
@@ -245,6 +247,7 @@ lex_file(std::string &src,
          std::vector<std::string> &keywords,
          std::vector<std::string> &types,
          std::string &comment) {
+    timing::Scope timer(timing::Phase::Lex);
     (void)is_keyword;
     (void)is_type;
     (void)issym;
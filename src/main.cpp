@@ -41,6 +41,14 @@
 #include "earl-to-py.hpp"
 #include "hidden-file.hpp"
 #include "mem-file.hpp"
+#include "event-loop.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+#include "alloc-stats.hpp"
+#include "timing.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+#include "shell-stats.hpp"
 
 namespace config {
     namespace prelude {
@@ -191,7 +199,16 @@ usage(void) {
     std::cerr << "        -w, --watch [files...] . . . . . . . . Watch files for changes and hot reload on save" << std::endl;
     std::cerr << "        -b, --batch [files...] . . . . . . . . Run multiple scripts in batch" << std::endl;
     std::cerr << "        -O  --oneshot \"<code>\" . . . . . . . . Evaluate code in the CLI and print the result (if non-unit type)" << std::endl;
-    std::cerr << "            --time . . . . . . . . . . . . . . Time execution" << std::endl;
+    std::cerr << "            --time[=<file>]  . . . . . . . . . Time execution by phase (startup, imports, interpretation), also as JSON to <file>" << std::endl;
+    std::cerr << "            --profile[=<file>] . . . . . . . . Profile every call and write a JSON report (`earl-profile.json` if no file is given)" << std::endl;
+    std::cerr << "            --sample-profile[=<file>]  . . . . Sample the call stack and write collapsed stacks for flamegraphs (`earl-samples.folded` if no file is given)" << std::endl;
+    std::cerr << "            --line-profile[=<file>]  . . . . . Print the source annotated with how often and how long each line ran (stderr if no file is given)" << std::endl;
+    std::cerr << "            --coverage[=<file>]  . . . . . . . Write line coverage in lcov format (`earl.lcov` if no file is given)" << std::endl;
+    std::cerr << "            --alloc-stats  . . . . . . . . . . Count value allocations per type and site (needs -DALLOC_STATS=ON)" << std::endl;
+    std::cerr << "            --trace[=<file>] . . . . . . . . . Write calls, imports, shell commands and file IO as Chrome trace events (`earl-trace.json` if no file is given)" << std::endl;
+    std::cerr << "            --metrics[=<file>] . . . . . . . . Keep rewriting <file> with runtime counters in Prometheus text format (`earl-metrics.prom` if no file is given)" << std::endl;
+    std::cerr << "            --shell-stats  . . . . . . . . . . Print how long shell commands took on exit, with the slowest commands by total time" << std::endl;
+    std::cerr << "            --slow-bash=<ms> . . . . . . . . . Log every shell command that takes longer than <ms> with where it is in the source" << std::endl;
     std::cerr << "            --clear-mem  . . . . . . . . . . . Clear the persistent memory file" << std::endl;
     std::cerr << "            --without-stdlib . . . . . . . . . Do not use standard library" << std::endl;
     std::cerr << "    Runtime Config" << std::endl;
@@ -204,6 +221,9 @@ usage(void) {
     std::cerr << "            --show-lets  . . . . . . . . . . . Print all variable instantiations" << std::endl;
     std::cerr << "            --show-muts  . . . . . . . . . . . Print all value mutations" << std::endl;
     std::cerr << "            --no-sanitize-pipes  . . . . . . . Do not sanitize BASH pipes" << std::endl;
+    std::cerr << "            --stdout-buffer <mode> . . . . . . When to flush stdout (`auto` if this option is not used)" << std::endl;
+    std::cerr << "                where" << std::endl;
+    std::cerr << "                    mode = auto|line|full|none (auto = line for a terminal, full otherwise)" << std::endl;
     std::cerr << "    REPL Config" << std::endl;
     std::cerr << "            --repl-nocolor . . . . . . . . . . Do not use color in the REPL" << std::endl;
     std::cerr << "            --repl-welcome . . . . . . . . . . Display a welcome message in the REPL" << std::endl;
@@ -402,9 +422,84 @@ handle_repl_welcome(std::vector<std::string> &args) {
 }
 
 static void
-handle_time(void) {
+handle_stdout_buffer(std::vector<std::string> &args) {
+    output::Policy policy;
+    if (args.size() == 0 || !output::policy_from_str(args.at(0), policy)) {
+        std::cerr << "error: flag `--" COMMON_EARL2ARG_STDOUT_BUFFER "` expects one of auto|line|full|none" << std::endl;
+        std::exit(1);
+    }
+    args.erase(args.begin());
+    output::set_policy(policy);
+}
+
+// Get <file> out of `--<flag>[=<file>]`.
+static std::string
+flag_output_file(const std::string &arg, const std::string &fallback) {
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos)
+        return fallback;
+    std::string out = arg.substr(eq+1);
+    if (out == "") {
+        std::cerr << "error: flag `--" << arg << "` expects a file" << std::endl;
+        std::exit(1);
+    }
+    return out;
+}
+
+static void
+handle_time(const std::string &arg) {
     config::runtime::flags |= __TIME;
-    config::prelude::time::start = std::chrono::high_resolution_clock::now();
+    timing::enable(flag_output_file(arg, ""));
+}
+
+static void
+handle_profile(const std::string &arg) {
+    profiler::enable(flag_output_file(arg, "earl-profile.json"));
+}
+
+static void
+handle_sample_profile(const std::string &arg) {
+    profiler::enable_sampling(flag_output_file(arg, "earl-samples.folded"), 999);
+}
+
+static void
+handle_line_profile(const std::string &arg) {
+    profiler::enable_lines(flag_output_file(arg, ""));
+}
+
+static void
+handle_coverage(const std::string &arg) {
+    profiler::enable_coverage(flag_output_file(arg, "earl.lcov"));
+}
+
+static void
+handle_alloc_stats(void) {
+    if (!alloc_stats::enable()) {
+        std::cerr << "error: flag `--" COMMON_EARL2ARG_ALLOC_STATS "` needs EARL to be built with `-DALLOC_STATS=ON`" << std::endl;
+        std::exit(1);
+    }
+}
+
+static void
+handle_trace(const std::string &arg) {
+    trace::enable(flag_output_file(arg, "earl-trace.json"));
+}
+
+static void
+handle_metrics(const std::string &arg) {
+    metrics::enable(flag_output_file(arg, "earl-metrics.prom"));
+}
+
+static void
+handle_slow_bash(const std::string &arg) {
+    const size_t eq = arg.find('=');
+    char *end = nullptr;
+    double ms = eq == std::string::npos ? -1.0 : std::strtod(arg.c_str()+eq+1, &end);
+    if (ms < 0.0 || !end || *end != '\0' || end == arg.c_str()+eq+1) {
+        std::cerr << "error: flag `--" COMMON_EARL2ARG_SLOW_BASH "` expects a threshold in milliseconds, e.g. `--" COMMON_EARL2ARG_SLOW_BASH "=500`" << std::endl;
+        std::exit(1);
+    }
+    shell_stats::enable_slow_log(ms);
 }
 
 static void
@@ -463,10 +558,30 @@ parse_2hypharg(std::string arg, std::vector<std::string> &args) {
         show_is_portable();
     else if (arg == COMMON_EARL2ARG_REPL_WELCOME)
         handle_repl_welcome(args);
-    else if (arg == COMMON_EARL2ARG_TIME)
-        handle_time();
+    else if (arg == COMMON_EARL2ARG_TIME || arg.rfind(COMMON_EARL2ARG_TIME "=", 0) == 0)
+        handle_time(arg);
     else if (arg == COMMON_EARL2ARG_CLEAR_MEM_FILE)
         handle_clear_mem_file();
+    else if (arg == COMMON_EARL2ARG_STDOUT_BUFFER)
+        handle_stdout_buffer(args);
+    else if (arg == COMMON_EARL2ARG_PROFILE || arg.rfind(COMMON_EARL2ARG_PROFILE "=", 0) == 0)
+        handle_profile(arg);
+    else if (arg == COMMON_EARL2ARG_SAMPLE_PROFILE || arg.rfind(COMMON_EARL2ARG_SAMPLE_PROFILE "=", 0) == 0)
+        handle_sample_profile(arg);
+    else if (arg == COMMON_EARL2ARG_LINE_PROFILE || arg.rfind(COMMON_EARL2ARG_LINE_PROFILE "=", 0) == 0)
+        handle_line_profile(arg);
+    else if (arg == COMMON_EARL2ARG_COVERAGE || arg.rfind(COMMON_EARL2ARG_COVERAGE "=", 0) == 0)
+        handle_coverage(arg);
+    else if (arg == COMMON_EARL2ARG_ALLOC_STATS)
+        handle_alloc_stats();
+    else if (arg == COMMON_EARL2ARG_TRACE || arg.rfind(COMMON_EARL2ARG_TRACE "=", 0) == 0)
+        handle_trace(arg);
+    else if (arg == COMMON_EARL2ARG_METRICS || arg.rfind(COMMON_EARL2ARG_METRICS "=", 0) == 0)
+        handle_metrics(arg);
+    else if (arg == COMMON_EARL2ARG_SHELL_STATS)
+        shell_stats::enable_summary();
+    else if (arg == COMMON_EARL2ARG_SLOW_BASH || arg.rfind(COMMON_EARL2ARG_SLOW_BASH "=", 0) == 0)
+        handle_slow_bash(arg);
     else {
         std::cerr << "error: Unrecognised argument: " << arg << std::endl;
         std::cerr << "Did you mean: " << try_guess_wrong_arg(arg) << "?" << std::endl;
@@ -649,7 +764,9 @@ do_one_shot(std::string &src,
         std::cerr << "Parser error: " << e.what() << std::endl;
     }
     try {
+        timing::Scope timer(timing::Phase::Interpret);
         (void)Interpreter::interpret(std::move(program), std::move(lexer));
+        event_loop::drain();
     } catch (const InterpreterException &e) {
         std::cerr << "Interpreter error: " << e.what() << std::endl;
     }
@@ -657,8 +774,8 @@ do_one_shot(std::string &src,
 
 int
 main(int argc, char **argv) {
-    init_mem_file();
-    config::runtime::persistent_mem = parse_mem_file();
+    config::prelude::time::start = std::chrono::high_resolution_clock::now();
+    output::init();
 
     ++argv; --argc;
 
@@ -666,8 +783,10 @@ main(int argc, char **argv) {
     std::vector<std::string> types = {};
     std::string comment = "#";
 
-    assert_repl_theme_valid();
-    handle_hidden_file();
+    {
+        timing::Scope timer(timing::Phase::HiddenFile);
+        handle_hidden_file();
+    }
     handlecli(argc, argv);
 
     if ((config::runtime::flags & __WATCH) != 0) {
@@ -721,7 +840,9 @@ main(int argc, char **argv) {
                             continue;
                         }
                         try {
+                            timing::Scope timer(timing::Phase::Interpret);
                             (void)Interpreter::interpret(std::move(program), std::move(lexer));
+                            event_loop::drain();
                         } catch (const InterpreterException &e) {
                             std::cerr << "Interpreter error: " << e.what() << std::endl;
                             if ((config::runtime::flags & __WATCH) == 0)
@@ -735,6 +856,8 @@ main(int argc, char **argv) {
     else {
         assert_repl_theme_valid();
         config::runtime::flags |= __REPL;
+        // The REPL draws prompts and partial lines itself.
+        output::set_policy(output::Policy::None);
         config::runtime::argv.push_back("EARL-REPLv" VERSION);
         if (config::repl::welcome::msg != "")
             std::cout << config::repl::welcome::msg << '\n';
@@ -744,11 +867,5 @@ main(int argc, char **argv) {
         repl::run(config::prelude::include::dirs);
     }
 
-    if ((config::runtime::flags & __TIME) != 0) {
-        config::prelude::time::end = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = config::prelude::time::end - config::prelude::time::start;
-        std::cout << "[EARL time] Execution time: " << elapsed.count() << " seconds" << std::endl;
-    }
-
     return 0;
 }
@@ -7,6 +7,9 @@
 #include "utils.hpp"
 #include "err.hpp"
 #include "common.hpp"
+#include "timing.hpp"
+
+static bool loaded = false;
 
 static char *
 get_home(void) {
@@ -40,6 +43,19 @@ init_mem_file(void) {
     throw InterpreterException(msg);
 }
 
+// Most scripts never use persistent memory, so the file is only
+// created and read the first time one of the `persist*` functions
+// needs it.
+void
+load_mem_file(void) {
+    if (loaded)
+        return;
+    timing::Scope timer(timing::Phase::MemFile);
+    init_mem_file();
+    config::runtime::persistent_mem = parse_mem_file();
+    loaded = true;
+}
+
 std::unordered_map<std::string, std::string>
 parse_mem_file(void) {
     ////////////////////////////
@@ -95,6 +111,7 @@ write_mem_file(std::unordered_map<std::string, std::string> &content) {
 
 void
 clear_mem_file(void) {
+    loaded = true;
     config::runtime::persistent_mem.clear();
     write_mem_file(config::runtime::persistent_mem);
 }
@@ -0,0 +1,205 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <unordered_map>
+
+#include "intrinsics.hpp"
+#include "err.hpp"
+#include "ctx.hpp"
+#include "ast.hpp"
+#include "earl.hpp"
+
+const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction>
+Intrinsics::intrinsic_bytes_member_functions = {
+    {"find", &Intrinsics::intrinsic_member_find},
+    {"hex", &Intrinsics::intrinsic_member_hex},
+    {"int_le", &Intrinsics::intrinsic_member_int_le},
+    {"int_be", &Intrinsics::intrinsic_member_int_be},
+    {"crc32", &Intrinsics::intrinsic_member_crc32},
+    {"decode", &Intrinsics::intrinsic_member_decode},
+};
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_find(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr) {
+    (void)ctx;
+    if (param.size() != 1 && param.size() != 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "member intrinsic `find` expects 1 or 2 arguments but "+std::to_string(param.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+    {
+        std::vector<earl::value::Type> tys = {
+            earl::value::Type::Bytes,
+            earl::value::Type::Str,
+            earl::value::Type::Char,
+            earl::value::Type::Int,
+        };
+        __MEMBER_INTR_ARG_MUSTBE_TYPE_COMPAT_OR_LST(param[0], tys, 1, "find", expr);
+    }
+
+    auto bytes = dynamic_cast<earl::value::Bytes *>(obj.get());
+
+    int64_t start = 0;
+    if (param.size() == 2) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(param[1], earl::value::Type::Int, 2, "find", expr);
+        start = dynamic_cast<earl::value::Int *>(param[1].get())->value();
+        if (start < 0) {
+            Err::err_wexpr(expr);
+            const std::string msg = "member intrinsic `find` expects a non-negative start but got "+std::to_string(start);
+            throw InterpreterException(msg);
+        }
+    }
+
+    int64_t pos = -1;
+    switch (param[0]->type()) {
+    case earl::value::Type::Bytes: {
+        auto needle = dynamic_cast<earl::value::Bytes *>(param[0].get());
+        pos = bytes->find(needle->data(), needle->size(), static_cast<size_t>(start));
+    } break;
+    case earl::value::Type::Str: {
+        const std::string needle = param[0]->to_cxxstring();
+        pos = bytes->find(reinterpret_cast<const uint8_t *>(needle.data()), needle.size(), static_cast<size_t>(start));
+    } break;
+    case earl::value::Type::Char: {
+        uint8_t needle = static_cast<uint8_t>(dynamic_cast<earl::value::Char *>(param[0].get())->value());
+        pos = bytes->find(&needle, 1, static_cast<size_t>(start));
+    } break;
+    case earl::value::Type::Int: {
+        int64_t value = dynamic_cast<earl::value::Int *>(param[0].get())->value();
+        if (value < 0 || value > 255) {
+            Err::err_wexpr(expr);
+            const std::string msg = "member intrinsic `find` expects a byte in 0..255 but got "+std::to_string(value);
+            throw InterpreterException(msg);
+        }
+        uint8_t needle = static_cast<uint8_t>(value);
+        pos = bytes->find(&needle, 1, static_cast<size_t>(start));
+    } break;
+    default: assert(false && "unreachable");
+    }
+
+    return std::make_shared<earl::value::Int>(pos);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_hex(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "hex", expr);
+    return std::make_shared<earl::value::Str>(dynamic_cast<earl::value::Bytes *>(obj.get())->hex());
+}
+
+#define __BYTES_DECODE_INT_ARGS(param, fn, expr)                        \
+    do {                                                                \
+        if (param.size() != 2 && param.size() != 3) {                   \
+            Err::err_wexpr(expr);                                       \
+            const std::string __Msg = "member intrinsic `" fn "` expects 2 or 3 arguments but "+std::to_string(param.size())+" were supplied"; \
+            throw InterpreterException(__Msg);                          \
+        }                                                               \
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(param[0], earl::value::Type::Int, 1, fn, expr); \
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(param[1], earl::value::Type::Int, 2, fn, expr); \
+        if (param.size() == 3)                                          \
+            __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(param[2], earl::value::Type::Bool, 3, fn, expr); \
+    } while (0)
+
+// Shared by `int_le` and `int_be`, takes (offset, width[, signed]).
+static std::shared_ptr<earl::value::Obj>
+decode_int(std::shared_ptr<earl::value::Obj> &obj,
+           std::vector<std::shared_ptr<earl::value::Obj>> &param,
+           bool big_endian,
+           const std::string &name,
+           Expr *expr) {
+    bool is_signed = param.size() == 3 && param[2]->boolean();
+
+    auto bytes = dynamic_cast<earl::value::Bytes *>(obj.get());
+    int64_t offset = dynamic_cast<earl::value::Int *>(param[0].get())->value();
+    int64_t width = dynamic_cast<earl::value::Int *>(param[1].get())->value();
+
+    if (width < 1 || width > 8) {
+        Err::err_wexpr(expr);
+        const std::string msg = "member intrinsic `"+name+"` expects a width of 1 to 8 bytes but got "+std::to_string(width);
+        throw InterpreterException(msg);
+    }
+    if (offset < 0 || static_cast<size_t>(offset+width) > bytes->size()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "member intrinsic `"+name+"` cannot read "+std::to_string(width)
+            +" bytes at offset "+std::to_string(offset)+" of bytes of length "+std::to_string(bytes->size());
+        throw InterpreterException(msg);
+    }
+
+    uint64_t value = bytes->decode_uint(static_cast<size_t>(offset), static_cast<size_t>(width), big_endian);
+
+    // Sign extend from the top bit of the decoded width.
+    if (is_signed && width < 8 && (value >> (width*8-1)) & 1)
+        value |= ~0ULL << (width*8);
+
+    return std::make_shared<earl::value::Int>(static_cast<int64_t>(value));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_int_le(std::shared_ptr<earl::value::Obj> obj,
+                                    std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr) {
+    (void)ctx;
+    __BYTES_DECODE_INT_ARGS(param, "int_le", expr);
+    return decode_int(obj, param, /*big_endian=*/false, "int_le", expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_int_be(std::shared_ptr<earl::value::Obj> obj,
+                                    std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr) {
+    (void)ctx;
+    __BYTES_DECODE_INT_ARGS(param, "int_be", expr);
+    return decode_int(obj, param, /*big_endian=*/true, "int_be", expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_crc32(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "crc32", expr);
+    uint32_t crc = dynamic_cast<earl::value::Bytes *>(obj.get())->crc32();
+    return std::make_shared<earl::value::Int>(static_cast<int64_t>(crc));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_decode(std::shared_ptr<earl::value::Obj> obj,
+                                    std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "decode", expr);
+    auto bytes = dynamic_cast<earl::value::Bytes *>(obj.get());
+    return std::make_shared<earl::value::Str>(std::string(reinterpret_cast<const char *>(bytes->data()), bytes->size()));
+}
@@ -44,13 +44,24 @@ Intrinsics::intrinsic_member_insert(std::shared_ptr<earl::value::Obj> obj,
                                     std::vector<std::shared_ptr<earl::value::Obj>> &params,
                                     std::shared_ptr<Ctx> &ctx,
                                     Expr *expr) {
+    if (obj->type() == earl::value::Type::Set) {
+        __INTR_ARGS_MUSTBE_SIZE(params, 1, "insert", expr);
+        dynamic_cast<earl::value::Set *>(obj.get())->insert(params[0], expr);
+        return std::make_shared<earl::value::Void>();
+    }
+
     __INTR_ARGS_MUSTBE_SIZE(params, 2, "insert", expr);
     switch (obj->type()) {
     case earl::value::Type::DictInt: {
-        auto dict = dynamic_cast<earl::value::Dict<int> *>(obj.get());
+        auto dict = dynamic_cast<earl::value::Dict<int64_t> *>(obj.get());
         __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], dict->ktype(), 1, "insert", expr);
-        int key = dynamic_cast<earl::value::Int *>(params[0].get())->value();
-        dict->insert(key, params[1]);
+        auto *key = dynamic_cast<earl::value::Int *>(params[0].get());
+        if (key->is_big()) {
+            Err::err_wexpr(expr);
+            const std::string msg = "integer key does not fit in 64 bits, use `Dict()` for arbitrary integer keys";
+            throw InterpreterException(msg);
+        }
+        dict->insert(key->value(), params[1]);
     } break;
     case earl::value::Type::DictStr: {
         auto dict = dynamic_cast<earl::value::Dict<std::string> *>(obj.get());
@@ -70,6 +81,17 @@ Intrinsics::intrinsic_member_insert(std::shared_ptr<earl::value::Obj> obj,
         double key = dynamic_cast<earl::value::Float *>(params[0].get())->value();
         dict->insert(key, params[1]);
     } break;
+    case earl::value::Type::DictAny: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        if (!params[0]->is_hashable()) {
+            Err::err_wexpr(expr);
+            const std::string msg = "cannot insert a key of type `"+earl::value::type_to_str(params[0]->type())+"` as it is not hashable";
+            throw InterpreterException(msg);
+        }
+        // Keys are copied so that mutating the original
+        // value cannot change the hash of what is stored.
+        dict->insert(earl::value::DictKey(params[0]->copy()), params[1]);
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot insert value of type `"
@@ -89,10 +111,10 @@ Intrinsics::intrinsic_member_has_key(std::shared_ptr<earl::value::Obj> obj,
     __INTR_ARGS_MUSTBE_SIZE(key, 1, "has_key", expr);
     switch (obj->type()) {
     case earl::value::Type::DictInt: {
-        auto dict = dynamic_cast<earl::value::Dict<int> *>(obj.get());
+        auto dict = dynamic_cast<earl::value::Dict<int64_t> *>(obj.get());
         __INTR_ARG_MUSTBE_TYPE_COMPAT(key[0], dict->ktype(), 1, "has_key", expr);
-        int k = dynamic_cast<earl::value::Int *>(key[0].get())->value();
-        return std::make_shared<earl::value::Bool>(dict->has_key(k));
+        auto *k = dynamic_cast<earl::value::Int *>(key[0].get());
+        return std::make_shared<earl::value::Bool>(!k->is_big() && dict->has_key(k->value()));
     } break;
     case earl::value::Type::DictStr: {
         auto dict = dynamic_cast<earl::value::Dict<std::string> *>(obj.get());
@@ -112,6 +134,12 @@ Intrinsics::intrinsic_member_has_key(std::shared_ptr<earl::value::Obj> obj,
         double k = dynamic_cast<earl::value::Float *>(key[0].get())->value();
         return std::make_shared<earl::value::Bool>(dict->has_key(k));
     } break;
+    case earl::value::Type::DictAny: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        if (!key[0]->is_hashable())
+            return std::make_shared<earl::value::Bool>(false);
+        return std::make_shared<earl::value::Bool>(dict->has_key(earl::value::DictKey(key[0])));
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot check if a key exists in a dictionary of type `"
@@ -130,7 +158,7 @@ Intrinsics::intrinsic_member_has_value(std::shared_ptr<earl::value::Obj> obj,
     __INTR_ARGS_MUSTBE_SIZE(value, 1, "has_value", expr);
     switch (obj->type()) {
     case earl::value::Type::DictInt: {
-        auto dict = dynamic_cast<earl::value::Dict<int> *>(obj.get());
+        auto dict = dynamic_cast<earl::value::Dict<int64_t> *>(obj.get());
         return std::make_shared<earl::value::Bool>(dict->has_value(value[0].get()));
     } break;
     case earl::value::Type::DictStr: {
@@ -145,6 +173,10 @@ Intrinsics::intrinsic_member_has_value(std::shared_ptr<earl::value::Obj> obj,
         auto dict = dynamic_cast<earl::value::Dict<double> *>(obj.get());
         return std::make_shared<earl::value::Bool>(dict->has_value(value[0].get()));
     } break;
+    case earl::value::Type::DictAny: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        return std::make_shared<earl::value::Bool>(dict->has_value(value[0].get()));
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot check if a value exists in a dictionary of type `"
@@ -163,7 +195,7 @@ Intrinsics::intrinsic_member_empty(std::shared_ptr<earl::value::Obj> obj,
     __INTR_ARGS_MUSTBE_SIZE(value, 0, "empty", expr);
     switch (obj->type()) {
     case earl::value::Type::DictInt: {
-        auto dict = dynamic_cast<earl::value::Dict<int> *>(obj.get());
+        auto dict = dynamic_cast<earl::value::Dict<int64_t> *>(obj.get());
         return std::make_shared<earl::value::Bool>(dict->empty());
     } break;
     case earl::value::Type::DictStr: {
@@ -178,6 +210,22 @@ Intrinsics::intrinsic_member_empty(std::shared_ptr<earl::value::Obj> obj,
         auto dict = dynamic_cast<earl::value::Dict<double> *>(obj.get());
         return std::make_shared<earl::value::Bool>(dict->empty());
     } break;
+    case earl::value::Type::DictAny: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        return std::make_shared<earl::value::Bool>(dict->empty());
+    } break;
+    case earl::value::Type::Set: {
+        auto set = dynamic_cast<earl::value::Set *>(obj.get());
+        return std::make_shared<earl::value::Bool>(set->empty());
+    } break;
+    case earl::value::Type::Deque: {
+        auto deque = dynamic_cast<earl::value::Deque *>(obj.get());
+        return std::make_shared<earl::value::Bool>(deque->empty());
+    } break;
+    case earl::value::Type::PriorityQueue: {
+        auto pq = dynamic_cast<earl::value::PriorityQueue *>(obj.get());
+        return std::make_shared<earl::value::Bool>(pq->empty());
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot check if dict type is empty `" +earl::value::type_to_str(obj->type()) +"`";
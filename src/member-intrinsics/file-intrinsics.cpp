@@ -39,6 +39,10 @@ Intrinsics::intrinsic_file_member_functions = {
     {"read", &Intrinsics::intrinsic_member_read},
     {"write", &Intrinsics::intrinsic_member_write},
     {"writelines", &Intrinsics::intrinsic_member_writelines},
+    {"lines", &Intrinsics::intrinsic_member_lines},
+    {"flush", &Intrinsics::intrinsic_member_flush},
+    {"read_bytes", &Intrinsics::intrinsic_member_read_bytes},
+    {"write_bytes", &Intrinsics::intrinsic_member_write_bytes},
 };
 
 std::shared_ptr<earl::value::Obj>
@@ -52,6 +56,19 @@ Intrinsics::intrinsic_member_read(std::shared_ptr<earl::value::Obj> obj,
     return f->read();
 }
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_lines(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "lines", expr);
+    auto f = dynamic_cast<earl::value::File *>(obj.get());
+    f->rewind();
+    // The file itself is what `foreach` reads the lines from.
+    return obj;
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_member_write(std::shared_ptr<earl::value::Obj> obj,
                                    std::vector<std::shared_ptr<earl::value::Obj>> &param,
@@ -70,9 +87,62 @@ Intrinsics::intrinsic_member_writelines(std::shared_ptr<earl::value::Obj> obj,
                                         std::shared_ptr<Ctx> &ctx,
                                         Expr *expr) {
     (void)ctx;
-    (void)obj;
-    (void)param;
-    UNIMPLEMENTED("Intrinsics::intrinsic_member_writelines");
+    __INTR_ARGS_MUSTBE_SIZE(param, 1, "writelines", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(param[0], earl::value::Type::List, 1, "writelines", expr);
+    auto f = dynamic_cast<earl::value::File *>(obj.get());
+    auto lines = std::dynamic_pointer_cast<earl::value::List>(param[0]);
+    f->writelines(lines);
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_flush(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "flush", expr);
+    auto f = dynamic_cast<earl::value::File *>(obj.get());
+    f->flush();
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_read_bytes(std::shared_ptr<earl::value::Obj> obj,
+                                        std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                        std::shared_ptr<Ctx> &ctx,
+                                        Expr *expr) {
+    (void)ctx;
+    if (param.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "member intrinsic `read_bytes` expects 0 or 1 arguments but "+std::to_string(param.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+    int64_t n = -1;
+    if (param.size() == 1) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(param[0], earl::value::Type::Int, 1, "read_bytes", expr);
+        n = dynamic_cast<earl::value::Int *>(param[0].get())->value();
+        if (n < 0) {
+            Err::err_wexpr(expr);
+            const std::string msg = "member intrinsic `read_bytes` expects a non-negative count but got "+std::to_string(n);
+            throw InterpreterException(msg);
+        }
+    }
+    auto f = dynamic_cast<earl::value::File *>(obj.get());
+    return f->read_bytes(n);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_write_bytes(std::shared_ptr<earl::value::Obj> obj,
+                                         std::vector<std::shared_ptr<earl::value::Obj>> &param,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(param, 1, "write_bytes", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(param[0], earl::value::Type::Bytes, 1, "write_bytes", expr);
+    auto f = dynamic_cast<earl::value::File *>(obj.get());
+    f->write_bytes(dynamic_cast<earl::value::Bytes *>(param[0].get()));
+    return std::make_shared<earl::value::Void>();
 }
 
 std::shared_ptr<earl::value::Obj>
@@ -83,6 +83,8 @@ Intrinsics::intrinsic_member_back(std::shared_ptr<earl::value::Obj> obj,
         return dynamic_cast<earl::value::List *>(obj.get())->back();
     else if (obj->type() == earl::value::Type::Tuple)
         return dynamic_cast<earl::value::Tuple *>(obj.get())->back();
+    else if (obj->type() == earl::value::Type::Deque)
+        return dynamic_cast<earl::value::Deque *>(obj.get())->back(expr);
     else
         return dynamic_cast<earl::value::Str *>(obj.get())->back();
     return nullptr; // unreachable
@@ -153,7 +155,11 @@ Intrinsics::intrinsic_member_pop(std::shared_ptr<earl::value::Obj> obj,
                                  std::vector<std::shared_ptr<earl::value::Obj>> &values,
                                  std::shared_ptr<Ctx> &ctx,
                                  Expr *expr) {
-    (void)ctx;
+    if (obj->type() == earl::value::Type::PriorityQueue) {
+        __INTR_ARGS_MUSTBE_SIZE(values, 0, "pop", expr);
+        return dynamic_cast<earl::value::PriorityQueue *>(obj.get())->pop(ctx, expr);
+    }
+
     __INTR_ARGS_MUSTBE_SIZE(values, 1, "pop", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(values[0], earl::value::Type::Int, 1, "pop", expr);
     if (obj->type() == earl::value::Type::List)
@@ -184,6 +190,8 @@ Intrinsics::intrinsic_member_contains(std::shared_ptr<earl::value::Obj> obj,
     }
     else if (obj->type() == earl::value::Type::Tuple)
         return dynamic_cast<earl::value::Tuple *>(obj.get())->contains(value[0].get());
+    else if (obj->type() == earl::value::Type::Set)
+        return dynamic_cast<earl::value::Set *>(obj.get())->contains(value[0]);
     else {
         Err::err_wexpr(expr);
         const std::string msg = "cannot call intrinsic method `contains` on non list-adjacent type";
@@ -0,0 +1,132 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <cassert>
+#include <unordered_map>
+
+#include "intrinsics.hpp"
+#include "err.hpp"
+#include "ctx.hpp"
+#include "ast.hpp"
+#include "earl.hpp"
+
+const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction>
+Intrinsics::intrinsic_matrix_member_functions = {
+    {"at", &Intrinsics::intrinsic_member_at},
+    {"set", &Intrinsics::intrinsic_member_set},
+    {"rows", &Intrinsics::intrinsic_member_rows},
+    {"cols", &Intrinsics::intrinsic_member_cols},
+    {"transpose", &Intrinsics::intrinsic_member_transpose},
+    {"matmul", &Intrinsics::intrinsic_member_matmul},
+    {"to_list", &Intrinsics::intrinsic_member_to_list},
+};
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_at(std::shared_ptr<earl::value::Obj> obj,
+                                std::vector<std::shared_ptr<earl::value::Obj>> &idxs,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(idxs, 2, "at", expr);
+    return dynamic_cast<earl::value::Matrix *>(obj.get())->at(idxs[0].get(), idxs[1].get(), expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_set(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &values,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(values, 3, "set", expr);
+    dynamic_cast<earl::value::Matrix *>(obj.get())->set(values[0].get(), values[1].get(), values[2].get(), expr);
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_rows(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "rows", expr);
+    return std::make_shared<earl::value::Int>(dynamic_cast<earl::value::Matrix *>(obj.get())->rows());
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_cols(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "cols", expr);
+    return std::make_shared<earl::value::Int>(dynamic_cast<earl::value::Matrix *>(obj.get())->cols());
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_transpose(std::shared_ptr<earl::value::Obj> obj,
+                                       std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "transpose", expr);
+    return dynamic_cast<earl::value::Matrix *>(obj.get())->transpose();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_matmul(std::shared_ptr<earl::value::Obj> obj,
+                                    std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr) {
+    (void)ctx;
+    if (params.size() != 1 && params.size() != 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `matmul` expects 1 or 2 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+    __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[0], earl::value::Type::Matrix, 1, "matmul", expr);
+
+    size_t nthreads = 0;
+    if (params.size() == 2) {
+        __INTR_ARG_MUSTBE_TYPE_COMPAT_EXACT(params[1], earl::value::Type::Int, 2, "matmul", expr);
+        int64_t n = dynamic_cast<earl::value::Int *>(params[1].get())->value();
+        if (n < 1) {
+            Err::err_wexpr(expr);
+            const std::string msg = "function `matmul` expects a positive thread count but got "+std::to_string(n);
+            throw InterpreterException(msg);
+        }
+        nthreads = static_cast<size_t>(n);
+    }
+
+    auto mat = dynamic_cast<earl::value::Matrix *>(obj.get());
+    return mat->matmul(dynamic_cast<earl::value::Matrix *>(params[0].get()), nthreads, expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_to_list(std::shared_ptr<earl::value::Obj> obj,
+                                     std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "to_list", expr);
+    return dynamic_cast<earl::value::Matrix *>(obj.get())->to_list();
+}
@@ -0,0 +1,92 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <cassert>
+#include <unordered_map>
+
+#include "intrinsics.hpp"
+#include "err.hpp"
+#include "ctx.hpp"
+#include "ast.hpp"
+#include "earl.hpp"
+
+const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction>
+Intrinsics::intrinsic_procpool_member_functions = {
+    {"spawn", &Intrinsics::intrinsic_member_spawn},
+    {"wait", &Intrinsics::intrinsic_member_wait},
+    {"wait_any", &Intrinsics::intrinsic_member_wait_any},
+    {"wait_all", &Intrinsics::intrinsic_member_wait_all},
+    {"pending", &Intrinsics::intrinsic_member_pending},
+};
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_spawn(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "spawn", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], earl::value::Type::Str, 1, "spawn", expr);
+    auto pool = dynamic_cast<earl::value::ProcPool *>(obj.get());
+    return std::make_shared<earl::value::Int>(pool->spawn(params[0]->to_cxxstring(), expr));
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_wait(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "wait", expr);
+    return dynamic_cast<earl::value::ProcPool *>(obj.get())->wait(params[0].get(), expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_wait_any(std::shared_ptr<earl::value::Obj> obj,
+                                      std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                      std::shared_ptr<Ctx> &ctx,
+                                      Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "wait_any", expr);
+    return dynamic_cast<earl::value::ProcPool *>(obj.get())->wait_any(expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_wait_all(std::shared_ptr<earl::value::Obj> obj,
+                                      std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                      std::shared_ptr<Ctx> &ctx,
+                                      Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "wait_all", expr);
+    return dynamic_cast<earl::value::ProcPool *>(obj.get())->wait_all(expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_pending(std::shared_ptr<earl::value::Obj> obj,
+                                     std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "pending", expr);
+    return std::make_shared<earl::value::Int>(dynamic_cast<earl::value::ProcPool *>(obj.get())->pending());
+}
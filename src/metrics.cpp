@@ -0,0 +1,260 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "metrics.hpp"
+#include "alloc-stats.hpp"
+
+// How often the file is rewritten.
+#define METRICS_INTERVAL_MS 2000
+
+bool metrics::active = false;
+
+std::atomic<uint64_t> metrics::statements(0);
+std::atomic<uint64_t> metrics::function_calls(0);
+std::atomic<uint64_t> metrics::closure_calls(0);
+std::atomic<uint64_t> metrics::intrinsic_calls(0);
+std::atomic<uint64_t> metrics::shell_spawned(0);
+
+// Upper bounds (in seconds) of the shell latency buckets,
+// the last bucket is everything above them.
+static const double shell_bounds[] = {
+    0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60,
+};
+#define N_SHELL_BOUNDS (sizeof(shell_bounds)/sizeof(*shell_bounds))
+
+static std::atomic<uint64_t> shell_buckets[N_SHELL_BOUNDS+1];
+static std::atomic<uint64_t> shell_sum_ns(0);
+static std::atomic<uint64_t> shell_failed(0);
+
+static std::string out_path = "";
+static int64_t start_ns = 0;
+
+static std::mutex writer_lock;
+static std::condition_variable wake;
+static bool stopping = false;
+static std::thread writer;
+
+static inline int64_t
+now_ns(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t
+metrics::shell_start(void) {
+    return active ? now_ns() : 0;
+}
+
+void
+metrics::shell_finish(int64_t start, int status) {
+    if (!active || start == 0)
+        return;
+    uint64_t ns = static_cast<uint64_t>(now_ns()-start);
+    double secs = static_cast<double>(ns)/1e9;
+    size_t bucket = 0;
+    while (bucket < N_SHELL_BOUNDS && secs > shell_bounds[bucket])
+        ++bucket;
+    shell_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shell_sum_ns.fetch_add(ns, std::memory_order_relaxed);
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        shell_failed.fetch_add(1, std::memory_order_relaxed);
+}
+
+static uint64_t
+resident_bytes(void) {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0, resident = 0;
+    if (!(statm >> size >> resident))
+        return 0;
+    return resident*static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+static void
+header(std::string &out, const char *name, const char *type, const char *help) {
+    out += "# HELP ";
+    out += name;
+    out += " ";
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += " ";
+    out += type;
+    out += "\n";
+}
+
+static void
+sample(std::string &out, const std::string &name, double value) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), " %.9g\n", value);
+    out += name;
+    out += buf;
+}
+
+static void
+sample(std::string &out, const std::string &name, uint64_t value) {
+    out += name+" "+std::to_string(value)+"\n";
+}
+
+static std::string
+render(void) {
+    auto get = [](const std::atomic<uint64_t> &counter) {
+        return counter.load(std::memory_order_relaxed);
+    };
+
+    std::string out = "";
+
+    header(out, "earl_statements_total", "counter", "Statements executed.");
+    sample(out, "earl_statements_total", get(metrics::statements));
+
+    header(out, "earl_calls_total", "counter", "Calls by what was called.");
+    sample(out, "earl_calls_total{kind=\"function\"}", get(metrics::function_calls));
+    sample(out, "earl_calls_total{kind=\"closure\"}", get(metrics::closure_calls));
+    sample(out, "earl_calls_total{kind=\"intrinsic\"}", get(metrics::intrinsic_calls));
+
+    header(out, "earl_shell_commands_total", "counter", "Shell commands started, including async ones and pipeline stages.");
+    sample(out, "earl_shell_commands_total", get(metrics::shell_spawned));
+
+    header(out, "earl_shell_command_failures_total", "counter", "Shell commands that were waited on and did not exit with 0.");
+    sample(out, "earl_shell_command_failures_total", get(shell_failed));
+
+    header(out, "earl_shell_command_duration_seconds", "histogram", "Wall time of the shell commands that were waited on.");
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= N_SHELL_BOUNDS; ++i) {
+        cumulative += get(shell_buckets[i]);
+        char le[32];
+        if (i < N_SHELL_BOUNDS)
+            std::snprintf(le, sizeof(le), "%g", shell_bounds[i]);
+        else
+            std::snprintf(le, sizeof(le), "+Inf");
+        sample(out, std::string("earl_shell_command_duration_seconds_bucket{le=\"")+le+"\"}", cumulative);
+    }
+    sample(out, "earl_shell_command_duration_seconds_sum", static_cast<double>(get(shell_sum_ns))/1e9);
+    sample(out, "earl_shell_command_duration_seconds_count", cumulative);
+
+    if (alloc_stats::compiled) {
+        auto totals = alloc_stats::type_totals();
+        header(out, "earl_value_allocations_total", "counter", "Values allocated, by type.");
+        for (auto &t : totals)
+            sample(out, "earl_value_allocations_total{type=\""+t.name+"\"}", t.allocs);
+        header(out, "earl_value_frees_total", "counter", "Values freed (their last reference dropped), by type.");
+        for (auto &t : totals)
+            sample(out, "earl_value_frees_total{type=\""+t.name+"\"}", t.frees);
+        header(out, "earl_values_live", "gauge", "Values that are still referenced, by type.");
+        for (auto &t : totals)
+            sample(out, "earl_values_live{type=\""+t.name+"\"}", t.allocs-t.frees);
+        header(out, "earl_values_live_bytes", "gauge", "Bytes of the values that are still referenced, by type.");
+        for (auto &t : totals)
+            sample(out, "earl_values_live_bytes{type=\""+t.name+"\"}", t.bytes-t.freed_bytes);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double cpu = usage.ru_utime.tv_sec+usage.ru_stime.tv_sec
+        + (usage.ru_utime.tv_usec+usage.ru_stime.tv_usec)/1e6;
+
+    header(out, "earl_resident_memory_bytes", "gauge", "Resident set size.");
+    sample(out, "earl_resident_memory_bytes", resident_bytes());
+    header(out, "earl_cpu_seconds_total", "counter", "User and system CPU time.");
+    sample(out, "earl_cpu_seconds_total", cpu);
+    header(out, "earl_uptime_seconds", "gauge", "Seconds since the interpreter started.");
+    sample(out, "earl_uptime_seconds", static_cast<double>(now_ns()-start_ns)/1e9);
+
+    return out;
+}
+
+// Written next to the file and renamed over it, so a
+// reader never sees one that is half written.
+static void
+write_file(void) {
+    const std::string tmp = out_path+".tmp";
+    {
+        std::ofstream f(tmp);
+        if (!f)
+            return;
+        f << render();
+        if (!f)
+            return;
+    }
+    (void)std::rename(tmp.c_str(), out_path.c_str());
+}
+
+static void
+writer_main(void) {
+    std::unique_lock<std::mutex> guard(writer_lock);
+    while (!stopping) {
+        wake.wait_for(guard, std::chrono::milliseconds(METRICS_INTERVAL_MS));
+        if (stopping)
+            break;
+        guard.unlock();
+        write_file();
+        guard.lock();
+    }
+}
+
+static void
+finish_atexit(void) {
+    {
+        std::lock_guard<std::mutex> guard(writer_lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    write_file();
+}
+
+void
+metrics::enable(const std::string &out) {
+    if (active)
+        return;
+    {
+        std::ofstream f(out, std::ios::app);
+        if (!f) {
+            std::cerr << "error: could not open `" << out << "` for the metrics" << std::endl;
+            std::exit(1);
+        }
+    }
+    out_path = out;
+    start_ns = now_ns();
+    active = true;
+    (void)alloc_stats::enable(false);
+
+    write_file();
+    writer = std::thread(writer_main);
+    std::atexit(finish_atexit);
+}
@@ -0,0 +1,155 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+#include <unistd.h>
+
+#include "output.hpp"
+
+#define OUTPUT_BUFSZ (64*1024)
+
+// Writes to fd 1 directly, so it does not depend on
+// C stdio and its own buffering at all.
+class OutBuf : public std::streambuf {
+public:
+    OutBuf() : m_buf(OUTPUT_BUFSZ), m_policy(output::Policy::Auto), m_line(false) {
+        setp(m_buf.data(), m_buf.data()+m_buf.size());
+        set_policy(output::Policy::Auto);
+    }
+
+    void set_policy(output::Policy policy) {
+        (void)sync();
+        m_policy = policy;
+        if (policy == output::Policy::Auto)
+            m_line = isatty(STDOUT_FILENO) == 1;
+        else
+            m_line = policy == output::Policy::Line;
+    }
+
+protected:
+    int sync() override {
+        const char *p = pbase();
+        size_t n = pptr()-pbase();
+        while (n > 0) {
+            ssize_t w = ::write(STDOUT_FILENO, p, n);
+            if (w == -1) {
+                if (errno == EINTR)
+                    continue;
+                // Nobody is reading anymore (closed pipe etc.),
+                // so drop it instead of trying forever.
+                break;
+            }
+            p += w;
+            n -= w;
+        }
+        setp(m_buf.data(), m_buf.data()+m_buf.size());
+        return 0;
+    }
+
+    int_type overflow(int_type c) override {
+        (void)sync();
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        if (m_policy == output::Policy::None || (m_line && c == '\n'))
+            (void)sync();
+        return c;
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        std::streamsize done = 0;
+        while (done < n) {
+            std::streamsize room = epptr()-pptr();
+            if (room == 0) {
+                (void)sync();
+                continue;
+            }
+            std::streamsize chunk = std::min(room, n-done);
+            std::memcpy(pptr(), s+done, chunk);
+            pbump(static_cast<int>(chunk));
+            done += chunk;
+        }
+        if (m_policy == output::Policy::None || (m_line && std::memchr(s, '\n', n)))
+            (void)sync();
+        return n;
+    }
+
+private:
+    std::vector<char> m_buf;
+    output::Policy m_policy;
+    bool m_line;
+};
+
+// Never freed, `std::cout` may still be flushed
+// by static destructors after main() returns.
+static OutBuf *g_outbuf = nullptr;
+
+static void
+flush_at_exit(void) {
+    output::flush();
+}
+
+void
+output::init(void) {
+    if (g_outbuf)
+        return;
+    g_outbuf = new OutBuf();
+    std::cout.flush();
+    std::cout.rdbuf(g_outbuf);
+    std::atexit(flush_at_exit);
+}
+
+void
+output::set_policy(Policy policy) {
+    if (g_outbuf)
+        g_outbuf->set_policy(policy);
+}
+
+bool
+output::policy_from_str(const std::string &name, Policy &policy) {
+    if (name == "auto")
+        policy = Policy::Auto;
+    else if (name == "line")
+        policy = Policy::Line;
+    else if (name == "full")
+        policy = Policy::Full;
+    else if (name == "none")
+        policy = Policy::None;
+    else
+        return false;
+    return true;
+}
+
+void
+output::flush(void) {
+    std::cout.flush();
+}
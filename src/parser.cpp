@@ -33,6 +33,13 @@
 #include "ast.hpp"
 #include "common.hpp"
 #include "parser.hpp"
+#include "profiler.hpp"
+#include "timing.hpp"
+
+namespace Parser {
+    // `parse_stmt` without recording the line of the statement.
+    static std::unique_ptr<Stmt> parse_stmt_wo_line(Lexer &lexer);
+};
 
 #define lexer_speek(l) lexer.peek(l) && lexer.peek(l)
 
@@ -54,6 +61,8 @@ translate_attr(Lexer &lexer) {
         return Attr::Const;
     if (attr->lexeme() == COMMON_EARLATTR_EXPERIMENTAL)
         return Attr::Experimental;
+    if (attr->lexeme() == COMMON_EARLATTR_ASYNC)
+        return Attr::Async;
     else {
         Err::err_wtok(errtok.get());
         std::string msg = "unknown attribute `" + attr->lexeme() + "`";
@@ -812,12 +821,32 @@ parse_stmt_foreach(Lexer &lexer) {
     uint32_t attrs = gather_attrs(lexer);
     auto enumerators = parse_comma_sep_idents_as_toks(lexer);
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_IN);
+
+    // foreach line in $"cmd" |> lines { ... }
+    bool bash_lines = false;
+    if (lexer.peek(0) && lexer.peek(0)->type() == TokenType::Dollarsign) {
+        lexer.discard(); // $
+        bash_lines = true;
+    }
+
     Expr *expr = Parser::parse_expr(lexer, /*fail_on=*/'{');
+
+    if (bash_lines) {
+        (void)Parser::parse_expect(lexer, TokenType::Pipe_Greaterthan);
+        auto lines = Parser::parse_expect(lexer, TokenType::Ident);
+        if (lines->lexeme() != "lines") {
+            Err::err_wtok(lines.get());
+            const std::string msg = "expected `lines` after `|>` in a `foreach` over a BASH command";
+            throw ParserException(msg);
+        }
+    }
+
     std::unique_ptr<StmtBlock> block = Parser::parse_stmt_block(lexer);
     return std::make_unique<StmtForeach>(std::move(enumerators),
                                          std::unique_ptr<Expr>(expr),
                                          std::move(block),
-                                         attrs);
+                                         attrs,
+                                         bash_lines);
 }
 
 std::unique_ptr<StmtFor>
@@ -1067,9 +1096,9 @@ parse_stmt_loop(Lexer &lexer) {
 
 static std::unique_ptr<StmtBashLiteral>
 parse_stmt_bash(Lexer &lexer) {
-    (void)Parser::parse_expect(lexer, TokenType::Dollarsign);
+    auto tok = Parser::parse_expect(lexer, TokenType::Dollarsign);
     auto expr = Parser::parse_expr(lexer);
-    return std::make_unique<StmtBashLiteral>(std::unique_ptr<Expr>(expr));
+    return std::make_unique<StmtBashLiteral>(std::unique_ptr<Expr>(expr), tok);
 }
 
 static std::unique_ptr<StmtMultilineBash>
@@ -1182,7 +1211,7 @@ parse_stmt_try(Lexer &lexer) {
 }
 
 std::unique_ptr<Stmt>
-Parser::parse_stmt(Lexer &lexer) {
+Parser::parse_stmt_wo_line(Lexer &lexer) {
 
     uint32_t attrs = 0;
     std::vector<std::string> info = {};
@@ -1317,8 +1346,20 @@ Parser::parse_stmt(Lexer &lexer) {
     return nullptr;
 }
 
+std::unique_ptr<Stmt>
+Parser::parse_stmt(Lexer &lexer) {
+    // The token does not outlive parsing, so the
+    // line is registered with the profiler now.
+    uint32_t line = profiler::lines_active ? profiler::line_id(lexer.peek()) : UINT32_MAX;
+    std::unique_ptr<Stmt> stmt = parse_stmt_wo_line(lexer);
+    if (stmt)
+        stmt->m_line = line;
+    return stmt;
+}
+
 std::unique_ptr<Program>
 Parser::parse_program(Lexer &lexer, const std::string filepath, std::string from) {
+    timing::Scope timer(timing::Phase::Parse);
     if ((config::runtime::flags & __VERBOSE) != 0)
         std::cout << "[EARL] parsing file " << filepath << std::endl;
 
@@ -109,6 +109,16 @@ Bool::eq(Obj *other) {
     return m_value == dynamic_cast<Bool *>(other)->value();
 }
 
+bool
+Bool::is_hashable(void) const {
+    return true;
+}
+
+size_t
+Bool::hash(void) {
+    return std::hash<bool>()(m_value);
+}
+
 std::string
 Bool::to_cxxstring(void) {
     return m_value ? "true" : "false";
@@ -0,0 +1,253 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+static const char hex_digits[] = "0123456789abcdef";
+
+Bytes::Bytes(std::vector<uint8_t> data)
+    : m_buf(std::make_shared<const std::vector<uint8_t>>(std::move(data))),
+      m_offset(0), m_len(m_buf->size()) {}
+
+Bytes::Bytes(std::shared_ptr<const std::vector<uint8_t>> buf, size_t offset, size_t len)
+    : m_buf(std::move(buf)), m_offset(offset), m_len(len) {}
+
+const uint8_t *
+Bytes::data(void) const {
+    return m_buf->data()+m_offset;
+}
+
+size_t
+Bytes::size(void) const {
+    return m_len;
+}
+
+std::shared_ptr<Obj>
+Bytes::nth(Obj *idx, Expr *expr) {
+    switch (idx->type()) {
+    case Type::Int: {
+        int64_t I = dynamic_cast<Int *>(idx)->value();
+        if (I < 0 || static_cast<size_t>(I) >= m_len) {
+            Err::err_wexpr(expr);
+            std::string msg = "index "+std::to_string(I)+" is out of bytes range of length "+std::to_string(m_len);
+            throw InterpreterException(msg);
+        }
+        return std::make_shared<Int>(static_cast<int64_t>(this->data()[I]));
+    } break;
+    case Type::Slice: {
+        auto slice = dynamic_cast<Slice *>(idx);
+        return this->slice(slice->start().get(), slice->end().get(), expr);
+    } break;
+    default: {
+        Err::err_wexpr(expr);
+        std::string msg = "invalid index value when accessing value in bytes";
+        throw InterpreterException(msg);
+    }
+    }
+    return nullptr; // unreachable
+}
+
+std::shared_ptr<Bytes>
+Bytes::slice(Obj *start, Obj *end, Expr *expr) {
+    if (start->type() != Type::Int && start->type() != Type::Void) {
+        Err::err_wexpr(expr);
+        std::string msg = "invalid slice `start` type: `"+type_to_str(start->type())+"`";
+        throw InterpreterException(msg);
+    }
+    if (end->type() != Type::Int && end->type() != Type::Void) {
+        Err::err_wexpr(expr);
+        std::string msg = "invalid slice `end` type: `"+type_to_str(end->type())+"`";
+        throw InterpreterException(msg);
+    }
+
+    int64_t s = start->type() == Type::Void ? 0 : dynamic_cast<Int *>(start)->value();
+    int64_t e = end->type() == Type::Void ? static_cast<int64_t>(m_len) : dynamic_cast<Int *>(end)->value();
+
+    if (s < 0 || e < s || static_cast<size_t>(e) > m_len) {
+        Err::err_wexpr(expr);
+        std::string msg = "slice ["+std::to_string(s)+":"+std::to_string(e)+"] is out of range for bytes of length "+std::to_string(m_len);
+        throw InterpreterException(msg);
+    }
+
+    return std::make_shared<Bytes>(m_buf, m_offset+s, static_cast<size_t>(e-s));
+}
+
+int64_t
+Bytes::find(const uint8_t *needle, size_t len, size_t start) const {
+    if (start > m_len || len > m_len-start)
+        return -1;
+    if (len == 0)
+        return static_cast<int64_t>(start);
+    const void *p = memmem(this->data()+start, m_len-start, needle, len);
+    if (!p)
+        return -1;
+    return static_cast<const uint8_t *>(p)-this->data();
+}
+
+std::string
+Bytes::hex(void) const {
+    std::string res(m_len*2, '0');
+    const uint8_t *p = this->data();
+    for (size_t i = 0; i < m_len; ++i) {
+        res[i*2] = hex_digits[p[i] >> 4];
+        res[i*2+1] = hex_digits[p[i] & 0xf];
+    }
+    return res;
+}
+
+uint64_t
+Bytes::decode_uint(size_t offset, size_t width, bool big_endian) const {
+    const uint8_t *p = this->data()+offset;
+    uint64_t res = 0;
+    if (big_endian) {
+        for (size_t i = 0; i < width; ++i)
+            res = (res << 8) | p[i];
+    }
+    else {
+        for (size_t i = width; i > 0; --i)
+            res = (res << 8) | p[i-1];
+    }
+    return res;
+}
+
+uint32_t
+Bytes::crc32(void) const {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xffffffffu;
+    const uint8_t *p = this->data();
+    for (size_t i = 0; i < m_len; ++i)
+        crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffffu;
+}
+
+/*** OVERRIDES ***/
+Type
+Bytes::type(void) const {
+    return Type::Bytes;
+}
+
+bool
+Bytes::boolean(void) {
+    return m_len != 0;
+}
+
+void
+Bytes::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    auto other_bytes = dynamic_cast<Bytes *>(other);
+    m_buf = other_bytes->m_buf;
+    m_offset = other_bytes->m_offset;
+    m_len = other_bytes->m_len;
+}
+
+std::shared_ptr<Obj>
+Bytes::copy(void) {
+    return std::make_shared<Bytes>(m_buf, m_offset, m_len);
+}
+
+bool
+Bytes::eq(Obj *other) {
+    if (this->type() != other->type())
+        return false;
+    auto other_bytes = dynamic_cast<Bytes *>(other);
+    return m_len == other_bytes->m_len
+        && std::memcmp(this->data(), other_bytes->data(), m_len) == 0;
+}
+
+bool
+Bytes::is_hashable(void) const {
+    return true;
+}
+
+size_t
+Bytes::hash(void) {
+    return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char *>(this->data()), m_len));
+}
+
+std::string
+Bytes::to_cxxstring(void) {
+    std::string res = "b\"";
+    const uint8_t *p = this->data();
+    for (size_t i = 0; i < m_len; ++i) {
+        uint8_t c = p[i];
+        if (c == '"' || c == '\\') {
+            res += '\\';
+            res += static_cast<char>(c);
+        }
+        else if (c >= 0x20 && c < 0x7f)
+            res += static_cast<char>(c);
+        else {
+            res += "\\x";
+            res += hex_digits[c >> 4];
+            res += hex_digits[c & 0xf];
+        }
+    }
+    res += '"';
+    return res;
+}
+
+std::shared_ptr<Obj>
+Bytes::add(Token *op, Obj *other) {
+    ASSERT_BINOP_COMPAT(this, other, op);
+    auto other_bytes = dynamic_cast<Bytes *>(other);
+    std::vector<uint8_t> data(this->data(), this->data()+m_len);
+    data.insert(data.end(), other_bytes->data(), other_bytes->data()+other_bytes->size());
+    return std::make_shared<Bytes>(std::move(data));
+}
+
+std::shared_ptr<Obj>
+Bytes::equality(Token *op, Obj *other) {
+    ASSERT_BINOP_COMPAT(this, other, op);
+    switch (op->type()) {
+    case TokenType::Double_Equals: return std::make_shared<Bool>(this->eq(other));
+    case TokenType::Bang_Equals:   return std::make_shared<Bool>(!this->eq(other));
+    default: {
+        Err::err_wtok(op);
+        const std::string msg = "invalid operator";
+        throw InterpreterException(msg);
+    } break;
+    }
+    return nullptr; // unreachable
+}
@@ -107,6 +107,16 @@ Char::eq(Obj *other) {
     return this->value() == dynamic_cast<Char *>(other)->value();
 }
 
+bool
+Char::is_hashable(void) const {
+    return true;
+}
+
+size_t
+Char::hash(void) {
+    return std::hash<char>()(m_value);
+}
+
 std::string
 Char::to_cxxstring(void) {
     return std::string(1, m_value);
@@ -30,6 +30,9 @@
 #include "common.hpp"
 #include "ctx.hpp"
 #include "interpreter.hpp"
+#include "profiler.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
 
 using namespace earl::value;
 
@@ -68,6 +71,9 @@ std::shared_ptr<Obj>
 Closure::call(std::vector<std::shared_ptr<earl::value::Obj>> &values, std::shared_ptr<Ctx> &ctx) {
     ctx->push_scope();
     load_parameters(values, ctx);
+    profiler::Scope prof(this->tok());
+    trace::Span span(this->tok());
+    metrics::count(metrics::closure_calls);
     auto result = Interpreter::eval_stmt_block(this->block(), ctx);
     ctx->pop_scope();
     return result;
@@ -0,0 +1,188 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <iostream>
+#include <cassert>
+#include <memory>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+#define DEQUE_INITIAL_CAPACITY 8
+
+Deque::Deque(std::vector<std::shared_ptr<Obj>> values) : m_head(0), m_size(0) {
+    size_t cap = DEQUE_INITIAL_CAPACITY;
+    while (cap < values.size())
+        cap <<= 1;
+    m_buf.resize(cap, nullptr);
+    for (auto &v : values)
+        this->push_back(v);
+}
+
+void
+Deque::grow(void) {
+    std::vector<std::shared_ptr<Obj>> buf(m_buf.size() << 1, nullptr);
+    for (size_t i = 0; i < m_size; ++i)
+        buf[i] = std::move(this->at(i));
+    m_buf = std::move(buf);
+    m_head = 0;
+}
+
+std::shared_ptr<Obj> &
+Deque::at(size_t idx) {
+    return m_buf[(m_head + idx) & (m_buf.size() - 1)];
+}
+
+void
+Deque::push_back(std::shared_ptr<Obj> value) {
+    if (m_size == m_buf.size())
+        this->grow();
+    m_buf[(m_head + m_size) & (m_buf.size() - 1)] = std::move(value);
+    ++m_size;
+}
+
+void
+Deque::push_front(std::shared_ptr<Obj> value) {
+    if (m_size == m_buf.size())
+        this->grow();
+    m_head = (m_head - 1) & (m_buf.size() - 1);
+    m_buf[m_head] = std::move(value);
+    ++m_size;
+}
+
+std::shared_ptr<Obj>
+Deque::pop_back(Expr *expr) {
+    if (m_size == 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot `pop_back` from an empty deque";
+        throw InterpreterException(msg);
+    }
+    auto value = std::move(this->at(m_size - 1));
+    --m_size;
+    return value;
+}
+
+std::shared_ptr<Obj>
+Deque::pop_front(Expr *expr) {
+    if (m_size == 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot `pop_front` from an empty deque";
+        throw InterpreterException(msg);
+    }
+    auto value = std::move(m_buf[m_head]);
+    m_head = (m_head + 1) & (m_buf.size() - 1);
+    --m_size;
+    return value;
+}
+
+std::shared_ptr<Obj>
+Deque::front(Expr *expr) {
+    if (m_size == 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot get the `front` of an empty deque";
+        throw InterpreterException(msg);
+    }
+    return this->at(0);
+}
+
+std::shared_ptr<Obj>
+Deque::back(Expr *expr) {
+    if (m_size == 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot get the `back` of an empty deque";
+        throw InterpreterException(msg);
+    }
+    return this->at(m_size - 1);
+}
+
+size_t
+Deque::size(void) const {
+    return m_size;
+}
+
+bool
+Deque::empty(void) const {
+    return m_size == 0;
+}
+
+/*** OVERRIDES ***/
+Type
+Deque::type(void) const {
+    return Type::Deque;
+}
+
+bool
+Deque::boolean(void) {
+    return m_size > 0;
+}
+
+void
+Deque::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    auto other_deque = dynamic_cast<Deque *>(other);
+    m_buf = other_deque->m_buf;
+    m_head = other_deque->m_head;
+    m_size = other_deque->m_size;
+}
+
+std::shared_ptr<Obj>
+Deque::copy(void) {
+    std::vector<std::shared_ptr<Obj>> values = {};
+    values.reserve(m_size);
+    for (size_t i = 0; i < m_size; ++i)
+        values.push_back(this->at(i)->copy());
+    auto value = std::make_shared<Deque>(values);
+    value->set_owner(m_var_owner);
+    return value;
+}
+
+bool
+Deque::eq(Obj *other) {
+    if (other->type() != Type::Deque)
+        return false;
+
+    auto other_deque = dynamic_cast<Deque *>(other);
+    if (m_size != other_deque->size())
+        return false;
+
+    for (size_t i = 0; i < m_size; ++i)
+        if (!this->at(i)->eq(other_deque->at(i).get()))
+            return false;
+    return true;
+}
+
+std::string
+Deque::to_cxxstring(void) {
+    std::string res = "<Deque [ ";
+    for (size_t i = 0; i < m_size; ++i) {
+        res += this->at(i)->to_cxxstring();
+        if (i != m_size-1)
+            res += ", ";
+    }
+    res += " ]>";
+    return res;
+}
@@ -28,16 +28,26 @@
 #include <fstream>
 #include <cassert>
 #include <memory>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include "earl.hpp"
 #include "err.hpp"
 #include "utils.hpp"
+#include "trace.hpp"
 
 using namespace earl::value;
 
 File::File(std::shared_ptr<Str> fp, std::shared_ptr<Str> mode, std::fstream stream)
     : m_fp(fp), m_mode(mode),
-      m_stream(std::move(stream)), m_open(false), m_mode_actual(0) {
+      m_stream(std::move(stream)), m_open(false), m_mode_actual(0),
+      m_wfd(-1), m_wbuf(""), m_wbuf_cap(0) {
     const std::string &literal = m_mode->value();
     for (char c : literal) {
         switch (c) {
@@ -52,6 +62,128 @@ File::File(std::shared_ptr<Str> fp, std::shared_ptr<Str> mode, std::fstream stre
     }
 }
 
+File::~File() {
+    if (m_wfd == -1)
+        return;
+    try {
+        flush();
+    } catch (const InterpreterException &) {
+        // Nowhere left to report it.
+    }
+    ::close(m_wfd);
+}
+
+// Keep writing until all of `iov` is out, a short write only
+// means that the rest has to be tried again.
+static void
+writev_all(int fd, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            std::string msg = std::string("could not write to file: ")+strerror(errno);
+            throw InterpreterException(msg);
+        }
+        while (iovcnt > 0 && static_cast<size_t>(n) >= iov->iov_len) {
+            n -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char *>(iov->iov_base)+n;
+            iov->iov_len -= n;
+        }
+    }
+}
+
+// Append the text of `value` to `out`, like `write` puts it in the file.
+static void
+format_for_file(Obj *value, std::string &out) {
+    switch (value->type()) {
+    case Type::Int: {
+        out += value->to_cxxstring();
+    } break;
+    case Type::Char: {
+        out += dynamic_cast<Char *>(value)->value();
+    } break;
+    case Type::Str: {
+        auto str = dynamic_cast<Str *>(value);
+        str->update_changed();
+        out += str->value_asref();
+    } break;
+    default: {
+        std::string msg = "cannot write `"+type_to_str(value->type())+"` type to a file";
+        throw InterpreterException(msg);
+    } break;
+    }
+}
+
+void
+File::set_write_buffer(size_t size) {
+    if ((m_mode_actual & static_cast<uint32_t>(Mode::Write)) == 0) {
+        std::string msg = "a write buffer needs a file that is open for writing";
+        throw InterpreterException(msg);
+    }
+    // The stream already created (and truncated) the file, this
+    // is only a second handle to the same file.
+    m_wfd = ::open(m_fp->value_asref().c_str(), O_WRONLY|O_CLOEXEC);
+    if (m_wfd == -1) {
+        std::string msg = "could not open `"+m_fp->value()+"` for buffered writing: "+strerror(errno);
+        throw InterpreterException(msg);
+    }
+    m_wbuf_cap = size;
+    m_wbuf.reserve(size);
+}
+
+void
+File::flush(void) {
+    if (!m_open) {
+        std::string msg = "file is not open";
+        throw InterpreterException(msg);
+    }
+    if (m_wfd == -1) {
+        m_stream.flush();
+        return;
+    }
+    if (m_wbuf.empty())
+        return;
+    trace::Span span("file", "flush");
+    span.arg("path", m_fp->value_asref());
+    span.arg("bytes", static_cast<int64_t>(m_wbuf.size()));
+    struct iovec iov = {const_cast<char *>(m_wbuf.data()), m_wbuf.size()};
+    writev_all(m_wfd, &iov, 1);
+    m_wbuf.clear();
+}
+
+void
+File::write_raw(const char *data, size_t len) {
+    trace::Span span("file", "write");
+    span.arg("path", m_fp->value_asref());
+    span.arg("bytes", static_cast<int64_t>(len));
+    if (m_wfd == -1) {
+        m_stream.write(data, len);
+        return;
+    }
+    if (m_wbuf.size()+len <= m_wbuf_cap) {
+        m_wbuf.append(data, len);
+        return;
+    }
+    if (len < m_wbuf_cap) {
+        flush();
+        m_wbuf.append(data, len);
+        return;
+    }
+    // Too big to ever fit, so it goes out together with
+    // the buffer in one call without being copied into it.
+    struct iovec iov[2] = {
+        {const_cast<char *>(m_wbuf.data()), m_wbuf.size()},
+        {const_cast<char *>(data), len},
+    };
+    writev_all(m_wfd, iov, 2);
+    m_wbuf.clear();
+}
+
 void
 File::set_open(void) {
     m_open = true;
@@ -72,8 +204,15 @@ File::dump(void) {
         std::string msg = "file is not open for reading";
         throw InterpreterException(msg);
     }
+    if (m_wfd != -1)
+        this->flush();
+    m_stream.clear();
     m_stream.seekg(0, std::ios::beg);
-    std::cout << m_stream.rdbuf();
+    // Inserting an empty buffer sets failbit on std::cout,
+    // which would swallow everything printed after it.
+    if (m_stream.peek() != std::char_traits<char>::eof())
+        std::cout << m_stream.rdbuf();
+    m_stream.clear();
 }
 
 void
@@ -82,6 +221,13 @@ File::close(void) {
         std::string msg = "file is not open";
         throw InterpreterException(msg);
     }
+    trace::Span span("file", "close");
+    span.arg("path", m_fp->value_asref());
+    flush();
+    if (m_wfd != -1) {
+        ::close(m_wfd);
+        m_wfd = -1;
+    }
     m_stream.close();
     this->set_closed();
 }
@@ -96,10 +242,114 @@ File::read(void) {
         std::string msg = "file is not open for reading";
         throw InterpreterException(msg);
     }
+
+    trace::Span span("file", "read");
+    span.arg("path", m_fp->value_asref());
+
+    // Anything still sitting in a buffer has to be
+    // in the file before it is mapped.
+    if ((m_mode_actual & static_cast<uint32_t>(Mode::Write)) != 0)
+        flush();
+
+    int fd = ::open(m_fp->value_asref().c_str(), O_RDONLY|O_CLOEXEC);
+    if (fd != -1) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            size_t size = static_cast<size_t>(st.st_size);
+            void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                (void)madvise(data, size, MADV_SEQUENTIAL);
+                auto str = std::make_shared<earl::value::Str>(std::string(static_cast<const char *>(data), size));
+                munmap(data, size);
+                ::close(fd);
+                span.arg("bytes", static_cast<int64_t>(size));
+                return str;
+            }
+        }
+        ::close(fd);
+    }
+
+    // Not a regular file (or it could not be mapped), go through the stream.
+    m_stream.clear();
     m_stream.seekg(0, std::ios::beg);
     std::stringstream buf;
     buf << m_stream.rdbuf();
-    return std::make_shared<earl::value::Str>(buf.str());
+    auto str = std::make_shared<earl::value::Str>(buf.str());
+    span.arg("bytes", static_cast<int64_t>(str->value_asref().size()));
+    return str;
+}
+
+void
+File::rewind(void) {
+    if (!m_open) {
+        std::string msg = "file is not open";
+        throw InterpreterException(msg);
+    }
+    if ((m_mode_actual & static_cast<uint32_t>(Mode::Read)) == 0) {
+        std::string msg = "file is not open for reading";
+        throw InterpreterException(msg);
+    }
+    m_stream.clear();
+    m_stream.seekg(0, std::ios::beg);
+}
+
+bool
+File::next_line(std::string &line) {
+    if (!m_open) {
+        std::string msg = "file is not open";
+        throw InterpreterException(msg);
+    }
+    return static_cast<bool>(std::getline(m_stream, line));
+}
+
+std::shared_ptr<Bytes>
+File::read_bytes(int64_t n) {
+    if (!m_open) {
+        std::string msg = "file is not open";
+        throw InterpreterException(msg);
+    }
+    if ((m_mode_actual & static_cast<uint32_t>(Mode::Read)) == 0) {
+        std::string msg = "file is not open for reading";
+        throw InterpreterException(msg);
+    }
+
+    trace::Span span("file", "read_bytes");
+    span.arg("path", m_fp->value_asref());
+
+    std::vector<uint8_t> data;
+    if (n >= 0) {
+        data.resize(static_cast<size_t>(n));
+        m_stream.read(reinterpret_cast<char *>(data.data()), n);
+        data.resize(static_cast<size_t>(m_stream.gcount()));
+    }
+    else {
+        // Size the buffer once from what is left of the file
+        // instead of growing it chunk by chunk.
+        std::streampos pos = m_stream.tellg();
+        m_stream.seekg(0, std::ios::end);
+        std::streampos end = m_stream.tellg();
+        if (pos != std::streampos(-1) && end != std::streampos(-1) && end > pos) {
+            m_stream.seekg(pos);
+            data.resize(static_cast<size_t>(end-pos));
+            m_stream.read(reinterpret_cast<char *>(data.data()), end-pos);
+            data.resize(static_cast<size_t>(m_stream.gcount()));
+        }
+        else {
+            m_stream.clear();
+            if (pos != std::streampos(-1))
+                m_stream.seekg(pos);
+            char buf[8192];
+            while (m_stream.read(buf, sizeof(buf)) || m_stream.gcount() > 0)
+                data.insert(data.end(), buf, buf+m_stream.gcount());
+        }
+    }
+
+    // A short read leaves eof set, which would stop any read after a rewind.
+    if (m_stream.eof())
+        m_stream.clear();
+
+    span.arg("bytes", static_cast<int64_t>(data.size()));
+    return std::make_shared<Bytes>(std::move(data));
 }
 
 void
@@ -114,30 +364,58 @@ File::write(std::shared_ptr<Obj> value) {
         throw InterpreterException(msg);
     }
 
-    switch (value->type()) {
-    case Type::Int: {
-        auto _int = dynamic_cast<Int *>(value.get());
-        m_stream << _int->value();
-    } break;
-    case Type::Char: {
-        auto _char = dynamic_cast<Char *>(value.get());
-        m_stream << _char->value();
-    } break;
-    case Type::Str: {
+    // Strings go straight into the buffer without a copy in between.
+    if (value->type() == Type::Str) {
         auto str = dynamic_cast<Str *>(value.get());
-        m_stream << str->value();
-    } break;
-    default: {
-        std::string msg = "cannot write `"+type_to_str(value->type())+"` type to a file";
+        str->update_changed();
+        write_raw(str->value_asref().data(), str->value_asref().size());
+        return;
+    }
+
+    if (value->type() == Type::Bytes) {
+        auto bytes = dynamic_cast<Bytes *>(value.get());
+        write_raw(reinterpret_cast<const char *>(bytes->data()), bytes->size());
+        return;
+    }
+
+    std::string text = "";
+    format_for_file(value.get(), text);
+    write_raw(text.data(), text.size());
+}
+
+void
+File::write_bytes(Bytes *value) {
+    if (!m_open) {
+        std::string msg = "file is not open";
         throw InterpreterException(msg);
-    } break;
     }
+
+    if ((m_mode_actual & static_cast<uint32_t>(Mode::Write)) == 0) {
+        std::string msg = "file is not open for writing";
+        throw InterpreterException(msg);
+    }
+
+    write_raw(reinterpret_cast<const char *>(value->data()), value->size());
 }
 
 void
 File::writelines(std::shared_ptr<List> &value) {
-    (void)value;
-    UNIMPLEMENTED("File::writelines");
+    if (!m_open) {
+        std::string msg = "file is not open";
+        throw InterpreterException(msg);
+    }
+
+    if ((m_mode_actual & static_cast<uint32_t>(Mode::Write)) == 0) {
+        std::string msg = "file is not open for writing";
+        throw InterpreterException(msg);
+    }
+
+    std::string text = "";
+    for (auto &elem : value->value()) {
+        format_for_file(elem.get(), text);
+        text += '\n';
+    }
+    write_raw(text.data(), text.size());
 }
 
 /*** OVERRIDES ***/
@@ -56,22 +56,22 @@ Float::binop(Token *op, Obj *other) {
     switch (op->type()) {
     case TokenType::Plus: {
         return other->type() == Type::Int ?
-            std::make_shared<Float>(this->value() + dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Float>(this->value() + dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Float>(this->value() + dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Minus: {
         return other->type() == Type::Int ?
-            std::make_shared<Float>(this->value() - dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Float>(this->value() - dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Float>(this->value() - dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Asterisk: {
         return other->type() == Type::Int ?
-            std::make_shared<Float>(this->value() * dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Float>(this->value() * dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Float>(this->value() * dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Forwardslash: {
         return other->type() == Type::Int ?
-            std::make_shared<Float>(this->value() / dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Float>(this->value() / dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Float>(this->value() / dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Percent: {
@@ -79,50 +79,50 @@ Float::binop(Token *op, Obj *other) {
         throw InterpreterException(msg);
     } break;
     case TokenType::Double_Asterisk: {
-        float p = 0.;
+        double p = 0.0;
         if (other->type() == earl::value::Type::Float) {
             auto _other = dynamic_cast<earl::value::Float *>(other);
-            p = std::pow(static_cast<float>(m_value), static_cast<float>(_other->value()));
+            p = std::pow(m_value, _other->value());
         }
         else {
             auto _other = dynamic_cast<earl::value::Int *>(other);
-            p = std::pow(static_cast<float>(m_value), static_cast<float>(_other->value()));
+            p = std::pow(m_value, _other->as_double());
         }
-        return std::make_shared<earl::value::Float>(static_cast<double>(p));
+        return std::make_shared<earl::value::Float>(p);
     } break;
     case TokenType::Lessthan: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() < dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() < dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() < dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Greaterthan: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() > dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() > dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() > dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Double_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() == dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() == dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() == dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Greaterthan_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() >= dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() >= dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() >= dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Lessthan_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() <= dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() <= dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() <= dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Bang_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() != dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() != dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() != dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Double_Pipe: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() || dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() || dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() || dynamic_cast<Float *>(other)->value());
     } break;
     default: {
@@ -148,7 +148,7 @@ Float::mutate(Obj *other, StmtMut *stmt) {
         m_value = dynamic_cast<Float *>(other)->value();
     } break;
     case Type::Int: {
-        m_value = static_cast<double>(dynamic_cast<Int *>(other)->value());
+        m_value = static_cast<double>(dynamic_cast<Int *>(other)->as_double());
     } break;
     default: {
         assert(false && "unreachable");
@@ -173,6 +173,16 @@ Float::eq(Obj *other) {
     return this->value() == dynamic_cast<Float *>(other)->value();
 }
 
+bool
+Float::is_hashable(void) const {
+    return true;
+}
+
+size_t
+Float::hash(void) {
+    return std::hash<double>()(m_value);
+}
+
 std::string
 Float::to_cxxstring(void) {
     return std::to_string(m_value);
@@ -187,7 +197,7 @@ Float::spec_mutate(Token *op, Obj *other, StmtMut *stmt) {
         || op->type() == TokenType::Forwardslash_Equals
         || op->type() == TokenType::Percent_Equals) {
         if (other->type() == Type::Int)
-            prev = static_cast<int>(dynamic_cast<Int *>(other)->value());
+            prev = dynamic_cast<Int *>(other)->as_double();
         else if (other->type() == Type::Float)
             prev = dynamic_cast<Float *>(other)->value();
         else {
@@ -242,7 +252,7 @@ std::shared_ptr<Obj>
 Float::add(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     return other->type() == Type::Int ?
-        std::make_shared<Float>(this->value() + dynamic_cast<Int *>(other)->value()) :
+        std::make_shared<Float>(this->value() + dynamic_cast<Int *>(other)->as_double()) :
         std::make_shared<Float>(this->value() + dynamic_cast<Float *>(other)->value());
 }
 
@@ -250,7 +260,7 @@ std::shared_ptr<Obj>
 Float::sub(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     return other->type() == Type::Int ?
-        std::make_shared<Float>(this->value() - dynamic_cast<Int *>(other)->value()) :
+        std::make_shared<Float>(this->value() - dynamic_cast<Int *>(other)->as_double()) :
         std::make_shared<Float>(this->value() - dynamic_cast<Float *>(other)->value());
 }
 
@@ -258,7 +268,7 @@ std::shared_ptr<Obj>
 Float::multiply(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     return other->type() == Type::Int ?
-        std::make_shared<Float>(this->value() * dynamic_cast<Int *>(other)->value()) :
+        std::make_shared<Float>(this->value() * dynamic_cast<Int *>(other)->as_double()) :
         std::make_shared<Float>(this->value() * dynamic_cast<Float *>(other)->value());
 }
 
@@ -266,23 +276,23 @@ std::shared_ptr<Obj>
 Float::divide(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     return other->type() == Type::Int ?
-        std::make_shared<Float>(this->value() / dynamic_cast<Int *>(other)->value()) :
+        std::make_shared<Float>(this->value() / dynamic_cast<Int *>(other)->as_double()) :
         std::make_shared<Float>(this->value() / dynamic_cast<Float *>(other)->value());
 }
 
 std::shared_ptr<Obj>
 Float::power(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
-    float p = 0.f;
+    double p = 0.0;
     if (other->type() == earl::value::Type::Float) {
         auto _other = dynamic_cast<earl::value::Float *>(other);
-        p = std::pow(static_cast<float>(m_value), static_cast<float>(_other->value()));
+        p = std::pow(m_value, _other->value());
     }
     else {
         auto _other = dynamic_cast<earl::value::Int *>(other);
-        p = std::pow(static_cast<float>(m_value), static_cast<float>(_other->value()));
+        p = std::pow(m_value, _other->as_double());
     }
-    return std::make_shared<earl::value::Float>(static_cast<double>(p));
+    return std::make_shared<earl::value::Float>(p);
 }
 
 std::shared_ptr<Obj>
@@ -291,22 +301,22 @@ Float::gtequality(Token *op, Obj *other) {
     switch (op->type()) {
     case TokenType::Lessthan: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() < dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() < dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() < dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Greaterthan: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() > dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() > dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() > dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Greaterthan_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() >= dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() >= dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() >= dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Lessthan_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() <= dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() <= dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() <= dynamic_cast<Float *>(other)->value());
     } break;
     default: {
@@ -324,12 +334,12 @@ Float::equality(Token *op, Obj *other) {
     switch (op->type()) {
     case TokenType::Double_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() == dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() == dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() == dynamic_cast<Float *>(other)->value());
     } break;
     case TokenType::Bang_Equals: {
         return other->type() == Type::Int ?
-            std::make_shared<Bool>(this->value() != dynamic_cast<Int *>(other)->value()) :
+            std::make_shared<Bool>(this->value() != dynamic_cast<Int *>(other)->as_double()) :
             std::make_shared<Bool>(this->value() != dynamic_cast<Float *>(other)->value());
     } break;
     default: {
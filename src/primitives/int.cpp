@@ -25,6 +25,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <memory>
 
 #include "earl.hpp"
@@ -33,21 +34,186 @@
 
 using namespace earl::value;
 
-Int::Int(int value) : m_value(value) {}
+/*** OVERFLOW-CHECKED ARITHMETIC ***/
+// Every operation first tries plain 64 bit arithmetic and only
+// goes through BigInt when an operand is already big or the
+// builtin reports an overflow, so the common case stays cheap.
+
+static std::shared_ptr<Int>
+add_ints(Int *a, Int *b) {
+    int64_t res;
+    if (!a->is_big() && !b->is_big() && !__builtin_add_overflow(a->value(), b->value(), &res))
+        return std::make_shared<Int>(res);
+    return std::make_shared<Int>(a->as_big() + b->as_big());
+}
+
+static std::shared_ptr<Int>
+sub_ints(Int *a, Int *b) {
+    int64_t res;
+    if (!a->is_big() && !b->is_big() && !__builtin_sub_overflow(a->value(), b->value(), &res))
+        return std::make_shared<Int>(res);
+    return std::make_shared<Int>(a->as_big() - b->as_big());
+}
+
+static std::shared_ptr<Int>
+mul_ints(Int *a, Int *b) {
+    int64_t res;
+    if (!a->is_big() && !b->is_big() && !__builtin_mul_overflow(a->value(), b->value(), &res))
+        return std::make_shared<Int>(res);
+    return std::make_shared<Int>(a->as_big() * b->as_big());
+}
+
+static void
+assert_nonzero_divisor(Token *op, Int *b) {
+    if (!b->is_big() && b->value() == 0) {
+        Err::err_wtok(op);
+        const std::string msg = "division by zero";
+        throw InterpreterException(msg);
+    }
+}
+
+static std::shared_ptr<Int>
+div_ints(Token *op, Int *a, Int *b) {
+    assert_nonzero_divisor(op, b);
+    // INT64_MIN / -1 is the only quotient that overflows.
+    if (!a->is_big() && !b->is_big() && !(a->value() == INT64_MIN && b->value() == -1))
+        return std::make_shared<Int>(a->value() / b->value());
+    return std::make_shared<Int>(a->as_big() / b->as_big());
+}
+
+static std::shared_ptr<Int>
+mod_ints(Token *op, Int *a, Int *b) {
+    assert_nonzero_divisor(op, b);
+    if (!a->is_big() && !b->is_big())
+        return std::make_shared<Int>(b->value() == -1 ? 0 : a->value() % b->value());
+    return std::make_shared<Int>(a->as_big() % b->as_big());
+}
 
-int
+static int
+cmp_ints(Int *a, Int *b) {
+    if (!a->is_big() && !b->is_big())
+        return (a->value() > b->value()) - (a->value() < b->value());
+    return a->as_big().cmp(b->as_big());
+}
+
+static void
+assert_not_big(Token *op, Int *a, Int *b) {
+    if (a->is_big() || (b && b->is_big())) {
+        Err::err_wtok(op);
+        const std::string msg = "operator `"+op->lexeme()+"` is not supported on integers larger than 64 bits";
+        throw InterpreterException(msg);
+    }
+}
+
+static std::shared_ptr<Int>
+shl_ints(Token *op, Int *a, Int *b) {
+    assert_not_big(op, b, nullptr);
+    int64_t n = b->value(), v = a->value();
+    if (n < 0) {
+        Err::err_wtok(op);
+        const std::string msg = "cannot shift by a negative amount";
+        throw InterpreterException(msg);
+    }
+    if (!a->is_big() && n < 63 && v >= (INT64_MIN >> n) && v <= (INT64_MAX >> n))
+        return std::make_shared<Int>(static_cast<int64_t>(static_cast<uint64_t>(v) << n));
+    return std::make_shared<Int>(a->as_big() << static_cast<size_t>(n));
+}
+
+// Exponentiation by squaring. Negative exponents truncate
+// toward zero like integer division.
+static std::shared_ptr<Int>
+pow_ints(Token *op, Int *base, Int *exp) {
+    assert_not_big(op, exp, nullptr);
+    int64_t e = exp->value();
+
+    if (e < 0) {
+        if (!base->is_big() && base->value() == 0) {
+            Err::err_wtok(op);
+            const std::string msg = "cannot raise zero to a negative power";
+            throw InterpreterException(msg);
+        }
+        if (!base->is_big() && base->value() == 1)
+            return std::make_shared<Int>(1);
+        if (!base->is_big() && base->value() == -1)
+            return std::make_shared<Int>((e & 1) ? -1 : 1);
+        return std::make_shared<Int>(0);
+    }
+
+    if (!base->is_big()) {
+        int64_t res = 1, b = base->value(), n = e;
+        bool overflow = false;
+        while (n) {
+            if ((n & 1) && __builtin_mul_overflow(res, b, &res)) {
+                overflow = true;
+                break;
+            }
+            n >>= 1;
+            if (n && __builtin_mul_overflow(b, b, &b)) {
+                overflow = true;
+                break;
+            }
+        }
+        if (!overflow)
+            return std::make_shared<Int>(res);
+    }
+
+    BigInt res(1), b = base->as_big();
+    for (int64_t n = e; n; n >>= 1) {
+        if (n & 1)
+            res = res * b;
+        if (n > 1)
+            b = b * b;
+    }
+    return std::make_shared<Int>(res);
+}
+
+Int::Int(int64_t value) : m_value(value) {}
+
+Int::Int(const BigInt &value) {
+    if (value.fits_i64()) {
+        m_value = value.to_i64();
+        return;
+    }
+    m_big = std::make_shared<BigInt>(value);
+    m_value = value.m_neg ? INT64_MIN : INT64_MAX;
+}
+
+int64_t
 Int::value(void) {
     return m_value;
 }
 
+bool
+Int::is_big(void) const {
+    return m_big != nullptr;
+}
+
+BigInt
+Int::as_big(void) const {
+    return m_big ? *m_big : BigInt(m_value);
+}
+
+double
+Int::as_double(void) const {
+    return m_big ? m_big->to_double() : static_cast<double>(m_value);
+}
+
 void
-Int::fill(int value) {
+Int::fill(int64_t value) {
     m_value = value;
+    m_big = nullptr;
 }
 
 void
 Int::incr(void) {
-    ++m_value;
+    if (!m_big && m_value != INT64_MAX) {
+        ++m_value;
+        return;
+    }
+    Int one(1);
+    auto res = add_ints(this, &one);
+    m_value = res->m_value;
+    m_big = res->m_big;
 }
 
 Type
@@ -94,12 +260,9 @@ Int::binop(Token *op, Obj *other) {
     case TokenType::Double_Asterisk: {
         if (other->type() == earl::value::Type::Float) {
             auto _other = dynamic_cast<earl::value::Float *>(other);
-            float p = std::pow(static_cast<float>(m_value), static_cast<float>(_other->value()));
-            return std::make_shared<earl::value::Float>(p);
+            return std::make_shared<earl::value::Float>(std::pow(this->as_double(), _other->value()));
         }
-        auto _other = dynamic_cast<earl::value::Int *>(other);
-        int p = static_cast<int>(std::pow(static_cast<float>(m_value), static_cast<float>(_other->value())));
-        return std::make_shared<earl::value::Int>(p);
+        return pow_ints(op, this, dynamic_cast<earl::value::Int *>(other));
     } break;
     case TokenType::Lessthan: {
         return other->type() == Type::Float ?
@@ -186,7 +349,7 @@ Int::binop(Token *op, Obj *other) {
 
 bool
 Int::boolean(void) {
-    return this->value();
+    return m_big != nullptr || m_value != 0;
 }
 
 void
@@ -196,10 +359,13 @@ Int::mutate(Obj *other, StmtMut *stmt) {
 
     switch (other->type()) {
     case Type::Int: {
-        m_value = dynamic_cast<Int *>(other)->value();
+        auto *i = dynamic_cast<Int *>(other);
+        m_value = i->m_value;
+        m_big = i->m_big;
     } break;
     case Type::Float: {
-        m_value = static_cast<int>(dynamic_cast<Float *>(other)->value());
+        m_value = static_cast<int64_t>(dynamic_cast<Float *>(other)->value());
+        m_big = nullptr;
     } break;
     default: {
         assert(false && "unreachable");
@@ -210,6 +376,7 @@ Int::mutate(Obj *other, StmtMut *stmt) {
 std::shared_ptr<Obj>
 Int::copy(void) {
     auto c = std::make_shared<Int>(m_value);
+    c->m_big = m_big;
     c->set_owner(m_var_owner);
     return c;
 }
@@ -221,60 +388,85 @@ Int::eq(Obj *other) {
 
     if (other->type() != Type::Int)
         return false;
-    return this->value() == dynamic_cast<Int *>(other)->value();
+    return cmp_ints(this, dynamic_cast<Int *>(other)) == 0;
+}
+
+bool
+Int::is_hashable(void) const {
+    return true;
+}
+
+size_t
+Int::hash(void) {
+    return m_big ? m_big->hash() : std::hash<int64_t>()(m_value);
 }
 
 std::string
 Int::to_cxxstring(void) {
-    return std::to_string(m_value);
+    return m_big ? m_big->to_string() : std::to_string(m_value);
 }
 
 void
 Int::spec_mutate(Token *op, Obj *other, StmtMut *stmt) {
     ASSERT_CONSTNESS(this, stmt);
-    int prev;
-
-    if (op->type() == TokenType::Minus_Equals
-        || op->type() == TokenType::Forwardslash_Equals
-        || op->type() == TokenType::Percent_Equals) {
-        if (other->type() == Type::Int)
-            prev = dynamic_cast<Int *>(other)->value();
-        else if (other->type() == Type::Float)
-            prev = dynamic_cast<Float *>(other)->value();
-        else {
-            const std::string msg = "invalid type for spec_mutate";
-            Err::err_wtok(op);
-            throw InterpreterException(msg);
-        }
+
+    Int truncated;
+    Int *rhs = nullptr;
+    if (other->type() == Type::Int)
+        rhs = dynamic_cast<Int *>(other);
+    else if (other->type() == Type::Float) {
+        truncated.fill(static_cast<int64_t>(dynamic_cast<Float *>(other)->value()));
+        rhs = &truncated;
     }
     else {
-        prev = m_value;
-        this->mutate(other, stmt); // does type checking
+        const std::string msg = "invalid type for spec_mutate";
+        Err::err_wtok(op);
+        throw InterpreterException(msg);
     }
 
+    std::shared_ptr<Int> res = nullptr;
     switch (op->type()) {
-    case TokenType::Plus_Equals: m_value += prev; break;
-    case TokenType::Minus_Equals: m_value -= prev; break;
-    case TokenType::Asterisk_Equals: m_value *= prev; break;
-    case TokenType::Forwardslash_Equals: m_value /= prev; break;
-    case TokenType::Percent_Equals: m_value %= prev; break;
-    case TokenType::Backtick_Pipe_Equals: m_value |= prev; break;
-    case TokenType::Backtick_Ampersand_Equals: m_value &= prev; break;
-    case TokenType::Backtick_Caret_Equals: m_value ^= prev; break;
+    case TokenType::Plus_Equals:         res = add_ints(this, rhs); break;
+    case TokenType::Minus_Equals:        res = sub_ints(this, rhs); break;
+    case TokenType::Asterisk_Equals:     res = mul_ints(this, rhs); break;
+    case TokenType::Forwardslash_Equals: res = div_ints(op, this, rhs); break;
+    case TokenType::Percent_Equals:      res = mod_ints(op, this, rhs); break;
+    case TokenType::Backtick_Pipe_Equals: {
+        assert_not_big(op, this, rhs);
+        m_value |= rhs->m_value;
+    } return;
+    case TokenType::Backtick_Ampersand_Equals: {
+        assert_not_big(op, this, rhs);
+        m_value &= rhs->m_value;
+    } return;
+    case TokenType::Backtick_Caret_Equals: {
+        assert_not_big(op, this, rhs);
+        m_value ^= rhs->m_value;
+    } return;
     default: {
         Err::err_wtok(op);
         std::string msg = "invalid operator for special mutation `"+op->lexeme()+"`";
         throw InterpreterException(msg);
     } break;
     }
+
+    m_value = res->m_value;
+    m_big = res->m_big;
 }
 
 std::shared_ptr<Obj>
 Int::unaryop(Token *op) {
     switch (op->type()) {
-    case TokenType::Minus: return std::make_shared<Int>(-m_value);
-    case TokenType::Bang: return std::make_shared<Bool>(!m_value);
-    case TokenType::Backtick_Tilde: return std::make_shared<Int>(~m_value);
+    case TokenType::Minus: {
+        if (m_big || m_value == INT64_MIN)
+            return std::make_shared<Int>(-this->as_big());
+        return std::make_shared<Int>(-m_value);
+    } break;
+    case TokenType::Bang: return std::make_shared<Bool>(!this->boolean());
+    case TokenType::Backtick_Tilde: {
+        assert_not_big(op, this, nullptr);
+        return std::make_shared<Int>(~m_value);
+    } break;
     default: {
         Err::err_wtok(op);
         std::string msg = "invalid unary operator on int type";
@@ -294,72 +486,63 @@ Int::add(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
 
     if (other->type() == Type::Float)
-        return std::make_shared<Float>(this->value() + dynamic_cast<Float *>(other)->value());
-    return std::make_shared<Int>(this->value() + dynamic_cast<Int *>(other)->value());
+        return std::make_shared<Float>(this->as_double() + dynamic_cast<Float *>(other)->value());
+    return add_ints(this, dynamic_cast<Int *>(other));
 }
 
 std::shared_ptr<Obj>
 Int::sub(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     if (other->type() == Type::Float)
-        return std::make_shared<Float>(this->value() - dynamic_cast<Float *>(other)->value());
-    return std::make_shared<Int>(this->value() - dynamic_cast<Int *>(other)->value());
+        return std::make_shared<Float>(this->as_double() - dynamic_cast<Float *>(other)->value());
+    return sub_ints(this, dynamic_cast<Int *>(other));
 }
 
 std::shared_ptr<Obj>
 Int::multiply(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     if (other->type() == Type::Float)
-        return std::make_shared<Float>(this->value() * dynamic_cast<Float *>(other)->value());
-    return std::make_shared<Int>(this->value() * dynamic_cast<Int *>(other)->value());
+        return std::make_shared<Float>(this->as_double() * dynamic_cast<Float *>(other)->value());
+    return mul_ints(this, dynamic_cast<Int *>(other));
 }
 
 std::shared_ptr<Obj>
 Int::divide(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
     if (other->type() == Type::Float)
-        return std::make_shared<Float>(this->value() / dynamic_cast<Float *>(other)->value());
-    return std::make_shared<Int>(this->value() / dynamic_cast<Int *>(other)->value());
+        return std::make_shared<Float>(this->as_double() / dynamic_cast<Float *>(other)->value());
+    return div_ints(op, this, dynamic_cast<Int *>(other));
 }
 
 std::shared_ptr<Obj>
 Int::modulo(Token *op, Obj *other) {
     ASSERT_BINOP_EXACT(this, other, op);
-    return std::make_shared<Int>(this->value() % dynamic_cast<Int *>(other)->value());
+    return mod_ints(op, this, dynamic_cast<Int *>(other));
 }
 
 std::shared_ptr<Obj>
 Int::power(Token *op, Obj *other) {
     ASSERT_BINOP_EXACT(this, other, op);
-    auto _other = dynamic_cast<earl::value::Int *>(other);
-    int p = static_cast<int>(std::pow(static_cast<float>(m_value), static_cast<float>(_other->value())));
-    return std::make_shared<earl::value::Int>(p);
+    return pow_ints(op, this, dynamic_cast<Int *>(other));
 }
 
 std::shared_ptr<Obj>
 Int::gtequality(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
+
+    int c;
+    if (other->type() == Type::Float) {
+        double x = this->as_double(), y = dynamic_cast<Float *>(other)->value();
+        c = (x > y) - (x < y);
+    }
+    else
+        c = cmp_ints(this, dynamic_cast<Int *>(other));
+
     switch (op->type()) {
-    case TokenType::Lessthan: {
-        return other->type() == Type::Float ?
-            std::make_shared<Bool>(this->value() < dynamic_cast<Float *>(other)->value()) :
-            std::make_shared<Bool>(this->value() < dynamic_cast<Int *>(other)->value());
-    } break;
-    case TokenType::Greaterthan: {
-        return other->type() == Type::Float ?
-            std::make_shared<Bool>(this->value() > dynamic_cast<Float *>(other)->value()) :
-            std::make_shared<Bool>(this->value() > dynamic_cast<Int *>(other)->value());
-    } break;
-    case TokenType::Greaterthan_Equals: {
-        return other->type() == Type::Float ?
-            std::make_shared<Bool>(this->value() >= dynamic_cast<Float *>(other)->value()) :
-            std::make_shared<Bool>(this->value() >= dynamic_cast<Int *>(other)->value());
-    } break;
-    case TokenType::Lessthan_Equals: {
-        return other->type() == Type::Float ?
-            std::make_shared<Bool>(this->value() <= dynamic_cast<Float *>(other)->value()) :
-            std::make_shared<Bool>(this->value() <= dynamic_cast<Int *>(other)->value());
-    } break;
+    case TokenType::Lessthan:           return std::make_shared<Bool>(c < 0);
+    case TokenType::Greaterthan:        return std::make_shared<Bool>(c > 0);
+    case TokenType::Greaterthan_Equals: return std::make_shared<Bool>(c >= 0);
+    case TokenType::Lessthan_Equals:    return std::make_shared<Bool>(c <= 0);
     default: {
         Err::err_wtok(op);
         const std::string msg = "invalid operator";
@@ -371,17 +554,14 @@ Int::gtequality(Token *op, Obj *other) {
 std::shared_ptr<Obj>
 Int::equality(Token *op, Obj *other) {
     ASSERT_BINOP_COMPAT(this, other, op);
+
+    bool equal = other->type() == Type::Float
+        ? this->as_double() == dynamic_cast<Float *>(other)->value()
+        : cmp_ints(this, dynamic_cast<Int *>(other)) == 0;
+
     switch (op->type()) {
-    case TokenType::Double_Equals: {
-        return other->type() == Type::Float ?
-            std::make_shared<Bool>(this->value() == dynamic_cast<Float *>(other)->value()) :
-            std::make_shared<Bool>(this->value() == dynamic_cast<Int *>(other)->value());
-    } break;
-    case TokenType::Bang_Equals: {
-        return other->type() == Type::Float ?
-            std::make_shared<Bool>(this->value() != dynamic_cast<Float *>(other)->value()) :
-            std::make_shared<Bool>(this->value() != dynamic_cast<Int *>(other)->value());
-    } break;
+    case TokenType::Double_Equals: return std::make_shared<Bool>(equal);
+    case TokenType::Bang_Equals:   return std::make_shared<Bool>(!equal);
     default: {
         Err::err_wtok(op);
         const std::string msg = "invalid operator";
@@ -393,10 +573,12 @@ Int::equality(Token *op, Obj *other) {
 std::shared_ptr<Obj>
 Int::bitwise(Token *op, Obj *other) {
     ASSERT_BINOP_EXACT(this, other, op);
+    auto *rhs = dynamic_cast<Int *>(other);
+    assert_not_big(op, this, rhs);
     switch (op->type()) {
-    case TokenType::Backtick_Pipe:      return std::make_shared<Int>(this->value() | dynamic_cast<Int *>(other)->value());
-    case TokenType::Backtick_Caret:     return std::make_shared<Int>(this->value() ^ dynamic_cast<Int *>(other)->value());
-    case TokenType::Backtick_Ampersand: return std::make_shared<Int>(this->value() & dynamic_cast<Int *>(other)->value());
+    case TokenType::Backtick_Pipe:      return std::make_shared<Int>(this->value() | rhs->value());
+    case TokenType::Backtick_Caret:     return std::make_shared<Int>(this->value() ^ rhs->value());
+    case TokenType::Backtick_Ampersand: return std::make_shared<Int>(this->value() & rhs->value());
     default: {
         Err::err_wtok(op);
         const std::string msg = "invalid operator";
@@ -408,22 +590,20 @@ Int::bitwise(Token *op, Obj *other) {
 std::shared_ptr<Obj>
 Int::bitshift(Token *op, Obj *other) {
     ASSERT_BINOP_EXACT(this, other, op);
+    auto *rhs = dynamic_cast<Int *>(other);
     switch (op->type()) {
     case TokenType::Double_Lessthan: {
-        if (other->type() != Type::Int) {
-            Err::err_wtok(op);
-            const std::string msg = "cannot perform `"+op->lexeme()+"` with a float as the expression";
-            throw InterpreterException(msg);
-        }
-        return std::make_shared<Int>(this->value() << dynamic_cast<Int *>(other)->value());
+        return shl_ints(op, this, rhs);
     } break;
     case TokenType::Double_Greaterthan: {
-        if (other->type() != Type::Int) {
+        assert_not_big(op, this, rhs);
+        int64_t n = rhs->value();
+        if (n < 0) {
             Err::err_wtok(op);
-            const std::string msg = "cannot perform `"+op->lexeme()+"` with a float as the expression";
+            const std::string msg = "cannot shift by a negative amount";
             throw InterpreterException(msg);
         }
-        return std::make_shared<Int>(this->value() >> dynamic_cast<Int *>(other)->value());
+        return std::make_shared<Int>(n >= 64 ? (m_value < 0 ? -1 : 0) : m_value >> n);
     } break;
     default: {
         Err::err_wtok(op);
@@ -67,7 +67,7 @@ List::slice(Obj *start, Obj *end, Expr *expr) {
         std::for_each(m_value.begin(), m_value.end(), [&](auto &k) {v.push_back(k);});
         return v;
     }
-    int s, e;
+    int64_t s, e;
 
     if (start->type() == Type::Void)
         s = 0;
@@ -80,7 +80,7 @@ List::slice(Obj *start, Obj *end, Expr *expr) {
         e = dynamic_cast<Int *>(end)->value();
 
     for (; s < e; ++s) {
-        if (s >= m_value.size()) {
+        if (s < 0 || static_cast<uint64_t>(s) >= m_value.size()) {
             Err::err_wexpr(expr);
             std::string msg = "index "+std::to_string(s)+" is out of range for list of length "+std::to_string(m_value.size());
             throw InterpreterException(msg);
@@ -136,17 +136,18 @@ List::contains(Obj *value) {
 void
 List::pop(Obj *idx, Expr *expr) {
     auto *idx1 = dynamic_cast<earl::value::Int *>(idx);
+    int64_t I = idx1->value();
 
-    if (idx1->value() >= m_value.size()) {
+    if (I < 0 || static_cast<uint64_t>(I) >= m_value.size()) {
         Err::err_wexpr(expr);
         const std::string msg = "index "
-            +std::to_string(idx1->value())
+            +std::to_string(I)
             +" is out of range of length "
             +std::to_string(m_value.size());
         throw InterpreterException(msg);
     }
 
-    m_value.erase(m_value.begin() + idx1->value());
+    m_value.erase(m_value.begin() + I);
 }
 
 void
@@ -0,0 +1,309 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+// Tile edge used by the blocked multiplication. 64 doubles
+// is 512 bytes per row of a tile, so three tiles sit in L1/L2.
+#define MATMUL_BLOCK 64
+
+// Below this many multiply-adds, spawning threads costs more
+// than it saves.
+#define MATMUL_THREAD_THRESHOLD (1 << 18)
+
+static double
+scalar_value(Obj *obj) {
+    if (obj->type() == Type::Int)
+        return static_cast<double>(dynamic_cast<Int *>(obj)->value());
+    return dynamic_cast<Float *>(obj)->value();
+}
+
+static size_t
+index_value(Obj *idx, size_t bound, const char *what, Expr *expr) {
+    if (idx->type() != Type::Int) {
+        Err::err_wexpr(expr);
+        const std::string msg = "matrix "+std::string(what)+" index must be of type `int` but got `"+type_to_str(idx->type())+"`";
+        throw InterpreterException(msg);
+    }
+    int64_t i = dynamic_cast<Int *>(idx)->value();
+    if (i < 0 || static_cast<uint64_t>(i) >= bound) {
+        Err::err_wexpr(expr);
+        const std::string msg = "matrix "+std::string(what)+" index "+std::to_string(i)
+            +" is out of range of size "+std::to_string(bound);
+        throw InterpreterException(msg);
+    }
+    return static_cast<size_t>(i);
+}
+
+// Computes rows [row_begin, row_end) of C += A x B where A is n x k,
+// B is k x m and all are row-major. The i-k-j order keeps the inner
+// loop streaming over contiguous rows of B and C.
+static void
+matmul_rows(const double *a, const double *b, double *c,
+            size_t row_begin, size_t row_end, size_t k, size_t m) {
+    for (size_t ii = row_begin; ii < row_end; ii += MATMUL_BLOCK) {
+        const size_t i_end = std::min(ii + MATMUL_BLOCK, row_end);
+        for (size_t kk = 0; kk < k; kk += MATMUL_BLOCK) {
+            const size_t k_end = std::min(kk + MATMUL_BLOCK, k);
+            for (size_t jj = 0; jj < m; jj += MATMUL_BLOCK) {
+                const size_t j_end = std::min(jj + MATMUL_BLOCK, m);
+                for (size_t i = ii; i < i_end; ++i) {
+                    double *crow = c + i*m;
+                    for (size_t p = kk; p < k_end; ++p) {
+                        const double aip = a[i*k + p];
+                        const double *brow = b + p*m;
+                        for (size_t j = jj; j < j_end; ++j)
+                            crow[j] += aip * brow[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+Matrix::Matrix(size_t rows, size_t cols, std::vector<double> data)
+    : m_rows(rows), m_cols(cols), m_data(std::move(data)) {
+    if (m_data.size() != rows*cols)
+        m_data.resize(rows*cols, 0.0);
+}
+
+size_t
+Matrix::rows(void) const {
+    return m_rows;
+}
+
+size_t
+Matrix::cols(void) const {
+    return m_cols;
+}
+
+std::vector<double> &
+Matrix::data(void) {
+    return m_data;
+}
+
+std::shared_ptr<Float>
+Matrix::at(Obj *i, Obj *j, Expr *expr) {
+    size_t r = index_value(i, m_rows, "row", expr);
+    size_t c = index_value(j, m_cols, "column", expr);
+    return std::make_shared<Float>(m_data[r*m_cols + c]);
+}
+
+void
+Matrix::set(Obj *i, Obj *j, Obj *value, Expr *expr) {
+    size_t r = index_value(i, m_rows, "row", expr);
+    size_t c = index_value(j, m_cols, "column", expr);
+    if (value->type() != Type::Int && value->type() != Type::Float) {
+        Err::err_wexpr(expr);
+        const std::string msg = "matrix elements must be of type `int` or `float` but got `"+type_to_str(value->type())+"`";
+        throw InterpreterException(msg);
+    }
+    m_data[r*m_cols + c] = scalar_value(value);
+}
+
+std::shared_ptr<Matrix>
+Matrix::transpose(void) {
+    std::vector<double> data(m_data.size());
+    for (size_t i = 0; i < m_rows; ++i)
+        for (size_t j = 0; j < m_cols; ++j)
+            data[j*m_rows + i] = m_data[i*m_cols + j];
+    return std::make_shared<Matrix>(m_cols, m_rows, std::move(data));
+}
+
+std::shared_ptr<Matrix>
+Matrix::matmul(Matrix *other, size_t nthreads, Expr *expr) {
+    if (m_cols != other->m_rows) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot multiply a "+std::to_string(m_rows)+"x"+std::to_string(m_cols)
+            +" matrix by a "+std::to_string(other->m_rows)+"x"+std::to_string(other->m_cols)+" matrix";
+        throw InterpreterException(msg);
+    }
+
+    const size_t n = m_rows, k = m_cols, m = other->m_cols;
+    auto res = std::make_shared<Matrix>(n, m);
+    const double *a = m_data.data(), *b = other->m_data.data();
+    double *c = res->m_data.data();
+
+    if (nthreads == 0) {
+        nthreads = 1;
+        if (n*k*m >= MATMUL_THREAD_THRESHOLD)
+            nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nthreads = std::min(nthreads, std::max<size_t>(n, 1));
+
+    if (nthreads <= 1) {
+        matmul_rows(a, b, c, 0, n, k, m);
+        return res;
+    }
+
+    // Each thread owns a disjoint band of output rows, so no
+    // synchronization is needed beyond the join.
+    std::vector<std::thread> workers;
+    const size_t band = (n + nthreads - 1) / nthreads;
+    for (size_t begin = 0; begin < n; begin += band)
+        workers.emplace_back(matmul_rows, a, b, c, begin, std::min(begin + band, n), k, m);
+    for (auto &w : workers)
+        w.join();
+
+    return res;
+}
+
+std::shared_ptr<List>
+Matrix::to_list(void) {
+    std::vector<std::shared_ptr<Obj>> rows;
+    rows.reserve(m_rows);
+    for (size_t i = 0; i < m_rows; ++i) {
+        std::vector<std::shared_ptr<Obj>> row;
+        row.reserve(m_cols);
+        for (size_t j = 0; j < m_cols; ++j)
+            row.push_back(std::make_shared<Float>(m_data[i*m_cols + j]));
+        rows.push_back(std::make_shared<List>(std::move(row)));
+    }
+    return std::make_shared<List>(std::move(rows));
+}
+
+template <typename F> std::shared_ptr<Obj>
+Matrix::elementwise(Token *op, Obj *other, F f) {
+    auto res = std::make_shared<Matrix>(m_rows, m_cols, m_data);
+    auto &out = res->m_data;
+
+    if (other->type() == Type::Int || other->type() == Type::Float) {
+        const double s = scalar_value(other);
+        for (size_t i = 0; i < out.size(); ++i)
+            out[i] = f(out[i], s);
+        return res;
+    }
+
+    if (other->type() != Type::Matrix) {
+        Err::err_wtok(op);
+        const std::string msg = "cannot apply `"+op->lexeme()+"` to a matrix and a value of type `"+type_to_str(other->type())+"`";
+        throw InterpreterException(msg);
+    }
+
+    auto *rhs = dynamic_cast<Matrix *>(other);
+    if (rhs->m_rows != m_rows || rhs->m_cols != m_cols) {
+        Err::err_wtok(op);
+        const std::string msg = "cannot apply `"+op->lexeme()+"` to matrices of shapes "
+            +std::to_string(m_rows)+"x"+std::to_string(m_cols)+" and "
+            +std::to_string(rhs->m_rows)+"x"+std::to_string(rhs->m_cols);
+        throw InterpreterException(msg);
+    }
+
+    const double *r = rhs->m_data.data();
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i] = f(out[i], r[i]);
+    return res;
+}
+
+/*** OVERRIDES ***/
+Type
+Matrix::type(void) const {
+    return Type::Matrix;
+}
+
+bool
+Matrix::boolean(void) {
+    return !m_data.empty();
+}
+
+void
+Matrix::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    auto *mat = dynamic_cast<Matrix *>(other);
+    m_rows = mat->m_rows;
+    m_cols = mat->m_cols;
+    m_data = mat->m_data;
+}
+
+std::shared_ptr<Obj>
+Matrix::copy(void) {
+    auto value = std::make_shared<Matrix>(m_rows, m_cols, m_data);
+    value->set_owner(m_var_owner);
+    return value;
+}
+
+bool
+Matrix::eq(Obj *other) {
+    if (other->type() != Type::Matrix)
+        return false;
+    auto *mat = dynamic_cast<Matrix *>(other);
+    return m_rows == mat->m_rows && m_cols == mat->m_cols && m_data == mat->m_data;
+}
+
+std::string
+Matrix::to_cxxstring(void) {
+    std::string res = "<Matrix "+std::to_string(m_rows)+"x"+std::to_string(m_cols)+" [";
+    char buf[32];
+    for (size_t i = 0; i < m_rows; ++i) {
+        res += i == 0 ? "[" : ", [";
+        for (size_t j = 0; j < m_cols; ++j) {
+            std::snprintf(buf, sizeof(buf), "%g", m_data[i*m_cols + j]);
+            if (j != 0)
+                res += ", ";
+            res += buf;
+        }
+        res += "]";
+    }
+    res += "]>";
+    return res;
+}
+
+std::shared_ptr<Obj>
+Matrix::add(Token *op, Obj *other) {
+    return this->elementwise(op, other, [](double x, double y) { return x + y; });
+}
+
+std::shared_ptr<Obj>
+Matrix::sub(Token *op, Obj *other) {
+    return this->elementwise(op, other, [](double x, double y) { return x - y; });
+}
+
+std::shared_ptr<Obj>
+Matrix::multiply(Token *op, Obj *other) {
+    return this->elementwise(op, other, [](double x, double y) { return x * y; });
+}
+
+std::shared_ptr<Obj>
+Matrix::divide(Token *op, Obj *other) {
+    return this->elementwise(op, other, [](double x, double y) { return x / y; });
+}
+
+std::shared_ptr<Obj>
+Matrix::equality(Token *op, Obj *other) {
+    ASSERT_BINOP_COMPAT(this, other, op);
+    if (op->type() == TokenType::Double_Equals)
+        return std::make_shared<Bool>(this->eq(other));
+    return std::make_shared<Bool>(!this->eq(other));
+}
@@ -83,6 +83,17 @@ Obj::eq(Obj *other) {
     throw InterpreterException(msg);
 }
 
+bool
+Obj::is_hashable(void) const {
+    return false;
+}
+
+size_t
+Obj::hash(void) {
+    const std::string msg = "value of type: `"+type_to_str(this->type())+"` is not hashable";
+    throw InterpreterException(msg);
+}
+
 std::string
 Obj::to_cxxstring(void) {
     const std::string msg = "unable to get cxxstring of value of type: `"+type_to_str(this->type())+"`";
@@ -0,0 +1,175 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <iostream>
+#include <cassert>
+#include <memory>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+PriorityQueue::PriorityQueue(std::shared_ptr<Closure> cmp) : m_cmp(cmp) {}
+
+bool
+PriorityQueue::before(const std::shared_ptr<Obj> &obj1,
+                      const std::shared_ptr<Obj> &obj2,
+                      std::shared_ptr<Ctx> &ctx,
+                      Expr *expr) {
+    if (m_cmp) {
+        std::vector<std::shared_ptr<Obj>> values = {obj1, obj2};
+        auto result = m_cmp->call(values, ctx);
+        if (result->type() != Type::Bool) {
+            Err::err_wexpr(expr);
+            const std::string msg = "priority queue comparator must return `bool` but got `"+type_to_str(result->type())+"`";
+            throw InterpreterException(msg);
+        }
+        return result->boolean();
+    }
+
+    // Natural ordering, smallest first.
+    Type ty1 = obj1->type(), ty2 = obj2->type();
+    if ((ty1 == Type::Int || ty1 == Type::Float) && (ty2 == Type::Int || ty2 == Type::Float)) {
+        double x = ty1 == Type::Int ? dynamic_cast<Int *>(obj1.get())->value() : dynamic_cast<Float *>(obj1.get())->value();
+        double y = ty2 == Type::Int ? dynamic_cast<Int *>(obj2.get())->value() : dynamic_cast<Float *>(obj2.get())->value();
+        return x < y;
+    }
+    if (ty1 == Type::Char && ty2 == Type::Char)
+        return dynamic_cast<Char *>(obj1.get())->value() < dynamic_cast<Char *>(obj2.get())->value();
+    if (ty1 == Type::Str && ty2 == Type::Str)
+        return dynamic_cast<Str *>(obj1.get())->value_asref() < dynamic_cast<Str *>(obj2.get())->value_asref();
+
+    Err::err_wexpr(expr);
+    const std::string msg = "values of type `"+type_to_str(ty1)+"` and `"+type_to_str(ty2)
+        +"` have no natural ordering, create the priority queue with a comparator closure";
+    throw InterpreterException(msg);
+}
+
+void
+PriorityQueue::sift_up(size_t idx, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    while (idx > 0) {
+        size_t parent = (idx - 1) / 2;
+        if (!this->before(m_heap[idx], m_heap[parent], ctx, expr))
+            break;
+        std::swap(m_heap[idx], m_heap[parent]);
+        idx = parent;
+    }
+}
+
+void
+PriorityQueue::sift_down(size_t idx, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    const size_t n = m_heap.size();
+    while (true) {
+        size_t left = 2*idx + 1, right = left + 1, best = idx;
+        if (left < n && this->before(m_heap[left], m_heap[best], ctx, expr))
+            best = left;
+        if (right < n && this->before(m_heap[right], m_heap[best], ctx, expr))
+            best = right;
+        if (best == idx)
+            break;
+        std::swap(m_heap[idx], m_heap[best]);
+        idx = best;
+    }
+}
+
+void
+PriorityQueue::push(std::shared_ptr<Obj> value, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    m_heap.push_back(value);
+    this->sift_up(m_heap.size() - 1, ctx, expr);
+}
+
+std::shared_ptr<Obj>
+PriorityQueue::pop(std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    if (m_heap.empty()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot `pop` from an empty priority queue";
+        throw InterpreterException(msg);
+    }
+    auto value = std::move(m_heap.front());
+    m_heap.front() = std::move(m_heap.back());
+    m_heap.pop_back();
+    if (!m_heap.empty())
+        this->sift_down(0, ctx, expr);
+    return value;
+}
+
+std::shared_ptr<Obj>
+PriorityQueue::top(Expr *expr) {
+    if (m_heap.empty()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot get the `top` of an empty priority queue";
+        throw InterpreterException(msg);
+    }
+    return m_heap.front();
+}
+
+size_t
+PriorityQueue::size(void) const {
+    return m_heap.size();
+}
+
+bool
+PriorityQueue::empty(void) const {
+    return m_heap.empty();
+}
+
+/*** OVERRIDES ***/
+Type
+PriorityQueue::type(void) const {
+    return Type::PriorityQueue;
+}
+
+bool
+PriorityQueue::boolean(void) {
+    return !m_heap.empty();
+}
+
+void
+PriorityQueue::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    auto other_pq = dynamic_cast<PriorityQueue *>(other);
+    m_heap = other_pq->m_heap;
+    m_cmp = other_pq->m_cmp;
+}
+
+std::shared_ptr<Obj>
+PriorityQueue::copy(void) {
+    auto value = std::make_shared<PriorityQueue>(m_cmp);
+    value->m_heap.reserve(m_heap.size());
+    for (auto &elem : m_heap)
+        value->m_heap.push_back(elem->copy());
+    value->set_owner(m_var_owner);
+    return value;
+}
+
+std::string
+PriorityQueue::to_cxxstring(void) {
+    std::string res = "<PriorityQueue { size: "+std::to_string(m_heap.size());
+    if (!m_heap.empty())
+        res += ", top: "+m_heap.front()->to_cxxstring();
+    res += " }>";
+    return res;
+}
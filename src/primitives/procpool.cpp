@@ -0,0 +1,322 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <iostream>
+#include <memory>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "common.hpp"
+#include "utils.hpp"
+#include "process.hpp"
+
+using namespace earl::value;
+
+// How long to sleep in `poll` when the only thing left to do is
+// reap a child that closed its output but has not exited yet.
+#define PROCPOOL_REAP_INTERVAL_MS 5
+
+struct ProcPool::State {
+    enum class Status { Queued, Running, Done, Collected };
+
+    struct Job {
+        std::string cmd;
+        Status status = Status::Queued;
+        pid_t pid = -1;
+        int out_fd = -1;
+        int err_fd = -1;
+        std::string out;
+        std::string err;
+        int exit_code = -1;
+    };
+
+    State(size_t limit) : limit(limit) {}
+
+    // Children are never left behind as zombies, even if the
+    // script forgets to wait on them.
+    ~State() {
+        for (auto &job : jobs) {
+            if (job.status != Status::Running)
+                continue;
+            close_fd(job.out_fd);
+            close_fd(job.err_fd);
+            int wstatus;
+            while (waitpid(job.pid, &wstatus, 0) == -1 && errno == EINTR)
+                ;
+        }
+    }
+
+    static void close_fd(int &fd) {
+        if (fd != -1)
+            close(fd);
+        fd = -1;
+    }
+
+    void start(Job &job, Expr *expr) {
+        int out[2], err[2];
+        if (pipe2(out, O_CLOEXEC) == -1)
+            goto fail;
+        if (pipe2(err, O_CLOEXEC) == -1) {
+            close(out[0]), close(out[1]);
+            goto fail;
+        }
+
+        {
+            // Commands run side by side, so none of them get to read the terminal.
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+            posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+
+            job.pid = process::start(job.cmd, &actions);
+            posix_spawn_file_actions_destroy(&actions);
+            close(out[1]), close(err[1]);
+
+            if (job.pid == -1) {
+                close(out[0]), close(err[0]);
+                goto fail;
+            }
+        }
+
+        job.out_fd = out[0];
+        job.err_fd = err[0];
+        job.status = Status::Running;
+        ++running;
+        return;
+
+    fail:
+        job.status = Status::Collected;
+        --outstanding;
+        Err::err_wexpr(expr);
+        const std::string msg = "failed to spawn command `"+job.cmd+"`";
+        throw InterpreterException(msg);
+    }
+
+    void start_queued(Expr *expr) {
+        while (running < limit && !queue.empty()) {
+            size_t handle = queue.front();
+            queue.pop_front();
+            start(jobs[handle], expr);
+        }
+    }
+
+    // Wait for at least one thing to happen to the running
+    // commands, then start more if slots were freed.
+    void step(Expr *expr) {
+        std::vector<pollfd> fds;
+        std::vector<std::pair<size_t, int *>> owners;
+        bool reaping = false;
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            Job &job = jobs[i];
+            if (job.status != Status::Running)
+                continue;
+            if (job.out_fd == -1 && job.err_fd == -1)
+                reaping = true;
+            for (int *fd : {&job.out_fd, &job.err_fd}) {
+                if (*fd == -1)
+                    continue;
+                fds.push_back({*fd, POLLIN, 0});
+                owners.push_back({i, fd});
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), reaping ? PROCPOOL_REAP_INTERVAL_MS : -1) == -1 && errno != EINTR) {
+            Err::err_wexpr(expr);
+            const std::string msg = "failed to poll running commands";
+            throw InterpreterException(msg);
+        }
+
+        char buf[4096];
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i].revents == 0)
+                continue;
+            Job &job = jobs[owners[i].first];
+            int *fd = owners[i].second;
+            ssize_t n = read(*fd, buf, sizeof(buf));
+            if (n > 0)
+                (fd == &job.out_fd ? job.out : job.err).append(buf, n);
+            else if (n == 0 || errno != EINTR)
+                close_fd(*fd);
+        }
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            Job &job = jobs[i];
+            if (job.status != Status::Running || job.out_fd != -1 || job.err_fd != -1)
+                continue;
+            int wstatus;
+            if (waitpid(job.pid, &wstatus, WNOHANG) <= 0)
+                continue;
+            job.exit_code = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 128+WTERMSIG(wstatus);
+            job.status = Status::Done;
+            done.push_back(i);
+            --running;
+        }
+
+        start_queued(expr);
+    }
+
+    std::shared_ptr<Tuple> collect(size_t handle) {
+        Job &job = jobs[handle];
+        job.status = Status::Collected;
+        done.erase(std::find(done.begin(), done.end(), handle));
+        --outstanding;
+
+        if (job.exit_code != 0 && (config::runtime::flags & __ERROR_ON_BASH_FAIL) != 0) {
+            const std::string msg = "BASH command `"+job.cmd+"` failed with exit code: "+std::to_string(job.exit_code);
+            throw InterpreterException(msg);
+        }
+
+        std::vector<std::shared_ptr<Obj>> values = {
+            std::make_shared<Int>(job.exit_code),
+            std::make_shared<Str>(std::move(job.out)),
+            std::make_shared<Str>(std::move(job.err)),
+        };
+        return std::make_shared<Tuple>(std::move(values));
+    }
+
+    size_t limit;
+    size_t running = 0;
+    size_t outstanding = 0;
+    std::vector<Job> jobs;
+    std::deque<size_t> queue;
+    std::deque<size_t> done;
+};
+
+ProcPool::ProcPool(size_t limit) : m_state(std::make_shared<State>(limit)) {}
+
+size_t
+ProcPool::spawn(const std::string &cmd, Expr *expr) {
+    if ((config::runtime::flags & __SHOWBASH) != 0)
+        std::cout << "+ " << cmd << std::endl;
+
+    size_t handle = m_state->jobs.size();
+    m_state->jobs.push_back(State::Job{});
+    m_state->jobs.back().cmd = cmd;
+    m_state->queue.push_back(handle);
+    ++m_state->outstanding;
+    m_state->start_queued(expr);
+    return handle;
+}
+
+std::shared_ptr<Tuple>
+ProcPool::wait(Obj *handle, Expr *expr) {
+    if (handle->type() != Type::Int) {
+        Err::err_wexpr(expr);
+        const std::string msg = "process handle must be of type `int` but got `"+type_to_str(handle->type())+"`";
+        throw InterpreterException(msg);
+    }
+
+    int64_t h = dynamic_cast<Int *>(handle)->value();
+    if (h < 0 || static_cast<size_t>(h) >= m_state->jobs.size()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "no process with handle "+std::to_string(h)+" was spawned in this pool";
+        throw InterpreterException(msg);
+    }
+    if (m_state->jobs[h].status == State::Status::Collected) {
+        Err::err_wexpr(expr);
+        const std::string msg = "process with handle "+std::to_string(h)+" has already been waited on";
+        throw InterpreterException(msg);
+    }
+
+    while (m_state->jobs[h].status != State::Status::Done)
+        m_state->step(expr);
+    return m_state->collect(h);
+}
+
+std::shared_ptr<Tuple>
+ProcPool::wait_any(Expr *expr) {
+    if (m_state->outstanding == 0) {
+        Err::err_wexpr(expr);
+        const std::string msg = "`wait_any` called with no processes outstanding";
+        throw InterpreterException(msg);
+    }
+
+    while (m_state->done.empty())
+        m_state->step(expr);
+
+    size_t h = m_state->done.front();
+    auto result = m_state->collect(h);
+    std::vector<std::shared_ptr<Obj>> values = {std::make_shared<Int>(h)};
+    for (auto &value : result->value())
+        values.push_back(value);
+    return std::make_shared<Tuple>(std::move(values));
+}
+
+std::shared_ptr<List>
+ProcPool::wait_all(Expr *expr) {
+    std::vector<std::shared_ptr<Obj>> results;
+    for (size_t h = 0; h < m_state->jobs.size(); ++h) {
+        if (m_state->jobs[h].status == State::Status::Collected)
+            continue;
+        while (m_state->jobs[h].status != State::Status::Done)
+            m_state->step(expr);
+        results.push_back(m_state->collect(h));
+    }
+    return std::make_shared<List>(std::move(results));
+}
+
+size_t
+ProcPool::pending(void) const {
+    return m_state->outstanding;
+}
+
+Type
+ProcPool::type(void) const {
+    return Type::ProcPool;
+}
+
+bool
+ProcPool::boolean(void) {
+    return m_state->outstanding != 0;
+}
+
+void
+ProcPool::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    m_state = dynamic_cast<ProcPool *>(other)->m_state;
+}
+
+std::shared_ptr<Obj>
+ProcPool::copy(void) {
+    auto value = std::make_shared<ProcPool>(m_state->limit);
+    value->m_state = m_state;
+    return value;
+}
+
+std::string
+ProcPool::to_cxxstring(void) {
+    return "<ProcPool { limit: "+std::to_string(m_state->limit)
+        +", running: "+std::to_string(m_state->running)
+        +", pending: "+std::to_string(m_state->outstanding)+" }>";
+}
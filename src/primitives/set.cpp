@@ -0,0 +1,209 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <iostream>
+#include <cassert>
+#include <memory>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+size_t
+ObjHash::operator()(const std::shared_ptr<Obj> &obj) const {
+    return obj->hash();
+}
+
+bool
+ObjEq::operator()(const std::shared_ptr<Obj> &obj1, const std::shared_ptr<Obj> &obj2) const {
+    return obj1->type() == obj2->type() && obj1->eq(obj2.get());
+}
+
+Set::Set(void) {
+    m_iterable = true;
+}
+
+std::unordered_set<std::shared_ptr<Obj>, ObjHash, ObjEq> &
+Set::extract(void) {
+    return m_set;
+}
+
+void
+Set::insert(std::shared_ptr<Obj> value, Expr *expr) {
+    if (!value->is_hashable()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "value of type `"+type_to_str(value->type())+"` is not hashable and cannot be inserted into a set";
+        throw InterpreterException(msg);
+    }
+    // Elements are copied so that mutating the original
+    // value cannot change the hash of what is stored.
+    if (m_set.find(value) == m_set.end())
+        m_set.insert(value->copy());
+}
+
+bool
+Set::remove(const std::shared_ptr<Obj> &value) {
+    if (!value->is_hashable())
+        return false;
+    return m_set.erase(value) != 0;
+}
+
+std::shared_ptr<Bool>
+Set::contains(const std::shared_ptr<Obj> &value) {
+    if (!value->is_hashable())
+        return std::make_shared<Bool>(false);
+    return std::make_shared<Bool>(m_set.find(value) != m_set.end());
+}
+
+std::shared_ptr<Set>
+Set::set_union(Set *other) {
+    auto res = std::make_shared<Set>();
+    res->m_set.reserve(m_set.size() + other->m_set.size());
+    res->m_set.insert(m_set.begin(), m_set.end());
+    res->m_set.insert(other->m_set.begin(), other->m_set.end());
+    return res;
+}
+
+std::shared_ptr<Set>
+Set::intersection(Set *other) {
+    auto res = std::make_shared<Set>();
+
+    // Probe the larger set with the elements of the smaller one.
+    Set *small = this, *large = other;
+    if (small->m_set.size() > large->m_set.size())
+        std::swap(small, large);
+
+    for (auto &elem : small->m_set)
+        if (large->m_set.find(elem) != large->m_set.end())
+            res->m_set.insert(elem);
+    return res;
+}
+
+std::shared_ptr<Set>
+Set::difference(Set *other) {
+    auto res = std::make_shared<Set>();
+    for (auto &elem : m_set)
+        if (other->m_set.find(elem) == other->m_set.end())
+            res->m_set.insert(elem);
+    return res;
+}
+
+size_t
+Set::size(void) const {
+    return m_set.size();
+}
+
+bool
+Set::empty(void) const {
+    return m_set.empty();
+}
+
+/*** OVERRIDES ***/
+Type
+Set::type(void) const {
+    return Type::Set;
+}
+
+bool
+Set::boolean(void) {
+    return !m_set.empty();
+}
+
+void
+Set::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    m_set = dynamic_cast<Set *>(other)->extract();
+}
+
+std::shared_ptr<Obj>
+Set::copy(void) {
+    // Elements are never mutated in place, so they can be shared.
+    auto value = std::make_shared<Set>();
+    value->m_set = m_set;
+    value->set_owner(m_var_owner);
+    return value;
+}
+
+bool
+Set::eq(Obj *other) {
+    if (other->type() != Type::Set)
+        return false;
+
+    auto other_set = dynamic_cast<Set *>(other);
+    if (m_set.size() != other_set->m_set.size())
+        return false;
+
+    for (auto &elem : m_set)
+        if (other_set->m_set.find(elem) == other_set->m_set.end())
+            return false;
+    return true;
+}
+
+std::string
+Set::to_cxxstring(void) {
+    std::string res = "<Set { ";
+    size_t i = 0;
+    for (auto &elem : m_set) {
+        res += elem->to_cxxstring();
+        if (i != m_set.size()-1)
+            res += ", ";
+        ++i;
+    }
+    res += " }>";
+    return res;
+}
+
+Iterator
+Set::iter_begin(void) {
+    return m_set.begin();
+}
+
+Iterator
+Set::iter_end(void) {
+    return m_set.end();
+}
+
+void
+Set::iter_next(Iterator &it) {
+    std::visit([&](auto &iter) {
+        std::advance(iter, 1);
+    }, it);
+}
+
+std::shared_ptr<Obj>
+Set::equality(Token *op, Obj *other) {
+    ASSERT_BINOP_COMPAT(this, other, op);
+    switch (op->type()) {
+    case TokenType::Double_Equals: return std::make_shared<Bool>(this->eq(other));
+    case TokenType::Bang_Equals: return std::make_shared<Bool>(!this->eq(other));
+    default: {
+        Err::err_wtok(op);
+        const std::string msg = "invalid operator";
+        throw InterpreterException(msg);
+    } break;
+    }
+    return nullptr; // unreachable
+}
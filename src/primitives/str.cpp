@@ -113,8 +113,8 @@ Str::nth(Obj *idx, const Expr *const expr) {
     }
 
     auto index = dynamic_cast<Int *>(idx);
-    int I = index->value();
-    if (I < 0 || static_cast<size_t>(I) >= m_value.size()) {
+    int64_t I = index->value();
+    if (I < 0 || static_cast<uint64_t>(I) >= m_value.size()) {
         Err::err_wexpr(expr);
         std::string msg = "index "+std::to_string(index->value())+" is out of str range of length "+std::to_string(this->value().size());
         throw InterpreterException(msg);
@@ -170,15 +170,20 @@ Str::substr(Obj *idx1, Obj *idx2, Expr *expr) {
 
     this->update_changed();
 
-    int S = dynamic_cast<Int *>(idx1)->value();
-    int N = dynamic_cast<Int *>(idx2)->value();
+    int64_t S = dynamic_cast<Int *>(idx1)->value();
+    int64_t N = dynamic_cast<Int *>(idx2)->value();
+    if (S < 0 || static_cast<uint64_t>(S) > m_value.size()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "index "+std::to_string(S)+" is out of range of length "+std::to_string(m_value.size());
+        throw InterpreterException(msg);
+    }
 
-    return std::make_shared<Str>(m_value.substr(S, N));
+    return std::make_shared<Str>(m_value.substr(S, static_cast<size_t>(N)));
 }
 
 void
-Str::remove_char(int idx, Expr *expr) {
-    if (idx >= m_value.size()) {
+Str::remove_char(int64_t idx, Expr *expr) {
+    if (idx < 0 || static_cast<uint64_t>(idx) >= m_value.size()) {
         Err::err_wexpr(expr);
         const std::string msg = "index "+std::to_string(idx)+" is out of range of length "+std::to_string(m_value.size());
         throw InterpreterException(msg);
@@ -192,7 +197,7 @@ Str::remove_char(int idx, Expr *expr) {
 void
 Str::pop(Obj *idx, Expr *expr) {
     auto *idx1 = dynamic_cast<earl::value::Int *>(idx);
-    int I = idx1->value();
+    int64_t I = idx1->value();
     this->remove_char(I, expr);
 
     // if (I >= m_value.size()) {
@@ -256,7 +261,7 @@ Str::append(Obj *c) {
     else {
         auto s = dynamic_cast<Str *>(c);
         m_value += s->value();
-        for (int i=0; i < s->value().size(); ++i)
+        for (size_t i = 0; i < s->value().size(); ++i)
             m_chars.push_back(nullptr);
     }
 }
@@ -281,7 +286,7 @@ Str::filter(Obj *closure, std::shared_ptr<Ctx> &ctx) {
 
     auto acc = std::make_shared<Str>();
 
-    for (int i = 0; i < m_value.size(); ++i) {
+    for (size_t i = 0; i < m_value.size(); ++i) {
         std::shared_ptr<Char> cx = nullptr;
         if (m_chars.at(i)) {
             m_value.at(i) = m_chars.at(i)->value();
@@ -380,7 +385,7 @@ Str::value_as_earlchar(void) {
 std::shared_ptr<Char>
 Str::__get_elem(size_t idx) {
     this->update_changed();
-    int I = idx;
+    size_t I = idx;
     std::shared_ptr<Char> c = nullptr;
     if (m_chars.at(I)) {
         m_value.at(I) = m_chars.at(I)->value();
@@ -431,6 +436,16 @@ Str::eq(Obj *other) {
     return this->value() == dynamic_cast<Str *>(other)->value();
 }
 
+bool
+Str::is_hashable(void) const {
+    return true;
+}
+
+size_t
+Str::hash(void) {
+    return std::hash<std::string>()(this->value());
+}
+
 std::string
 Str::to_cxxstring(void) {
     return this->value();
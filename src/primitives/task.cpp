@@ -0,0 +1,109 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <memory>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+Task::Task() : m_state(std::make_shared<State>()) {}
+
+bool
+Task::done(void) const {
+    return m_state->done;
+}
+
+void
+Task::resolve(std::shared_ptr<Obj> value) {
+    m_state->value = value ? value : std::make_shared<Void>();
+    m_state->done = true;
+    auto callbacks = std::move(m_state->on_done);
+    for (auto &f : callbacks)
+        f();
+}
+
+void
+Task::reject(std::exception_ptr error) {
+    m_state->error = error;
+    m_state->done = true;
+    auto callbacks = std::move(m_state->on_done);
+    for (auto &f : callbacks)
+        f();
+}
+
+void
+Task::on_done(std::function<void(void)> f) {
+    if (m_state->done)
+        f();
+    else
+        m_state->on_done.push_back(std::move(f));
+}
+
+std::shared_ptr<Obj>
+Task::result(void) {
+    m_state->observed = true;
+    if (m_state->error)
+        std::rethrow_exception(m_state->error);
+    return m_state->value;
+}
+
+bool
+Task::unobserved_error(void) const {
+    return m_state->error && !m_state->observed;
+}
+
+Type
+Task::type(void) const {
+    return Type::Task;
+}
+
+bool
+Task::boolean(void) {
+    return m_state->done;
+}
+
+void
+Task::mutate(Obj *other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other, stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    m_state = dynamic_cast<Task *>(other)->m_state;
+}
+
+std::shared_ptr<Obj>
+Task::copy(void) {
+    auto value = std::make_shared<Task>();
+    value->m_state = m_state;
+    return value;
+}
+
+std::string
+Task::to_cxxstring(void) {
+    if (!m_state->done)
+        return "<Task { pending }>";
+    if (m_state->error)
+        return "<Task { failed }>";
+    return "<Task { done: "+m_state->value->to_cxxstring()+" }>";
+}
@@ -189,6 +189,24 @@ Tuple::eq(Obj *other) {
     return true;
 }
 
+bool
+Tuple::is_hashable(void) const {
+    for (auto &v : m_values)
+        if (!v->is_hashable())
+            return false;
+    return true;
+}
+
+size_t
+Tuple::hash(void) {
+    // Combine the element hashes in order (boost::hash_combine)
+    // so that (1, 2) and (2, 1) land in different buckets.
+    size_t seed = m_values.size();
+    for (auto &v : m_values)
+        seed ^= v->hash() + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
 std::string
 Tuple::to_cxxstring(void) {
     std::string res = "(";
@@ -243,7 +261,7 @@ Tuple::equality(Token *op, Obj *other) {
         return std::make_shared<Bool>(true);
     } break;
     case TokenType::Bang_Equals: {
-        UNIMPLEMENTED("Tuple::equality:TokenType::Bang_Equals");
+        return std::make_shared<Bool>(!this->eq(other));
     } break;
     default: {
         Err::err_wtok(op);
@@ -0,0 +1,505 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cerrno>
+#include <stdexcept>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "process.hpp"
+#include "output.hpp"
+#include "metrics.hpp"
+
+extern char **environ;
+
+// Builtins of `/bin/sh`. Some of them are also programs (`echo`,
+// `printf`, `test`, `kill`, ...) that behave differently, dash's
+// `echo` expands `\t` and has no `-e` for instance, so they always
+// go through the shell.
+static bool
+is_shell_builtin(const std::string &name) {
+    static const std::unordered_set<std::string> builtins = {
+        ".", ":", "[", "alias", "bg", "break", "cd", "command", "continue",
+        "echo", "eval", "exec", "exit", "export", "fc", "fg", "getopts",
+        "hash", "jobs", "kill", "local", "printf", "pwd", "read",
+        "readonly", "return", "set", "shift", "test", "times", "trap",
+        "type", "ulimit", "umask", "unalias", "unset", "wait",
+    };
+    return builtins.count(name) != 0;
+}
+
+bool
+process::split_simple(const std::string &cmd, std::vector<std::string> &argv) {
+    std::string word = "";
+    bool in_word = false;
+
+    for (size_t i = 0; i < cmd.size(); ++i) {
+        char c = cmd[i];
+
+        if (c == ' ' || c == '\t') {
+            if (in_word)
+                argv.push_back(std::move(word));
+            word.clear();
+            in_word = false;
+            continue;
+        }
+
+        if (c == '\'') {
+            size_t end = cmd.find('\'', i+1);
+            if (end == std::string::npos)
+                return false;
+            word += cmd.substr(i+1, end-i-1);
+            i = end;
+        }
+        else if (c == '"') {
+            size_t end = cmd.find('"', i+1);
+            if (end == std::string::npos)
+                return false;
+            std::string quoted = cmd.substr(i+1, end-i-1);
+            if (quoted.find_first_of("$`\\!") != std::string::npos)
+                return false;
+            word += quoted;
+            i = end;
+        }
+        else if (isalnum(static_cast<unsigned char>(c)) || std::string("-_./,:@+%^=").find(c) != std::string::npos) {
+            // `~` and `#` are only special at the start of a word,
+            // but they are rare enough to always hand to the shell.
+            // A `=` in the program name is a variable assignment.
+            if (c == '=' && argv.empty())
+                return false;
+            word += c;
+        }
+        else
+            return false;
+
+        in_word = true;
+    }
+
+    if (in_word)
+        argv.push_back(std::move(word));
+
+    return !argv.empty() && !is_shell_builtin(argv[0]);
+}
+
+static pid_t
+spawn(const std::vector<std::string> &args, posix_spawn_file_actions_t *actions, posix_spawnattr_t *attr) {
+    std::vector<char *> argv;
+    for (auto &arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    if (posix_spawnp(&pid, argv[0], actions, attr, argv.data(), environ) != 0)
+        return -1;
+    return pid;
+}
+
+// Start `cmd`, trying a direct spawn first. If the program cannot be
+// started directly (a shell builtin, a script without a shebang, not
+// found, ...) it is handed to `/bin/sh` so the error reporting and
+// exit status match what the shell would give.
+pid_t
+process::start(const std::string &cmd, posix_spawn_file_actions_t *actions, posix_spawnattr_t *attr) {
+    // The child writes to the same stdout, so anything printed
+    // before it was started has to be out first.
+    output::flush();
+
+    std::vector<std::string> args;
+    pid_t pid = -1;
+    if (process::split_simple(cmd, args))
+        pid = spawn(args, actions, attr);
+    if (pid == -1)
+        pid = spawn({"/bin/sh", "-c", cmd}, actions, attr);
+    if (pid != -1)
+        metrics::count(metrics::shell_spawned);
+    return pid;
+}
+
+static int
+wait_for(pid_t pid) {
+    int status;
+    while (waitpid(pid, &status, 0) == -1)
+        if (errno != EINTR)
+            return -1;
+    return status;
+}
+
+int
+process::run(const std::string &cmd) {
+    int64_t started = metrics::shell_start();
+    pid_t pid = process::start(cmd, nullptr);
+    if (pid == -1)
+        return -1;
+    int status = wait_for(pid);
+    metrics::shell_finish(started, status);
+    return status;
+}
+
+int
+process::run_capture(const std::string &cmd, std::string &out) {
+    int64_t started = metrics::shell_start();
+    int fds[2];
+    if (pipe(fds) == -1)
+        return -1;
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+    pid_t pid = process::start(cmd, &actions);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (pid == -1) {
+        close(fds[0]);
+        return -1;
+    }
+
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) != 0) {
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        out.append(buf, n);
+    }
+    close(fds[0]);
+
+    int status = wait_for(pid);
+    metrics::shell_finish(started, status);
+    return status;
+}
+
+// Large enough that a pipe full of output is drained in one read.
+#define LINE_READER_BUFSZ (64 * 1024)
+
+process::LineReader::LineReader(const std::string &cmd)
+    : m_pid(-1), m_fd(-1), m_eof(false), m_buf(LINE_READER_BUFSZ), m_start(0), m_end(0),
+      m_started(metrics::shell_start()) {
+    int fds[2];
+    if (pipe(fds) == -1)
+        return;
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+    m_pid = process::start(cmd, &actions);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (m_pid == -1)
+        close(fds[0]);
+    else
+        m_fd = fds[0];
+}
+
+process::LineReader::~LineReader() {
+    if (m_pid != -1) {
+        // Stopped early (a `break`, `return` or an error), the
+        // rest of the output is not wanted.
+        kill(m_pid, SIGTERM);
+        (void)finish();
+    }
+}
+
+bool
+process::LineReader::ok(void) const {
+    return m_pid != -1;
+}
+
+bool
+process::LineReader::next(std::string &line) {
+    line.clear();
+
+    while (true) {
+        char *begin = m_buf.data()+m_start;
+        char *nl = static_cast<char *>(memchr(begin, '\n', m_end-m_start));
+        if (nl) {
+            line.append(begin, nl-begin);
+            m_start = nl-m_buf.data()+1;
+            return true;
+        }
+
+        // No full line buffered, keep what is there and refill.
+        line.append(begin, m_end-m_start);
+        m_start = m_end = 0;
+
+        if (m_eof)
+            return !line.empty();
+
+        ssize_t n = read(m_fd, m_buf.data(), m_buf.size());
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            m_eof = true;
+        else
+            m_end = n;
+    }
+}
+
+int
+process::LineReader::finish(void) {
+    if (m_fd != -1)
+        close(m_fd);
+    m_fd = -1;
+    if (m_pid == -1)
+        return -1;
+    int status = wait_for(m_pid);
+    m_pid = -1;
+    metrics::shell_finish(m_started, status);
+    return status;
+}
+
+static void
+close_fd(int &fd) {
+    if (fd != -1)
+        close(fd);
+    fd = -1;
+}
+
+static void
+write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        data += n, len -= n;
+    }
+}
+
+namespace {
+    struct FilterState {
+        const process::Stage *stage;
+        int in = -1;
+        int out = -1;      // -1 when this is the last stage
+        std::string pending;
+        size_t off = 0;
+    };
+
+    // Writing to a command that already exited must not kill the
+    // interpreter, but the commands themselves keep the default.
+    struct IgnoreSigpipe {
+        IgnoreSigpipe() {
+            struct sigaction ign = {};
+            ign.sa_handler = SIG_IGN;
+            sigaction(SIGPIPE, &ign, &m_old);
+        }
+        ~IgnoreSigpipe() {
+            sigaction(SIGPIPE, &m_old, nullptr);
+        }
+        struct sigaction m_old;
+    };
+};
+
+std::vector<int>
+process::run_pipeline(const std::vector<Stage> &stages, std::string *out) {
+    IgnoreSigpipe ignore_sigpipe;
+    int64_t started = metrics::shell_start();
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t defaults;
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    std::vector<pid_t> pids;
+    std::vector<FilterState> filters;
+    int feed = -1;       // What the next stage reads from, -1 is our stdin
+    int final_fd = -1;   // The output of the last command, when collecting it
+
+    auto cleanup = [&]() {
+        close_fd(feed);
+        close_fd(final_fd);
+        for (auto &f : filters) {
+            close_fd(f.in);
+            close_fd(f.out);
+        }
+        posix_spawnattr_destroy(&attr);
+    };
+
+    try {
+        for (size_t i = 0; i < stages.size(); ++i) {
+            bool last = i == stages.size()-1;
+            int p[2] = {-1, -1};
+            if ((!last || out) && pipe2(p, O_CLOEXEC) == -1)
+                throw std::runtime_error("failed to create a pipe");
+
+            if (stages[i].filter) {
+                FilterState f;
+                f.stage = &stages[i];
+                f.in = feed;
+                feed = -1;
+                if (!last) {
+                    f.out = p[1];
+                    fcntl(f.out, F_SETFL, fcntl(f.out, F_GETFL) | O_NONBLOCK);
+                    feed = p[0];
+                }
+                else
+                    close_fd(p[0]), close_fd(p[1]);
+                filters.push_back(std::move(f));
+                continue;
+            }
+
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            if (feed != -1)
+                posix_spawn_file_actions_adddup2(&actions, feed, STDIN_FILENO);
+            if (p[1] != -1)
+                posix_spawn_file_actions_adddup2(&actions, p[1], STDOUT_FILENO);
+            pid_t pid = process::start(stages[i].cmd, &actions, &attr);
+            posix_spawn_file_actions_destroy(&actions);
+
+            close_fd(feed);
+            close_fd(p[1]);
+            if (pid == -1) {
+                close_fd(p[0]);
+                throw std::runtime_error("failed to execute `"+stages[i].cmd+"`");
+            }
+            pids.push_back(pid);
+            if (last)
+                final_fd = p[0];
+            else
+                feed = p[0];
+        }
+
+        char buf[LINE_READER_BUFSZ];
+        while (true) {
+            std::vector<pollfd> fds;
+            std::vector<int *> owners;
+            for (auto &f : filters) {
+                if (f.in == -1 && f.off == f.pending.size())
+                    close_fd(f.out);
+                if (f.in != -1 && f.off == f.pending.size()) {
+                    fds.push_back({f.in, POLLIN, 0});
+                    owners.push_back(&f.in);
+                }
+                if (f.out != -1 && f.off < f.pending.size()) {
+                    fds.push_back({f.out, POLLOUT, 0});
+                    owners.push_back(&f.out);
+                }
+            }
+            if (final_fd != -1) {
+                fds.push_back({final_fd, POLLIN, 0});
+                owners.push_back(&final_fd);
+            }
+            if (fds.empty())
+                break;
+
+            if (poll(fds.data(), fds.size(), -1) == -1) {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("failed to poll the pipeline");
+            }
+
+            for (size_t i = 0; i < fds.size(); ++i) {
+                if (fds[i].revents == 0)
+                    continue;
+                int *fd = owners[i];
+
+                if (fd == &final_fd) {
+                    ssize_t n = read(final_fd, buf, sizeof(buf));
+                    if (n > 0)
+                        out->append(buf, n);
+                    else if (n == 0 || errno != EINTR)
+                        close_fd(final_fd);
+                    continue;
+                }
+
+                FilterState *f = nullptr;
+                for (auto &candidate : filters)
+                    if (&candidate.in == fd || &candidate.out == fd)
+                        f = &candidate;
+
+                if (fd == &f->in) {
+                    ssize_t n = read(f->in, buf, sizeof(buf));
+                    if (n == -1 && errno == EINTR)
+                        continue;
+                    if (n <= 0) {
+                        close_fd(f->in);
+                        continue;
+                    }
+                    std::string chunk(buf, n);
+                    std::string result = f->stage->filter(chunk);
+                    if (f->out != -1) {
+                        f->pending = std::move(result);
+                        f->off = 0;
+                    }
+                    else if (out)
+                        out->append(result);
+                    else
+                        write_all(STDOUT_FILENO, result.data(), result.size());
+                }
+                else {
+                    ssize_t n = write(f->out, f->pending.data()+f->off, f->pending.size()-f->off);
+                    if (n > 0)
+                        f->off += n;
+                    else if (n == -1 && errno != EINTR && errno != EAGAIN) {
+                        // The next command stopped reading, drop the rest.
+                        close_fd(f->out);
+                        close_fd(f->in);
+                        f->pending.clear();
+                        f->off = 0;
+                    }
+                }
+            }
+        }
+    }
+    catch (...) {
+        cleanup();
+        for (pid_t pid : pids) {
+            kill(pid, SIGTERM);
+            (void)wait_for(pid);
+        }
+        throw;
+    }
+
+    cleanup();
+    std::vector<int> statuses;
+    for (pid_t pid : pids)
+        statuses.push_back(wait_for(pid));
+    // Timed as one command, that failed if any stage did.
+    int worst = 0;
+    for (int status : statuses)
+        if (status != 0)
+            worst = status;
+    metrics::shell_finish(started, worst);
+    return statuses;
+}
@@ -0,0 +1,818 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+
+#include "profiler.hpp"
+#include "earl.hpp"
+#include "common.hpp"
+#include "config.h"
+
+// Rows printed in the table, the JSON report has all of them.
+#define PROFILER_TABLE_ROWS 30
+
+// Callers listed per row in the table.
+#define PROFILER_TABLE_CALLERS 3
+
+// Caller id of calls made from the top level of the program.
+#define PROFILER_TOPLEVEL UINT32_MAX
+
+// Deepest call that is kept for samples, the ones
+// below it are still counted but not named.
+#define SAMPLER_MAX_DEPTH 128
+
+// Size of the sample ring buffer in words, a power of two.
+#define SAMPLER_RING_WORDS (1u << 20)
+
+// Hottest lines listed after the annotated source.
+#define LINE_PROFILER_HOT_ROWS 20
+
+bool profiler::active = false;
+bool profiler::lines_active = false;
+
+static bool calls_on = false;
+static bool samples_on = false;
+static bool line_times_on = false;
+static bool coverage_on = false;
+static bool report_registered = false;
+
+// How many calls are running, shared by both profilers.
+static size_t depth = 0;
+
+// Who the first call on the current stack is counted as called by,
+// the caller of the @async function for a task.
+static uint32_t root_caller = PROFILER_TOPLEVEL;
+
+struct Entry {
+    profiler::Kind kind;
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t inclusive_ns = 0;
+    uint64_t self_ns = 0;
+    // Activations currently on the stack, so that recursion
+    // only counts the outermost one towards inclusive time. Only
+    // the stack that is running counts, see `swap_stack`.
+    uint32_t active = 0;
+    std::unordered_map<uint32_t, uint64_t> callers;
+};
+
+struct Frame {
+    uint32_t id;
+    int64_t start_ns;
+    int64_t child_ns;
+};
+
+static std::string out_path = "";
+static std::vector<Entry> entries = {};
+static std::vector<Frame> stack = {};
+static std::unordered_map<std::string, uint32_t> ids[4];
+static std::unordered_map<std::string, uint32_t> member_ids = {};
+static int64_t start_ns = 0;
+
+static inline int64_t
+now_ns(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*** Sampler ***/
+
+// The calls that are running, as (id, row, col). Only written
+// outside of the signal handler, and `sample_depth` is only
+// raised once a frame is complete.
+static uint32_t sample_frames[SAMPLER_MAX_DEPTH][3];
+static std::atomic<uint32_t> sample_depth(0);
+
+// Samples are [n, (id, row, col) * n]. The handler is the only
+// writer of `ring_head` and `drain` the only writer of `ring_tail`.
+static uint32_t ring[SAMPLER_RING_WORDS];
+static std::atomic<uint64_t> ring_head(0);
+static std::atomic<uint64_t> ring_tail(0);
+static std::atomic<uint64_t> samples_dropped(0);
+
+static pthread_t sampled_thread;
+static std::string samples_path = "";
+static std::map<std::string, uint64_t> collapsed = {};
+static uint64_t samples_total = 0;
+
+static void
+sigprof_handler(int sig) {
+    (void)sig;
+    // Other threads (thread pools) can receive it too,
+    // but only the interpreter thread has a call stack.
+    if (!pthread_equal(pthread_self(), sampled_thread))
+        return;
+
+    uint32_t n = sample_depth.load(std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_acquire);
+    if (n > SAMPLER_MAX_DEPTH)
+        n = SAMPLER_MAX_DEPTH;
+
+    uint64_t head = ring_head.load(std::memory_order_relaxed);
+    uint64_t tail = ring_tail.load(std::memory_order_acquire);
+    uint64_t need = 1+3*static_cast<uint64_t>(n);
+    if (head-tail+need > SAMPLER_RING_WORDS) {
+        samples_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring[head++ & (SAMPLER_RING_WORDS-1)] = n;
+    for (uint32_t i = 0; i < n; ++i)
+        for (int j = 0; j < 3; ++j)
+            ring[head++ & (SAMPLER_RING_WORDS-1)] = sample_frames[i][j];
+    ring_head.store(head, std::memory_order_release);
+}
+
+static std::string frame_name(uint32_t id);
+
+// Fold the samples in the ring into `collapsed`.
+static void
+drain(void) {
+    uint64_t head = ring_head.load(std::memory_order_acquire);
+    uint64_t tail = ring_tail.load(std::memory_order_relaxed);
+    std::string stack = "";
+    while (tail < head) {
+        uint32_t n = ring[tail++ & (SAMPLER_RING_WORDS-1)];
+        stack = "<toplevel>";
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t id = ring[tail++ & (SAMPLER_RING_WORDS-1)];
+            uint32_t row = ring[tail++ & (SAMPLER_RING_WORDS-1)];
+            uint32_t col = ring[tail++ & (SAMPLER_RING_WORDS-1)];
+            stack += ';';
+            stack += frame_name(id);
+            if (row != 0) {
+                stack += '@';
+                stack += std::to_string(row);
+                stack += ':';
+                stack += std::to_string(col);
+            }
+        }
+        ++collapsed[stack];
+        ++samples_total;
+    }
+    ring_tail.store(tail, std::memory_order_release);
+}
+
+static void
+sample_push(size_t d, uint32_t id, Token *site) {
+    if (d < SAMPLER_MAX_DEPTH) {
+        sample_frames[d][0] = id;
+        sample_frames[d][1] = site ? static_cast<uint32_t>(site->m_row) : 0;
+        sample_frames[d][2] = site ? static_cast<uint32_t>(site->m_col) : 0;
+    }
+    std::atomic_signal_fence(std::memory_order_release);
+    sample_depth.store(static_cast<uint32_t>(d+1), std::memory_order_relaxed);
+
+    // Folding here keeps the handler from ever finding the ring full
+    // unless the program stays in one call for a very long time.
+    if (ring_head.load(std::memory_order_relaxed)-ring_tail.load(std::memory_order_relaxed) > SAMPLER_RING_WORDS/2)
+        drain();
+}
+
+static void
+write_samples(void) {
+    struct itimerval off = {};
+    (void)setitimer(ITIMER_PROF, &off, nullptr);
+    (void)signal(SIGPROF, SIG_IGN);
+    drain();
+
+    std::ofstream f(samples_path);
+    if (!f) {
+        std::cerr << "[EARL sample-profile] error: could not write `" << samples_path << "`" << std::endl;
+        return;
+    }
+    for (auto &[stack, count] : collapsed)
+        f << stack << ' ' << count << '\n';
+
+    std::cout.flush();
+    std::cerr << "[EARL sample-profile] " << samples_total << " samples";
+    uint64_t dropped = samples_dropped.load();
+    if (dropped != 0)
+        std::cerr << " (" << dropped << " dropped)";
+    std::cerr << " written to `" << samples_path << "`" << std::endl;
+}
+
+/*** Function profiler ***/
+
+static uint32_t
+intern(profiler::Kind kind, const std::string &name) {
+    auto &table = ids[static_cast<int>(kind)];
+    auto it = table.find(name);
+    if (it != table.end())
+        return it->second;
+    uint32_t id = static_cast<uint32_t>(entries.size());
+    entries.push_back(Entry{kind, name, 0, 0, 0, 0, {}});
+    table.emplace(name, id);
+    return id;
+}
+
+static size_t
+push(uint32_t id) {
+    Entry &e = entries[id];
+    ++e.calls;
+    ++e.active;
+    ++e.callers[stack.empty() ? root_caller : stack.back().id];
+    stack.push_back(Frame{id, now_ns(), 0});
+    return stack.size()-1;
+}
+
+static void
+pop(int64_t now) {
+    Frame f = stack.back();
+    stack.pop_back();
+
+    int64_t elapsed = now-f.start_ns;
+    Entry &e = entries[f.id];
+    e.self_ns += static_cast<uint64_t>(std::max<int64_t>(elapsed-f.child_ns, 0));
+    if (--e.active == 0)
+        e.inclusive_ns += static_cast<uint64_t>(elapsed);
+    if (!stack.empty())
+        stack.back().child_ns += elapsed;
+}
+
+static std::string
+frame_name(uint32_t id) {
+    return entries[id].name;
+}
+
+static void
+report_atexit(void) {
+    profiler::report();
+}
+
+static void
+register_report(void) {
+    if (!report_registered)
+        std::atexit(report_atexit);
+    report_registered = true;
+}
+
+void
+profiler::enable(const std::string &out) {
+    if (calls_on)
+        return;
+    out_path = out;
+    calls_on = true;
+    start_ns = now_ns();
+    profiler::active = true;
+    register_report();
+}
+
+void
+profiler::enable_sampling(const std::string &out, int hz) {
+    if (samples_on)
+        return;
+    samples_path = out;
+    samples_on = true;
+    sampled_thread = pthread_self();
+
+    struct sigaction sa = {};
+    sa.sa_handler = sigprof_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    (void)sigaction(SIGPROF, &sa, nullptr);
+
+    struct itimerval timer = {};
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000/std::max(hz, 1);
+    timer.it_value = timer.it_interval;
+    (void)setitimer(ITIMER_PROF, &timer, nullptr);
+
+    profiler::active = true;
+    register_report();
+}
+
+static size_t
+enter_id(uint32_t id, Token *site) {
+    size_t d = depth++;
+    if (calls_on)
+        push(id);
+    if (samples_on)
+        sample_push(d, id, site);
+    return d;
+}
+
+size_t
+profiler::enter(Kind kind, const std::string &name, Token *site) {
+    return enter_id(intern(kind, name), site);
+}
+
+size_t
+profiler::enter_member(int type, const std::string &name, Token *site) {
+    // Keyed by type and name without building the
+    // `<type>.<name>` string on every call.
+    std::string key = name;
+    key += '\0';
+    key += static_cast<char>(type);
+    auto it = member_ids.find(key);
+    if (it == member_ids.end()) {
+        uint32_t id = intern(Kind::Member, earl::value::type_to_str(static_cast<earl::value::Type>(type))+"."+name);
+        it = member_ids.emplace(std::move(key), id).first;
+    }
+    return enter_id(it->second, site);
+}
+
+void
+profiler::leave(size_t d) {
+    // Already gone if the profiler stopped while it was running.
+    if (d >= depth)
+        return;
+    depth = d;
+    if (samples_on)
+        sample_depth.store(static_cast<uint32_t>(d), std::memory_order_relaxed);
+    if (calls_on) {
+        int64_t now = now_ns();
+        while (stack.size() > d)
+            pop(now);
+    }
+}
+
+static const char *
+kind_to_cstr(profiler::Kind kind) {
+    switch (kind) {
+    case profiler::Kind::Function:  return "function";
+    case profiler::Kind::Closure:   return "closure";
+    case profiler::Kind::Intrinsic: return "intrinsic";
+    case profiler::Kind::Member:    return "member";
+    }
+    return "unknown";
+}
+
+static std::string
+json_escape(const std::string &s) {
+    std::string res = "";
+    for (char c : s) {
+        switch (c) {
+        case '"':  res += "\\\""; break;
+        case '\\': res += "\\\\"; break;
+        case '\n': res += "\\n"; break;
+        case '\t': res += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                res += buf;
+            }
+            else
+                res += c;
+        }
+    }
+    return res;
+}
+
+static std::vector<std::pair<uint32_t, uint64_t>>
+sorted_callers(const Entry &e) {
+    std::vector<std::pair<uint32_t, uint64_t>> callers(e.callers.begin(), e.callers.end());
+    std::sort(callers.begin(), callers.end(), [](auto &a, auto &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return callers;
+}
+
+static std::string
+caller_name(uint32_t id) {
+    return id == PROFILER_TOPLEVEL ? "<toplevel>" : entries[id].name;
+}
+
+static void
+write_json(const std::vector<uint32_t> &order, int64_t total_ns) {
+    std::ofstream f(out_path);
+    if (!f) {
+        std::cerr << "[EARL profile] error: could not write `" << out_path << "`" << std::endl;
+        return;
+    }
+
+    f << "{\n  \"total_ns\": " << total_ns << ",\n  \"functions\": [";
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Entry &e = entries[order[i]];
+        f << (i == 0 ? "\n" : ",\n")
+          << "    {\"name\": \"" << json_escape(e.name) << "\""
+          << ", \"kind\": \"" << kind_to_cstr(e.kind) << "\""
+          << ", \"calls\": " << e.calls
+          << ", \"inclusive_ns\": " << e.inclusive_ns
+          << ", \"self_ns\": " << e.self_ns
+          << ", \"callers\": [";
+        auto callers = sorted_callers(e);
+        for (size_t j = 0; j < callers.size(); ++j) {
+            f << (j == 0 ? "" : ", ")
+              << "{\"name\": \"" << json_escape(caller_name(callers[j].first)) << "\""
+              << ", \"calls\": " << callers[j].second << "}";
+        }
+        f << "]}";
+    }
+    f << "\n  ]\n}\n";
+}
+
+static void
+write_calls(void) {
+    // Calls that are still running (the program exited from
+    // inside of them) are finished now.
+    int64_t now = now_ns();
+    while (!stack.empty())
+        pop(now);
+    int64_t total_ns = now-start_ns;
+
+    std::vector<uint32_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = static_cast<uint32_t>(i);
+    std::sort(order.begin(), order.end(), [](uint32_t a, uint32_t b) {
+        if (entries[a].self_ns != entries[b].self_ns)
+            return entries[a].self_ns > entries[b].self_ns;
+        return entries[a].name < entries[b].name;
+    });
+
+    write_json(order, total_ns);
+
+    std::cout.flush();
+    auto ms = [](uint64_t ns) { return static_cast<double>(ns)/1e6; };
+    char line[512];
+
+    std::cerr << "[EARL profile] " << entries.size() << " functions over "
+              << ms(static_cast<uint64_t>(total_ns)) << " ms, report written to `" << out_path << "`" << std::endl;
+    std::snprintf(line, sizeof(line), "%12s %7s %12s %10s  %-9s  %-30s  %s",
+                  "self (ms)", "self %", "incl (ms)", "calls", "kind", "name", "top callers");
+    std::cerr << line << std::endl;
+
+    size_t rows = std::min<size_t>(order.size(), PROFILER_TABLE_ROWS);
+    for (size_t i = 0; i < rows; ++i) {
+        const Entry &e = entries[order[i]];
+        std::string callers = "";
+        auto sorted = sorted_callers(e);
+        for (size_t j = 0; j < sorted.size() && j < PROFILER_TABLE_CALLERS; ++j) {
+            if (j != 0)
+                callers += ", ";
+            callers += caller_name(sorted[j].first)+" ("+std::to_string(sorted[j].second)+")";
+        }
+        double pct = total_ns > 0 ? 100.0*static_cast<double>(e.self_ns)/static_cast<double>(total_ns) : 0.0;
+        std::snprintf(line, sizeof(line), "%12.3f %6.1f%% %12.3f %10llu  %-9s  %-30s  ",
+                      ms(e.self_ns), pct, ms(e.inclusive_ns),
+                      static_cast<unsigned long long>(e.calls), kind_to_cstr(e.kind), e.name.c_str());
+        std::cerr << line << callers << std::endl;
+    }
+    if (order.size() > rows)
+        std::cerr << "... " << order.size()-rows << " more in `" << out_path << "`" << std::endl;
+}
+
+/*** Line profiler ***/
+
+struct Line {
+    uint32_t file;
+    uint32_t row;
+    uint64_t hits = 0;
+    uint64_t self_ns = 0;
+};
+
+struct SourceFile {
+    std::string path;
+    // For lcov and for reading the source back, the
+    // program may have changed directory by then.
+    std::string abspath;
+    std::map<uint32_t, uint32_t> rows = {};
+};
+
+static std::string lines_path = "";
+static std::string coverage_path = "";
+static std::vector<Line> lines = {};
+static std::vector<SourceFile> files = {};
+static std::unordered_map<std::string, uint32_t> file_ids = {};
+static std::vector<Frame> line_stack = {};
+
+// Where `read_file` found `fp`, by the same search.
+static std::string
+resolve_source(const std::string &fp) {
+    std::vector<std::string> candidates = {};
+    if ((config::runtime::flags & __WITHOUT_STDLIB) == 0)
+        candidates.push_back(std::string(PREFIX "/include/EARL/")+fp);
+    for (const auto &dir : config::prelude::include::dirs)
+        candidates.push_back(dir+"/"+fp);
+    candidates.push_back(fp);
+
+    std::error_code ec;
+    for (const auto &path : candidates) {
+        if (std::filesystem::is_regular_file(path, ec)) {
+            std::filesystem::path abspath = std::filesystem::absolute(path, ec);
+            return ec ? path : abspath.lexically_normal().string();
+        }
+    }
+    return fp;
+}
+
+uint32_t
+profiler::line_id(const Token *tok) {
+    auto fit = file_ids.find(tok->m_fp);
+    if (fit == file_ids.end()) {
+        SourceFile f{tok->m_fp, resolve_source(tok->m_fp)};
+        fit = file_ids.emplace(tok->m_fp, static_cast<uint32_t>(files.size())).first;
+        files.push_back(std::move(f));
+    }
+
+    SourceFile &f = files[fit->second];
+    uint32_t row = static_cast<uint32_t>(tok->m_row);
+    auto rit = f.rows.find(row);
+    if (rit == f.rows.end()) {
+        rit = f.rows.emplace(row, static_cast<uint32_t>(lines.size())).first;
+        lines.push_back(Line{fit->second, row});
+    }
+    return rit->second;
+}
+
+void
+profiler::enable_lines(const std::string &out) {
+    if (line_times_on)
+        return;
+    lines_path = out;
+    line_times_on = true;
+    lines_active = true;
+    register_report();
+}
+
+void
+profiler::enable_coverage(const std::string &out) {
+    if (coverage_on)
+        return;
+    coverage_path = out;
+    coverage_on = true;
+    lines_active = true;
+    register_report();
+}
+
+size_t
+profiler::line_enter(uint32_t id) {
+    ++lines[id].hits;
+    if (!line_times_on)
+        return 0;
+    line_stack.push_back(Frame{id, now_ns(), 0});
+    return line_stack.size()-1;
+}
+
+static void
+line_pop(int64_t now) {
+    Frame f = line_stack.back();
+    line_stack.pop_back();
+    int64_t elapsed = now-f.start_ns;
+    lines[f.id].self_ns += static_cast<uint64_t>(std::max<int64_t>(elapsed-f.child_ns, 0));
+    if (!line_stack.empty())
+        line_stack.back().child_ns += elapsed;
+}
+
+void
+profiler::line_leave(size_t d) {
+    if (!line_times_on)
+        return;
+    int64_t now = now_ns();
+    while (line_stack.size() > d)
+        line_pop(now);
+}
+
+static std::vector<std::string>
+read_lines(const std::string &path) {
+    std::vector<std::string> res = {};
+    std::ifstream f(path);
+    std::string line = "";
+    while (std::getline(f, line))
+        res.push_back(line);
+    return res;
+}
+
+static void
+write_annotated(std::ostream &out) {
+    int64_t now = now_ns();
+    while (!line_stack.empty())
+        line_pop(now);
+
+    uint64_t total_ns = 0;
+    for (const Line &l : lines)
+        total_ns += l.self_ns;
+    auto pct = [&](uint64_t ns) {
+        return total_ns > 0 ? 100.0*static_cast<double>(ns)/static_cast<double>(total_ns) : 0.0;
+    };
+
+    std::vector<uint32_t> order(files.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = static_cast<uint32_t>(i);
+    std::sort(order.begin(), order.end(), [](uint32_t a, uint32_t b) {
+        return files[a].path < files[b].path;
+    });
+
+    std::vector<std::vector<std::string>> sources(files.size());
+    char buf[64];
+
+    for (uint32_t fid : order) {
+        const SourceFile &f = files[fid];
+        uint64_t hit = 0, file_ns = 0;
+        for (auto &[row, id] : f.rows) {
+            hit += lines[id].hits != 0;
+            file_ns += lines[id].self_ns;
+        }
+        if (hit == 0)
+            continue;
+
+        sources[fid] = read_lines(f.abspath);
+        const std::vector<std::string> &src = sources[fid];
+        std::snprintf(buf, sizeof(buf), "%.1f", pct(file_ns));
+        out << "==> " << f.path << " (" << hit << "/" << f.rows.size()
+            << " lines run, " << buf << "% of time) <==" << std::endl;
+
+        for (size_t i = 0; i < src.size(); ++i) {
+            auto it = f.rows.find(static_cast<uint32_t>(i+1));
+            if (it == f.rows.end())
+                std::snprintf(buf, sizeof(buf), "%12s %7s %5zu | ", "", "", i+1);
+            else if (lines[it->second].hits == 0)
+                std::snprintf(buf, sizeof(buf), "%12s %7s %5zu | ", "#####", "", i+1);
+            else
+                std::snprintf(buf, sizeof(buf), "%12llu %6.1f%% %5zu | ",
+                              static_cast<unsigned long long>(lines[it->second].hits),
+                              pct(lines[it->second].self_ns), i+1);
+            out << buf << src[i] << '\n';
+        }
+        out << std::endl;
+    }
+
+    std::vector<uint32_t> hot = {};
+    for (size_t i = 0; i < lines.size(); ++i)
+        if (lines[i].hits != 0)
+            hot.push_back(static_cast<uint32_t>(i));
+    std::sort(hot.begin(), hot.end(), [](uint32_t a, uint32_t b) {
+        if (lines[a].self_ns != lines[b].self_ns)
+            return lines[a].self_ns > lines[b].self_ns;
+        return a < b;
+    });
+    if (hot.size() > LINE_PROFILER_HOT_ROWS)
+        hot.resize(LINE_PROFILER_HOT_ROWS);
+
+    out << "==> hottest lines (" << static_cast<double>(total_ns)/1e6 << " ms in statements) <==" << std::endl;
+    for (uint32_t id : hot) {
+        const Line &l = lines[id];
+        const std::vector<std::string> &src = sources[l.file];
+        std::string text = l.row-1 < src.size() ? src[l.row-1] : "";
+        text.erase(0, text.find_first_not_of(" \t"));
+        std::snprintf(buf, sizeof(buf), "%6.1f%% %12llu  ", pct(l.self_ns), static_cast<unsigned long long>(l.hits));
+        out << buf << files[l.file].path << ":" << l.row << "  " << text << std::endl;
+    }
+}
+
+static void
+write_lines(void) {
+    std::cout.flush();
+    if (lines_path == "") {
+        write_annotated(std::cerr);
+        return;
+    }
+    std::ofstream f(lines_path);
+    if (!f) {
+        std::cerr << "[EARL line-profile] error: could not write `" << lines_path << "`" << std::endl;
+        return;
+    }
+    write_annotated(f);
+    std::cerr << "[EARL line-profile] " << lines.size() << " lines written to `" << lines_path << "`" << std::endl;
+}
+
+static void
+write_coverage(void) {
+    std::ofstream f(coverage_path);
+    if (!f) {
+        std::cerr << "[EARL coverage] error: could not write `" << coverage_path << "`" << std::endl;
+        return;
+    }
+
+    std::vector<uint32_t> order(files.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = static_cast<uint32_t>(i);
+    std::sort(order.begin(), order.end(), [](uint32_t a, uint32_t b) {
+        return files[a].abspath < files[b].abspath;
+    });
+
+    size_t found = 0, hit = 0;
+    f << "TN:\n";
+    for (uint32_t fid : order) {
+        const SourceFile &sf = files[fid];
+        size_t file_hit = 0;
+        f << "SF:" << sf.abspath << '\n';
+        for (auto &[row, id] : sf.rows) {
+            f << "DA:" << row << ',' << lines[id].hits << '\n';
+            file_hit += lines[id].hits != 0;
+        }
+        f << "LH:" << file_hit << '\n'
+          << "LF:" << sf.rows.size() << '\n'
+          << "end_of_record\n";
+        found += sf.rows.size();
+        hit += file_hit;
+    }
+
+    std::cout.flush();
+    std::cerr << "[EARL coverage] " << hit << "/" << found << " lines in "
+              << files.size() << " files, written to `" << coverage_path << "`" << std::endl;
+}
+
+/*** Tasks ***/
+
+struct profiler::Stack {
+    std::vector<Frame> calls = {};
+    std::vector<Frame> lines = {};
+    std::vector<std::array<uint32_t, 3>> samples = {};
+    size_t depth = 0;
+    uint32_t root_caller = PROFILER_TOPLEVEL;
+    int64_t left_ns = 0;
+};
+
+std::shared_ptr<profiler::Stack>
+profiler::new_stack(void) {
+    if (!active && !lines_active)
+        return nullptr;
+    auto res = std::make_shared<Stack>();
+    res->root_caller = stack.empty() ? root_caller : stack.back().id;
+    res->left_ns = now_ns();
+    return res;
+}
+
+void
+profiler::swap_stack(Stack *other) {
+    if (!other)
+        return;
+    int64_t now = now_ns();
+
+    // The calls that are left behind stop counting as active, and
+    // their time away is taken out of their self time when they
+    // come back as if it was spent in a callee.
+    for (const Frame &f : stack)
+        --entries[f.id].active;
+    for (const Frame &f : other->calls)
+        ++entries[f.id].active;
+    if (!other->calls.empty())
+        other->calls.back().child_ns += now-other->left_ns;
+    if (!other->lines.empty())
+        other->lines.back().child_ns += now-other->left_ns;
+
+    std::swap(stack, other->calls);
+    std::swap(line_stack, other->lines);
+    std::swap(depth, other->depth);
+    std::swap(root_caller, other->root_caller);
+    other->left_ns = now;
+
+    if (samples_on) {
+        size_t saved = std::min<size_t>(other->depth, SAMPLER_MAX_DEPTH);
+        std::vector<std::array<uint32_t, 3>> frames(saved);
+        sample_depth.store(0, std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        for (size_t i = 0; i < saved; ++i)
+            frames[i] = {sample_frames[i][0], sample_frames[i][1], sample_frames[i][2]};
+        for (size_t i = 0; i < other->samples.size(); ++i)
+            for (int j = 0; j < 3; ++j)
+                sample_frames[i][j] = other->samples[i][j];
+        other->samples = std::move(frames);
+        std::atomic_signal_fence(std::memory_order_release);
+        sample_depth.store(static_cast<uint32_t>(depth), std::memory_order_relaxed);
+    }
+}
+
+void
+profiler::report(void) {
+    active = false;
+    lines_active = false;
+    if (samples_on)
+        write_samples();
+    if (calls_on)
+        write_calls();
+    if (line_times_on)
+        write_lines();
+    if (coverage_on)
+        write_coverage();
+    samples_on = calls_on = line_times_on = coverage_on = false;
+}
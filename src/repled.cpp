@@ -36,10 +36,26 @@
 #include "utils.hpp"
 #include "intrinsics.hpp"
 
-static std::vector<std::string> KEYWORDS = COMMON_EARLKW_ASCPL;
-static std::vector<std::string> TYPES = COMMON_EARLTY_ASCPL;
+// These are only used by the REPL, so they are made on
+// first use instead of when any script starts.
 
-static repled::PrefixTrie TRIE;
+static const std::vector<std::string> &
+keywords(void) {
+    static const std::vector<std::string> kws = COMMON_EARLKW_ASCPL;
+    return kws;
+}
+
+static const std::vector<std::string> &
+types(void) {
+    static const std::vector<std::string> tys = COMMON_EARLTY_ASCPL;
+    return tys;
+}
+
+static repled::PrefixTrie &
+trie(void) {
+    static repled::PrefixTrie t;
+    return t;
+}
 
 int repled::get_terminal_height() {
     struct winsize ws;
@@ -357,7 +373,7 @@ repled::RawInput::get_char() {
 
 static bool
 is_keyword(std::string &word) {
-    for (auto &kw : KEYWORDS)
+    for (auto &kw : keywords())
         if (word == kw)
             return true;
     return false;
@@ -365,7 +381,7 @@ is_keyword(std::string &word) {
 
 static bool
 is_type(std::string &word) {
-    for (auto &ty : TYPES)
+    for (auto &ty : types())
         if (word == ty)
             return true;
     return false;
@@ -609,7 +625,7 @@ redraw_line(std::string &line, std::string &prompt, int pad, repled::SS &ss, boo
             last_word = ':' + last_word; // Prepend ':' if the line starts with it
         }
 
-        std::vector<std::string> completions = TRIE.get_completions(last_word);
+        std::vector<std::string> completions = trie().get_completions(last_word);
 
         // int cursor_row = repled::get_cursor_row();
         // int terminal_height = repled::get_terminal_height();
@@ -1004,19 +1020,19 @@ repled::getln(RawInput &RI, std::string prompt, std::vector<std::string> &histor
 void
 repled::init(std::vector<std::string> cmd_options) {
     std::vector<std::string> attrs = COMMON_EARLATTR_ASCPL;
-    for (size_t i = 0; i < KEYWORDS.size(); ++i)
-        TRIE.insert(KEYWORDS[i]);
-    for (size_t i = 0; i < TYPES.size(); ++i)
-        TRIE.insert(TYPES[i]);
+    for (size_t i = 0; i < keywords().size(); ++i)
+        trie().insert(keywords()[i]);
+    for (size_t i = 0; i < types().size(); ++i)
+        trie().insert(types()[i]);
     for (size_t i = 0; i < attrs.size(); ++i)
-        TRIE.insert(attrs[i]);
+        trie().insert(attrs[i]);
     for (size_t i = 0; i < cmd_options.size(); ++i)
-        TRIE.insert(cmd_options[i]);
+        trie().insert(cmd_options[i]);
     for (auto it = Intrinsics::intrinsic_functions.begin(); it != Intrinsics::intrinsic_functions.end(); ++it)
-        TRIE.insert(it->first);
+        trie().insert(it->first);
 }
 
 void repled::show_prefix_trie(void) {
-    TRIE.dump();
+    trie().dump();
 }
 
@@ -0,0 +1,226 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/wait.h>
+
+#include "shell-stats.hpp"
+
+// Rows of commands printed in the summary.
+#define SHELL_STATS_ROWS 20
+
+// How much of a command is shown in the summary.
+#define SHELL_STATS_CMD_WIDTH 60
+
+// HDR style buckets over microseconds. Exact below 64us, then 32
+// buckets for every power of two, so a percentile is off by at most
+// about 3% whatever the range of the commands.
+#define HDR_LINEAR  64
+#define HDR_SUB     32
+#define HDR_BUCKETS (HDR_LINEAR+(64-6)*HDR_SUB)
+
+bool shell_stats::active = false;
+
+static bool summary_on = false;
+static double slow_ms = -1.0;
+
+namespace {
+    struct Site {
+        std::string where;
+        std::string cmd;
+        uint64_t count = 0;
+        uint64_t total_us = 0;
+        uint64_t max_us = 0;
+        uint64_t failed = 0;
+        uint64_t bytes = 0;
+    };
+};
+
+// Not locked: commands are only run from the interpreter thread,
+// and @async tasks are switched to on that same thread.
+static uint64_t hist[HDR_BUCKETS];
+static uint64_t total_count = 0;
+static uint64_t total_us = 0;
+static uint64_t total_failed = 0;
+static uint64_t total_bytes = 0;
+static uint64_t max_us = 0;
+static std::unordered_map<std::string, Site> sites = {};
+
+static inline int64_t
+now_ns(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static size_t
+bucket_of(uint64_t us) {
+    if (us < HDR_LINEAR)
+        return static_cast<size_t>(us);
+    int msb = 63-__builtin_clzll(us);
+    return HDR_LINEAR+(msb-6)*HDR_SUB+((us >> (msb-5)) & (HDR_SUB-1));
+}
+
+// The largest value that lands in `bucket`.
+static uint64_t
+bucket_high(size_t bucket) {
+    if (bucket < HDR_LINEAR)
+        return bucket;
+    size_t i = bucket-HDR_LINEAR;
+    int shift = static_cast<int>(i/HDR_SUB)+1;
+    uint64_t low = (HDR_SUB+i%HDR_SUB) << shift;
+    return low+(static_cast<uint64_t>(1) << shift)-1;
+}
+
+static uint64_t
+percentile(double p) {
+    uint64_t want = static_cast<uint64_t>(p/100.0*total_count+0.5);
+    if (want == 0)
+        want = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HDR_BUCKETS; ++i) {
+        seen += hist[i];
+        if (seen >= want)
+            return std::min(bucket_high(i), max_us);
+    }
+    return max_us;
+}
+
+static int
+exit_code(int status) {
+    if (status == -1)
+        return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128+WTERMSIG(status);
+}
+
+static std::string
+one_line(const std::string &cmd) {
+    std::string res = cmd;
+    std::replace(res.begin(), res.end(), '\n', ' ');
+    return res;
+}
+
+static std::string
+where_of(const Token *site) {
+    if (!site)
+        return "<unknown>";
+    return site->m_fp+":"+std::to_string(site->m_row)+":"+std::to_string(site->m_col);
+}
+
+int64_t
+shell_stats::start(void) {
+    return active ? now_ns() : 0;
+}
+
+void
+shell_stats::finish(int64_t start, const std::string &cmd, const Token *site, int status, size_t bytes) {
+    if (!active || start == 0)
+        return;
+    uint64_t us = static_cast<uint64_t>(now_ns()-start)/1000;
+    int code = exit_code(status);
+    std::string where = where_of(site);
+
+    if (slow_ms >= 0.0 && us/1000.0 > slow_ms) {
+        std::cout.flush();
+        std::fprintf(stderr, "[EARL slow-bash] %.3fms %s (exit %d): %s\n",
+                     us/1000.0, where.c_str(), code, one_line(cmd).c_str());
+    }
+
+    ++hist[bucket_of(us)];
+    ++total_count;
+    total_us += us;
+    total_bytes += bytes;
+    total_failed += code != 0;
+    max_us = std::max(max_us, us);
+
+    // Commands are grouped by where they are, a command built
+    // from a variable is the same command every time around a loop.
+    Site &s = sites[site ? where : cmd];
+    s.where = where;
+    s.cmd = cmd;
+    ++s.count;
+    s.total_us += us;
+    s.max_us = std::max(s.max_us, us);
+    s.failed += code != 0;
+    s.bytes += bytes;
+}
+
+static void
+report(void) {
+    std::cout.flush();
+
+    std::fprintf(stderr, "[EARL shell] %llu commands in %.3fs, %llu failed, %llu bytes captured\n",
+                 static_cast<unsigned long long>(total_count), total_us/1e6,
+                 static_cast<unsigned long long>(total_failed), static_cast<unsigned long long>(total_bytes));
+    if (total_count == 0)
+        return;
+
+    std::fprintf(stderr, "[EARL shell] p50 %.3fms  p90 %.3fms  p99 %.3fms  p99.9 %.3fms  max %.3fms\n",
+                 percentile(50)/1000.0, percentile(90)/1000.0, percentile(99)/1000.0,
+                 percentile(99.9)/1000.0, max_us/1000.0);
+
+    std::vector<const Site *> rows = {};
+    for (auto &entry : sites)
+        rows.push_back(&entry.second);
+    std::sort(rows.begin(), rows.end(), [](const Site *a, const Site *b) {
+        return a->total_us != b->total_us ? a->total_us > b->total_us : a->where < b->where;
+    });
+
+    std::fprintf(stderr, "%12s %8s %10s %10s %6s %10s  %s\n",
+                 "total ms", "calls", "mean ms", "max ms", "failed", "bytes", "where: command");
+    for (size_t i = 0; i < rows.size() && i < SHELL_STATS_ROWS; ++i) {
+        const Site *s = rows[i];
+        std::string cmd = one_line(s->cmd);
+        if (cmd.size() > SHELL_STATS_CMD_WIDTH)
+            cmd = cmd.substr(0, SHELL_STATS_CMD_WIDTH-3)+"...";
+        std::fprintf(stderr, "%12.3f %8llu %10.3f %10.3f %6llu %10llu  %s: %s\n",
+                     s->total_us/1000.0, static_cast<unsigned long long>(s->count),
+                     s->total_us/1000.0/s->count, s->max_us/1000.0,
+                     static_cast<unsigned long long>(s->failed), static_cast<unsigned long long>(s->bytes),
+                     s->where.c_str(), cmd.c_str());
+    }
+    if (rows.size() > SHELL_STATS_ROWS)
+        std::fprintf(stderr, "... and %zu more\n", rows.size()-SHELL_STATS_ROWS);
+}
+
+void
+shell_stats::enable_summary(void) {
+    if (!summary_on)
+        std::atexit(report);
+    summary_on = true;
+    active = true;
+}
+
+void
+shell_stats::enable_slow_log(double ms) {
+    slow_ms = ms;
+    active = true;
+}
@@ -0,0 +1,100 @@
+# MIT License
+
+# Copyright (c) 2023 malloc-nbytes
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+module Async
+
+### Function
+#-- Name: await
+#-- Parameter: task: Task
+#-- Returns: any
+#-- Description:
+#--   Waits for `task` to finish and returns its value. Inside of
+#--   an @async function this lets other tasks run in the meantime.
+#-- Example:
+#--   let value = Async::await(fetch());
+@pub fn await(task) {
+    return __internal_await__(task);
+}
+### End
+
+### Function
+#-- Name: await_all
+#-- Parameter: tasks: list<Task>
+#-- Returns: list<any>
+#-- Description:
+#--   Waits for every task in `tasks` to finish and returns
+#--   their values in the same order.
+@pub fn await_all(tasks: list): list {
+    return __internal_await_all__(tasks);
+}
+### End
+
+### Function
+#-- Name: await_any
+#-- Parameter: tasks: list<Task>
+#-- Returns: tuple<int, any>
+#-- Description:
+#--   Waits for the first task in `tasks` to finish and returns
+#--   a tuple of its index and its value.
+@pub fn await_any(tasks: list): tuple {
+    return __internal_await_any__(tasks);
+}
+### End
+
+### Function
+#-- Name: timer
+#-- Parameter: ms: int
+#-- Returns: Task
+#-- Description:
+#--   Creates a task that finishes after `ms` milliseconds.
+#-- Example:
+#--   let _ = Async::await(Async::timer(100));
+@pub fn timer(ms: int) {
+    return __internal_timer__(ms);
+}
+### End
+
+### Function
+#-- Name: fd_readable
+#-- Parameter: fd: int
+#-- Returns: Task
+#-- Description:
+#--   Creates a task that finishes once the file descriptor
+#--   `fd` has something to read.
+@pub fn fd_readable(fd: int) {
+    return __internal_fd_readable__(fd);
+}
+### End
+
+### Function
+#-- Name: bash
+#-- Parameter: cmd: str
+#-- Returns: Task
+#-- Description:
+#--   Runs the shell command `cmd` in the background. The task
+#--   resolves to a tuple of the exit code, stdout and stderr.
+#-- Example:
+#--   let code, out, err = Async::await(Async::bash("ls"));
+@pub fn bash(cmd: str) {
+    return __internal_bash_async__(cmd);
+}
+### End
@@ -22,31 +22,79 @@
 
 module Matrix
 
+### Function
+#-- Name: new
+#-- Parameter: rows: int
+#-- Parameter: cols: int
+#-- Parameter: init: list<int|float>
+#-- Returns: Matrix
+#-- Description:
+#--   Creates a builtin `rows` x `cols` matrix of floats from `init`,
+#--   which is either a flat list of elements or a list of rows.
+#-- Example:
+#--   let m = Matrix::new(2, 2, [1, 2, 3, 4]);
+@pub fn new(rows: int, cols: int, init: list) {
+    return __internal_matrix__(rows, cols, init);
+}
+### End
+
+### Function
+#-- Name: zeros
+#-- Parameter: rows: int
+#-- Parameter: cols: int
+#-- Returns: Matrix
+#-- Description:
+#--   Creates a builtin `rows` x `cols` matrix with every element 0.
+@pub fn zeros(rows: int, cols: int) {
+    return __internal_matrix__(rows, cols);
+}
+### End
+
 ### Class
 #-- Name: T
-#-- Parameter: init: list<any>
+#-- Parameter: init: list<int|float>
 #-- Parameter: rows: int
 #-- Parameter: cols: int
 #-- Description:
 #--   Creates a new matrix with the initial dataset `init`
-#--   with `rows` rows and `cols` columns.
+#--   with `rows` rows and `cols` columns. The elements are
+#--   stored natively as contiguous floats.
 @pub class T [init: list, rows: int, cols: int] {
-    let x = 1;
-    let lst = init;
+    let m = new(rows, cols, init);
     let r, c = (rows, cols);
 
     ### Method
     #-- Name: at
     #-- Parameter: i: int
     #-- Parameter: j: int
-    #-- Returns: any
+    #-- Returns: float
     #-- Description:
     #--   Returns the element at [ `i` ][ `j` ] in the matrix.
     @pub fn at(i, j) {
-        if i < 0 || i >= this.r || j < 0 || j >= this.c {
-            panic(f"The index at [{i}][{j}] is out of range of matrix of size {r}x{c} (size ", this.c*this.r, ")");
-        }
-        return this.lst[i*this.c+j];
+        return this.m.at(i, j);
+    }
+    ### End
+
+    ### Method
+    #-- Name: set
+    #-- Parameter: i: int
+    #-- Parameter: j: int
+    #-- Parameter: value: int|float
+    #-- Returns: unit
+    #-- Description:
+    #--   Sets the element at [ `i` ][ `j` ] in the matrix to `value`.
+    @pub fn set(i, j, value) {
+        this.m.set(i, j, value);
+    }
+    ### End
+
+    ### Method
+    #-- Name: raw
+    #-- Returns: Matrix
+    #-- Description:
+    #--   Returns the underlying native matrix.
+    @pub fn raw() {
+        return this.m;
     }
     ### End
 
@@ -58,7 +106,7 @@ module Matrix
     @pub fn show() {
         for i in 0 to this.r {
             for j in 0 to this.c {
-                print(this.lst[i*this.c+j]);
+                print(this.m.at(i, j));
                 if j != this.c-1 {
                     print(' ');
                 }
@@ -116,3 +164,28 @@ module Matrix
     return T(actual, rows, cols);
 }
 ### End
+
+### Function
+#-- Name: transpose
+#-- Parameter: m: T
+#-- Returns: T
+#-- Description:
+#--   Returns the transpose of `m`.
+@pub fn transpose(m: T): T {
+    let t = m.raw().transpose();
+    return T(t.to_list(), t.rows(), t.cols());
+}
+### End
+
+### Function
+#-- Name: mul
+#-- Parameter: a: T
+#-- Parameter: b: T
+#-- Returns: T
+#-- Description:
+#--   Returns the matrix product of `a` and `b`.
+@pub fn mul(a: T, b: T): T {
+    let p = a.raw().matmul(b.raw());
+    return T(p.to_list(), p.rows(), p.cols());
+}
+### End
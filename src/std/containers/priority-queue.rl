@@ -0,0 +1,52 @@
+# MIT License
+
+# Copyright (c) 2023 malloc-nbytes
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+module PriorityQueue
+
+### Function
+#-- Name: new
+#-- Returns: PriorityQueue
+#-- Description:
+#--   Creates an empty builtin `PriorityQueue` where `top` and
+#--   `pop` give the smallest element first.
+#-- Example:
+#--   let q = PriorityQueue::new();
+#--   q.push(3);
+@pub fn new() {
+    return __internal_priority_queue__();
+}
+### End
+
+### Function
+#-- Name: with_cmp
+#-- Parameter: cmp: closure
+#-- Returns: PriorityQueue
+#-- Description:
+#--   Creates an empty builtin `PriorityQueue` ordered by `cmp`, which
+#--   takes two elements and returns `true` if the first one should
+#--   come out before the second.
+#-- Example:
+#--   let maxq = PriorityQueue::with_cmp(|a, b| { return a > b; });
+@pub fn with_cmp(cmp: closure) {
+    return __internal_priority_queue__(cmp);
+}
+### End
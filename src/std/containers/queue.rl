@@ -26,9 +26,10 @@ module Queue
 #-- Name: T
 #-- Parameter: init: list
 #-- Description:
-#--   A queue data structure.
+#--   A queue data structure. This is a thin wrapper around
+#--   the builtin `Deque` type, so `push` and `pop` are O(1).
 @pub class T [init: list] {
-    let lst = init;
+    let dq = __internal_deque__(init);
 
     ### Method
     #-- Name: push
@@ -37,7 +38,7 @@ module Queue
     #-- Description:
     #--   Pushes a value to the back of the queue.
     @pub fn push(val) {
-        this.lst.append(val);
+        this.dq.push_back(val);
     }
     ### End
 
@@ -47,10 +48,10 @@ module Queue
     #-- Description:
     #--   Pops the front value from the queue.
     @pub fn pop() {
-        if len(this.lst) == 0 {
+        if this.dq.empty() {
             panic(__FILE__, ':', __FUNC__, ": ", "Queue is empty");
         }
-        this.lst.pop(0);
+        let _ = this.dq.pop_front();
     }
     ### End
 
@@ -60,10 +61,10 @@ module Queue
     #-- Description:
     #--   Returns the front value of the queue.
     @pub fn front() {
-        if len(this.lst) == 0 {
+        if this.dq.empty() {
             panic(__FILE__, ':', __FUNC__, ": ", "Queue is empty");
         }
-        this.lst[0];
+        this.dq.front();
     }
     ### End
 
@@ -73,7 +74,7 @@ module Queue
     #-- Description:
     #--   Returns true if the queue is empty.
     @pub fn empty() {
-        len(this.lst) == 0;
+        this.dq.empty();
     }
     ### End
 
@@ -83,7 +84,7 @@ module Queue
     #-- Description:
     #--   Returns the size of the queue.
     @pub fn size() {
-        len(this.lst);
+        len(this.dq);
     }
     ### End
 
@@ -93,7 +94,7 @@ module Queue
     #-- Description:
     #--   Clears the queue.
     @pub fn clear() {
-        this.lst = [];
+        this.dq = __internal_deque__();
     }
     ### End
 }
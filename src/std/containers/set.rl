@@ -22,28 +22,29 @@
 
 module Set
 
+### Function
+#-- Name: new
+#-- Parameter: init: list
+#-- Returns: Set
+#-- Description:
+#--   Creates a builtin `Set` holding the elements of `init`. Any
+#--   hashable value (int, float, bool, char, str) can be an element.
+#-- Example:
+#--   let s = Set::new([1, 2, 3]);
+@pub fn new(init) {
+    return __internal_set__(init);
+}
+### End
+
 ### Class
 #-- Name: T
-#-- Parameter: init: list<x0: any, x1: type(x0), ..., xN: type(x0)>
+#-- Parameter: init: list
 #-- Description:
 #--   Creates a new Set container with the initializer list `init`.
+#--   This is a thin wrapper around the builtin `Set` type, so any
+#--   hashable value (int, float, bool, char, str) can be an element.
 @pub class T [init] {
-    let items = none;
-    let type_ = int;
-
-    fn init(value) {
-        this.type_ = typeof(value);
-        items = some(Dict(this.type_));
-    }
-
-    fn constructor() {
-        if len(init) != 0 {
-            this.init(init[0]);
-            for i in 0 to len(init) {
-                this.insert(init[i]);
-            }
-        }
-    }
+    let items = new(init);
 
     ### Method
     #-- Name: insert
@@ -51,22 +52,20 @@ module Set
     #-- Returns: unit
     #-- Description:
     #--  Insert `value` into the `set`. A panic will occur
-    #--  if the `typeof(value)` is not the same as the other
-    #--  values in the `set`.
+    #--  if `value` is not hashable.
     @pub fn insert(value) {
-        if !items {
-            this.init(value);
-        }
-
-        if typeof(value) != type_ {
-            panic(f"Set::T expected value `{type_}` but got: ", typeof(value));
-        }
+        this.items.insert(value);
+    }
+    ### End
 
-        if !this.items.unwrap()[value] {
-            this.items
-                    .unwrap()
-                    .insert(value, _);
-        }
+    ### Method
+    #-- Name: remove
+    #-- Parameter: value: any
+    #-- Returns: bool
+    #-- Description:
+    #--   Removes `value` from the `set`. Returns `true` if it was present.
+    @pub fn remove(value) {
+        return this.items.remove(value);
     }
     ### End
 
@@ -76,20 +75,39 @@ module Set
     #-- Returns: bool
     #-- Description:
     #--   Returns `true` if `value` is in the `set`, or `false` if it is not.
-    #--   A panic will occur if the `typeof(value)` is not the same as the other
-    #--   values in the `set`.
     @pub fn contains(value) {
-        if typeof(value) != type_ {
-            panic(f"Set::T expected value  `{type_}` but got: ", typeof(value));
-        }
+        return this.items.contains(value);
+    }
+    ### End
+
+    ### Method
+    #-- Name: size
+    #-- Returns: int
+    #-- Description:
+    #--   Returns the number of elements in the `set`.
+    @pub fn size() {
+        return len(this.items);
+    }
+    ### End
 
-        if !this.items {
-            return false;
-        }
+    ### Method
+    #-- Name: empty
+    #-- Returns: bool
+    #-- Description:
+    #--   Returns `true` if the `set` has no elements.
+    @pub fn empty() {
+        return this.items.empty();
+    }
+    ### End
 
-        return this.items
-                       .unwrap()[value]
-                       .is_some();
+    ### Method
+    #-- Name: raw
+    #-- Returns: Set
+    #-- Description:
+    #--   Returns the underlying builtin `Set`. Use it for
+    #--   `union`, `intersection`, `difference` and iteration.
+    @pub fn raw() {
+        return this.items;
     }
     ### End
 }
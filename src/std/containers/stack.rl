@@ -26,9 +26,10 @@ module Stack
 #-- Name: T
 #-- Parameter: init: list
 #-- Description:
-#--   A stack data structure.
-class T [init] {
-    let lst = init;
+#--   A stack data structure. This is a thin wrapper
+#--   around the builtin `Deque` type.
+@pub class T [init] {
+    let dq = __internal_deque__(init);
 
     ### Method
     #-- Name: push
@@ -37,7 +38,7 @@ class T [init] {
     #-- Description:
     #--   Pushes a value to the top of the stack.
     @pub fn push(val) {
-        this.lst.append(val);
+        this.dq.push_back(val);
     }
     ### End
 
@@ -47,10 +48,10 @@ class T [init] {
     #-- Description:
     #--   Pops the top value from the stack.
     @pub fn pop() {
-        if len(this.lst) == 0 {
+        if this.dq.empty() {
             panic(__FILE__, ':', __FUNC__, ": ", "Stack is empty");
         }
-        this.lst.pop(len(this.lst) - 1);
+        let _ = this.dq.pop_back();
     }
     ### End
 
@@ -60,10 +61,10 @@ class T [init] {
     #-- Description:
     #--   Returns the top value of the stack.
     @pub fn top() {
-        if len(this.lst) == 0 {
+        if this.dq.empty() {
             panic(__FILE__, ':', __FUNC__, ": ", "Stack is empty");
         }
-        this.lst[len(this.lst) - 1];
+        this.dq.back();
     }
     ### End
 
@@ -73,7 +74,7 @@ class T [init] {
     #-- Description:
     #--   Clears the stack.
     @pub fn clear() {
-        this.lst = [];
+        this.dq = __internal_deque__();
     }
     ### End
 
@@ -82,8 +83,8 @@ class T [init] {
     #-- Returns: bool
     #-- Description:
     #--   Returns true if the stack is empty.
-    @pub fn clear() {
-        this.lst = [];
+    @pub fn empty() {
+        this.dq.empty();
     }
     ### End
 }
@@ -81,6 +81,61 @@ import "std/system.rl";
 }
 ### End
 
+### Function
+#-- Name: write_lines
+#-- Parameter: lines: list
+#-- Parameter: fp: str
+#-- Returns: unit
+#-- Description:
+#--   Writes every element of `lines` to the file `fp`
+#--   on its own line, all in a single write.
+@pub fn write_lines(lines: list, fp: str): unit {
+    let f = open(fp, "w");
+    f.writelines(lines);
+    f.close();
+}
+### End
+
+### Function
+#-- Name: print_all
+#-- Parameter: lst: list
+#-- Returns: unit
+#-- Description:
+#--   Prints every element of `lst` on its own line,
+#--   all in a single write.
+@pub fn print_all(lst: list): unit {
+    __internal_print_all__(lst);
+}
+### End
+
+### Function
+#-- Name: print_all_wsep
+#-- Parameter: lst: list
+#-- Parameter: sep: str
+#-- Returns: unit
+#-- Description:
+#--   Prints every element of `lst` with `sep` between them
+#--   followed by a newline, all in a single write.
+#-- Example:
+#--   IO::print_all_wsep([1, 2, 3], ", "); # 1, 2, 3
+@pub fn print_all_wsep(lst: list, sep: str): unit {
+    __internal_print_all__(lst, sep);
+}
+### End
+
+### Function
+#-- Name: set_stdout_buffer
+#-- Parameter: mode: str
+#-- Returns: unit
+#-- Description:
+#--   Sets when stdout is flushed. `mode` is one of `auto`
+#--   (line buffered on a terminal, fully buffered otherwise),
+#--   `line`, `full` or `none`.
+@pub fn set_stdout_buffer(mode: str): unit {
+    __internal_set_stdout_buffer__(mode);
+}
+### End
+
 ### Function
 #-- Name: rename
 #-- Parameter: path_from: str
@@ -93,28 +148,34 @@ import "std/system.rl";
 }
 ### End
 
-fn __walkdir(@const @ref dir, @ref files) {
-    foreach f in System::ls(dir) {
-        if System::isdir(f) {
-            __walkdir(f, files);
-        }
-        else {
-            files.append(f);
-        }
-    }
-}
-
 ### Function
 #-- Name: walkdir
 #-- Parameter: dir: str
 #-- Returns: list<str>
 #-- Description:
 #--   Walks the directory `dir` recursively, returning
-#--   all files found.
+#--   all files found. See `walk` for filtering by
+#--   extension, glob or depth.
 @pub fn walkdir(dir) {
-    let files = [];
-    __walkdir(dir, files);
-    return files;
+    return __internal_walk__(dir);
+}
+### End
+
+### Function
+#-- Name: walk
+#-- Parameter: dir: str
+#-- Parameter: opts: dictionary<str, any>
+#-- Returns: list<str>
+#-- Description:
+#--   Walks the directory `dir` recursively and returns a sorted
+#--   list of the files found. `opts` may contain `ext` (str or
+#--   list of str), `glob` (str), `max_depth` (int), `threads`
+#--   (int, 0 for one per CPU) and `dirs` (bool, also list
+#--   directories).
+#-- Example:
+#--   let srcs = IO::walk("src", {"ext": [".cpp", ".hpp"]});
+@pub fn walk(dir: str, opts) {
+    return __internal_walk__(dir, opts);
 }
 ### End
 
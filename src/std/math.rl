@@ -225,23 +225,74 @@ fn volume_of_cone(r: real, h: real): real {
 
 ### Function
 #-- Name: floor
-#-- Parameter: f: float
+#-- Parameter: f: real
 #-- Returns: int
 #-- Description:
-#--   Returns the floor of `f`.
-@pub fn floor(f: float): int {
-    return int(f);
+#--   Returns the largest integer not greater than `f`.
+@pub fn floor(f: real): int {
+    return __internal_floor__(f);
 }
 ### End
 
 ### Function
 #-- Name: ceil
-#-- Parameter: f: float
+#-- Parameter: f: real
+#-- Returns: int
+#-- Description:
+#--   Returns the smallest integer not less than `f`.
+@pub fn ceil(f: real): int {
+    return __internal_ceil__(f);
+}
+### End
+
+### Function
+#-- Name: pow
+#-- Parameter: x: real
+#-- Parameter: y: real
+#-- Returns: float
+#-- Description:
+#--   Returns `x` raised to the power `y` in double precision.
+#--   Use `x ** y` with two integers for an exact result.
+@pub fn pow(x: real, y: real): float {
+    return __internal_pow__(x, y);
+}
+### End
+
+### Function
+#-- Name: powmod
+#-- Parameter: base: int
+#-- Parameter: exp: int
+#-- Parameter: mod: int
+#-- Returns: int
+#-- Description:
+#--   Returns (`base` ** `exp`) % `mod` without computing the
+#--   full power. `exp` must not be negative and `mod` must be positive.
+@pub fn powmod(base: int, exp: int, mod: int): int {
+    return __internal_powmod__(base, exp, mod);
+}
+### End
+
+### Function
+#-- Name: gcd
+#-- Parameter: a: int
+#-- Parameter: b: int
+#-- Returns: int
+#-- Description:
+#--   Returns the greatest common divisor of `a` and `b`.
+@pub fn gcd(a: int, b: int): int {
+    return __internal_gcd__(a, b);
+}
+### End
+
+### Function
+#-- Name: lcm
+#-- Parameter: a: int
+#-- Parameter: b: int
 #-- Returns: int
 #-- Description:
-#--   Returns the ceil of `f`.
-@pub fn ceil(f: float): int {
-    return floor(1+f);
+#--   Returns the least common multiple of `a` and `b`.
+@pub fn lcm(a: int, b: int): int {
+    return __internal_lcm__(a, b);
 }
 ### End
 
@@ -222,20 +222,69 @@ module System
 #-- Returns: list<str>
 #-- Description:
 #--   Get all files in the directory `dir` that have the
-#--   file extension `ext`.
+#--   file extension `ext`, sorted. Subdirectories are not
+#--   searched, see `IO::walk` for that.
 #-- Example:
 #--   let cppfiles = get_all_files_by_ext(".", "cpp");
 @pub fn get_all_files_by_ext(@const @ref dir: str, @const @ref ext: str): list {
-    let matches = [];
+    return __internal_walk__(dir, {"ext": ext, "max_depth": 1});
+}
+### End
 
-    with files = ls(dir) in
-    foreach f in files {
-        with parts = name_and_ext(f) in
-        if (parts[0] && parts[1] && parts[1].unwrap() == ext) {
-            matches.append(f);
-        }
-    }
+### Function
+#-- Name: pipeline
+#-- Parameter: stages: list<str|closure>
+#-- Returns: tuple<list<int>, str>
+#-- Description:
+#--   Run the commands in `stages` concurrently with the output
+#--   of each stage connected to the input of the next. A stage
+#--   can also be a closure that maps a chunk of output to a new
+#--   one. Closures run inside of this function, so they cannot
+#--   see the local variables of the caller. Returns a tuple of
+#--   the exit codes of the commands and the output of the last
+#--   stage.
+#-- Example:
+#--   let codes, n = System::pipeline(["ls", "grep .rl", "wc -l"]);
+@pub fn pipeline(stages: list): tuple {
+    return __internal_pipeline__(stages);
+}
+### End
+
+### Function
+#-- Name: pipeline_wstdout
+#-- Parameter: stages: list<str|closure>
+#-- Returns: tuple<list<int>, str>
+#-- Description:
+#--   Like `pipeline`, but the output of the last stage goes
+#--   to stdout instead of being collected.
+@pub fn pipeline_wstdout(stages: list): tuple {
+    return __internal_pipeline__(stages, false);
+}
+### End
 
-    return matches;
+### Function
+#-- Name: procpool
+#-- Returns: ProcPool
+#-- Description:
+#--   Creates a pool for running shell commands concurrently
+#--   with at most one command per CPU running at once.
+#-- Example:
+#--   let pool = System::procpool();
+#--   let job = pool.spawn("make -C lib");
+#--   let code, out, err = pool.wait(job);
+@pub fn procpool() {
+    return __internal_procpool__();
+}
+### End
+
+### Function
+#-- Name: procpool_wlimit
+#-- Parameter: limit: int
+#-- Returns: ProcPool
+#-- Description:
+#--   Creates a pool for running shell commands concurrently
+#--   with at most `limit` commands running at once.
+@pub fn procpool_wlimit(limit: int) {
+    return __internal_procpool__(limit);
 }
 ### End
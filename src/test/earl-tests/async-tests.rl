@@ -0,0 +1,65 @@
+module AsyncTests
+
+import "std/assert.rl";
+import "std/async.rl";
+import "test-utils.rl";
+
+Assert::FILE = __FILE__;
+
+@async
+fn delayed(ms, value) {
+    let _ = Async::await(Async::timer(ms));
+    return value;
+}
+
+@async
+fn sleepy(us, value) {
+    sleep(us);
+    return value;
+}
+
+@async
+fn sum_of_delayed() {
+    let values = Async::await_all([delayed(20, 1), delayed(10, 2), delayed(0, 3)]);
+    return values[0]+values[1]+values[2];
+}
+
+fn test_async_await(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let t = delayed(1, 5);
+    Assert::eq(t.done(), false);
+    Assert::eq(Async::await(t), 5);
+    Assert::eq(t.done(), true);
+
+    Assert::eq(Async::await(sum_of_delayed()), 6);
+}
+
+fn test_async_await_any(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let first = Async::await_any([delayed(50, "slow"), delayed(5, "fast")]);
+    Assert::eq(first, (1, "fast"));
+
+    let woke = Async::await_any([sleepy(40000, "long"), sleepy(2000, "short")]);
+    Assert::eq(woke, (1, "short"));
+}
+
+fn test_async_bash(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let a = Async::bash("echo hello; echo oops >&2; exit 2");
+    let b = Async::bash("printf world");
+    Assert::eq(Async::await(b), (0, "world", ""));
+    Assert::eq(Async::await(a), (2, "hello\n", "oops\n"));
+}
+
+@pub @world
+fn run(should_print, crash_on_failure) {
+    let out = should_print;
+    Assert::CRASH_ON_FAILURE = crash_on_failure;
+
+    test_async_await(out);
+    test_async_await_any(out);
+    test_async_bash(out);
+}
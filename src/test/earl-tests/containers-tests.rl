@@ -0,0 +1,96 @@
+module ContainersTests
+
+import "std/assert.rl";
+import "std/containers/set.rl";
+import "std/containers/deque.rl";
+import "std/containers/priority-queue.rl";
+import "test-utils.rl";
+
+Assert::FILE = __FILE__;
+
+fn test_set_basic(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let s = Set::new([1, 2, 3, 2, 1]);
+    Assert::eq(len(s), 3);
+    Assert::is_true(s.contains(2));
+    Assert::is_false(s.contains(4));
+    Assert::is_false(s.contains("2"));
+
+    s.insert("2");
+    Assert::eq(len(s), 4);
+    Assert::is_true(s.remove(1));
+    Assert::is_false(s.remove(1));
+    Assert::eq(len(s), 3);
+}
+
+fn test_set_ops(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let a = Set::new([1, 2, 3, 4]);
+    let b = Set::new([3, 4, 5]);
+    Assert::eq(a.union(b), Set::new([1, 2, 3, 4, 5]));
+    Assert::eq(a.intersection(b), Set::new([3, 4]));
+    Assert::eq(a.difference(b), Set::new([1, 2]));
+    Assert::is_true(Set::new([]).empty());
+
+    let sum = 0;
+    foreach x in a { sum += x; }
+    Assert::eq(sum, 10);
+}
+
+fn test_deque(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let d = Deque::new([2, 3]);
+    d.push_front(1);
+    d.push_back(4);
+    Assert::eq(d.front(), 1);
+    Assert::eq(d.back(), 4);
+
+    for i in 0 to 100 {
+        d.push_back(i);
+        d.push_front(i);
+    }
+    Assert::eq(len(d), 204);
+    Assert::eq(d.pop_front(), 99);
+    Assert::eq(d.pop_back(), 99);
+
+    while len(d) > 1 {
+        let _ = d.pop_front();
+    }
+    Assert::eq(d.pop_back(), 98);
+    Assert::is_true(d.empty());
+}
+
+fn test_priority_queue(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let q = PriorityQueue::new();
+    foreach x in [5, 1, 4, 2, 3] { q.push(x); }
+    Assert::eq(q.top(), 1);
+
+    let lst = [];
+    while !q.empty() {
+        lst.append(q.pop());
+    }
+    Assert::eq(lst, [1, 2, 3, 4, 5]);
+
+    let maxq = PriorityQueue::with_cmp(|a, b| { return a > b; });
+    foreach x in [5, 1, 4, 2, 3] { maxq.push(x); }
+    Assert::eq(maxq.pop(), 5);
+    Assert::eq(maxq.pop(), 4);
+    Assert::eq(len(maxq), 3);
+}
+
+# ENTRYPOINT
+@pub @world
+fn run(should_print, crash_on_failure) {
+    let out = should_print;
+    Assert::CRASH_ON_FAILURE = crash_on_failure;
+
+    test_set_basic(out);
+    test_set_ops(out);
+    test_deque(out);
+    test_priority_queue(out);
+}
@@ -130,6 +130,23 @@ fn test_basic_foreach_up(out) {
     Assert::eq(c, 10);
 }
 
+fn test_foreach_bash_lines(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let lines = [];
+    foreach line in $"printf 'a\nb b\n\nc'" |> lines {
+        lines.append(line);
+    }
+    Assert::eq(lines, ["a", "b b", "", "c"]);
+
+    let n = 0;
+    foreach line in $"seq 1 100000" |> lines {
+        n += 1;
+        if line == "500" { break; }
+    }
+    Assert::eq(n, 500);
+}
+
 # ENTRYPOINT
 @pub @world
 fn run(should_print, crash_on_failure) {
@@ -145,4 +162,5 @@ fn run(should_print, crash_on_failure) {
     test_foreach_ref(out);
     test_foreach_tuple(out);
     test_foreach_dict(out);
+    test_foreach_bash_lines(out);
 }
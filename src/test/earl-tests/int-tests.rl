@@ -1,6 +1,7 @@
 module IntTests
 
 import "std/assert.rl";
+import "std/containers/matrix.rl";
 import "test-utils.rl";
 
 Assert::FILE = __FILE__;
@@ -28,6 +29,66 @@ fn test_basic_int(out) {
     Assert::eq(i, 15);
 }
 
+fn test_int_overflow_promotes(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let ms = 1700000000 * 1000;
+    Assert::eq(ms, 1700000000000);
+
+    let max = 9223372036854775807;
+    Assert::eq(str(max + 1), "9223372036854775808");
+    Assert::eq(max + 1 - 1, max);
+    Assert::eq(str(1 << 70), "1180591620717411303424");
+
+    let p = 1;
+    for i in 0 to 100 { p *= 2; }
+    Assert::eq(str(p), "1267650600228229401496703205376");
+    Assert::is_true(p > max);
+
+    # Large enough for Karatsuba multiplication.
+    let a = 1;
+    for i in 0 to 2000 { a = a * 3; }
+    let c = a + 12345;
+    let prod = a * c;
+    Assert::eq(prod / c, a);
+    Assert::eq(prod % a, 0);
+    Assert::eq(int("123456789012345678901234567890") + 1, 123456789012345678901234567891);
+}
+
+fn test_int_64bit_conversions(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(float(5000000000), 5000000000.0);
+    Assert::eq(bool(4294967296), true);
+    Assert::eq(bool(0), false);
+    Assert::eq(cos(4294967296), cos(4294967296.0));
+    Assert::eq(sin(4294967296), sin(4294967296.0));
+
+    Assert::eq(4999999998..5000000001, [4999999998, 4999999999, 5000000000]);
+    Assert::eq(4999999999..=5000000000, [4999999999, 5000000000]);
+    Assert::eq(9223372036854775806..=9223372036854775807, [9223372036854775806, 9223372036854775807]);
+
+    let n = 0;
+    let last = 0;
+    for i in 4999999998 to 5000000001 {
+        n += 1;
+        last = i;
+    }
+    Assert::eq(n, 3);
+    Assert::eq(last, 5000000000);
+
+    let m = Matrix::zeros(4294967298, 0);
+    Assert::eq(m.rows(), 4294967298);
+
+    let s = "abc";
+    Assert::eq(s[2], 'c');
+    Assert::eq(s.substr(1, 4294967298), "bc");
+    Assert::eq(len(s), 3);
+    let lst = [1, 2, 3];
+    lst.pop(1);
+    Assert::eq(lst, [1, 3]);
+}
+
 # ENTRYPOINT
 @pub @world
 fn run(should_print, crash_on_failure) {
@@ -35,4 +96,6 @@ fn run(should_print, crash_on_failure) {
     Assert::CRASH_ON_FAILURE = crash_on_failure;
 
     test_basic_int(out);
+    test_int_overflow_promotes(out);
+    test_int_64bit_conversions(out);
 }
@@ -1,6 +1,7 @@
 module IntrinsicsTests
 
 import "std/assert.rl";
+import "std/system.rl";
 import "test-utils.rl";
 
 Assert::FILE = __FILE__;
@@ -103,6 +104,37 @@ fn test_intrinsic_assert(out) {
     assert(len("hi") == 2);
 }
 
+fn test_intrinsic_pipeline(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let codes, res = System::pipeline(["printf 'a\nbb\nc\n'", "grep -v c", "wc -l"]);
+    Assert::eq(codes, [0, 0, 0]);
+    Assert::eq(res.trim(), "2");
+
+    let _, doubled = System::pipeline(["printf 'x\ny\n'", |chunk| {
+        return chunk.split("\n").filter(|s| { return s != ""; }).map(|s| { return s + s; }).fold(|s, acc| { return acc + s + "\n"; }, "");
+    }, "sort -r"]);
+    Assert::eq(doubled, "yy\nxx\n");
+
+    let failed, _ = System::pipeline(["true", "false"]);
+    Assert::eq(failed, [0, 1]);
+}
+
+fn test_intrinsic_stats(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let stats = __stats__();
+    Assert::eq(type(stats["types"].unwrap()), "DictStr");
+    Assert::eq(type(stats["sites"].unwrap()), "DictStr");
+
+    # Only counted when built with -DALLOC_STATS=ON and run with --alloc-stats.
+    if stats["active"].unwrap() {
+        let xs = [1.5, 2.5, 3.5];
+        let types = __stats__()["types"].unwrap();
+        let floats = types["float"].unwrap();
+        Assert::eq(floats["live"].unwrap() >= len(xs), true);
+    }
+}
 
 # ENTRYPOINT
 @pub @world
@@ -124,4 +156,6 @@ fn run(should_print, crash_on_failure) {
     test_intrinsic_list(out);
     test_intrinsic_unit(out);
     test_intrinsic_dict(out);
+    test_intrinsic_pipeline(out);
+    test_intrinsic_stats(out);
 }
@@ -2,6 +2,8 @@ module IOModuleTests
 
 import "std/assert.rl";
 import "std/io.rl";
+import "std/datatypes/bytes.rl";
+import "std/system.rl";
 import "test-utils.rl";
 
 Assert::FILE = __FILE__;
@@ -22,6 +24,111 @@ fn test_file_to_str(out) {
     Assert::eq(s, "hello world\n");
 }
 
+fn test_file_lines(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let f = open("./other-files/read-lines-test.txt", "r");
+    let lines = [];
+    foreach line in f.lines() {
+        lines.append(line);
+    }
+    Assert::eq(lines, ["foo", "bar", "baz"]);
+
+    # `lines()` starts over from the beginning every time.
+    let first = "";
+    foreach line in f.lines() {
+        first = line;
+        break;
+    }
+    Assert::eq(first, "foo");
+    Assert::eq(f.read(), "foo\nbar\nbaz\n");
+    f.close();
+}
+
+fn test_buffered_writer(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let fp = "/tmp/earl-io-module-tests-buffered.txt";
+    let f = open(fp, "w", 8);
+    f.write("ab");
+    f.write(12);
+    f.write("longer than the buffer\n");
+    f.writelines(["x", 'y', 3]);
+    f.flush();
+    Assert::eq(IO::file_to_str(fp), "ab12longer than the buffer\nx\ny\n3\n");
+    f.write("tail");
+    f.close();
+    Assert::eq(IO::file_to_str(fp), "ab12longer than the buffer\nx\ny\n3\ntail");
+
+    IO::write_lines(["foo", "bar"], fp);
+    Assert::eq(IO::read_lines(fp), ["foo", "bar", ""]);
+}
+
+fn test_buffered_dump(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    # `dump` prints to stdout, so it is run in its own process.
+    $"earl ./other-files/buffered-dump.rl" |> let output;
+    Assert::eq(output, "empty:\nhello\nafter");
+}
+
+fn test_print_all(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    $"earl ./other-files/print-all.rl" |> let output;
+    Assert::eq(output, "a\n1\ntrue\na, 1, true");
+}
+
+fn test_walk(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let root = "/tmp/earl-walk-test";
+    $"rm -rf /tmp/earl-walk-test && mkdir -p /tmp/earl-walk-test/a/b && touch /tmp/earl-walk-test/x.rl /tmp/earl-walk-test/a/y.txt /tmp/earl-walk-test/a/b/z.rl";
+
+    let all = [root+"/a/b/z.rl", root+"/a/y.txt", root+"/x.rl"];
+    Assert::eq(IO::walkdir(root), all);
+    Assert::eq(IO::walk(root, {"threads": 4}), all);
+    Assert::eq(IO::walk(root, {"ext": ".rl"}), [root+"/a/b/z.rl", root+"/x.rl"]);
+    Assert::eq(IO::walk(root, {"glob": "y*"}), [root+"/a/y.txt"]);
+    Assert::eq(IO::walk(root, {"max_depth": 1}), [root+"/x.rl"]);
+    Assert::eq(System::get_all_files_by_ext(root, "rl"), [root+"/x.rl"]);
+    Assert::eq(IO::walk(root, {"dirs": true, "max_depth": 2}), [root+"/a", root+"/a/b", root+"/a/y.txt", root+"/x.rl"]);
+
+    $"rm -rf /tmp/earl-walk-test";
+}
+
+fn test_bytes(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let fp = "/tmp/earl-bytes-test.bin";
+    let f = open(fp, "wb");
+    f.write_bytes(Bytes::from([0x89, 0x50, 0x4e, 0x47, 0x01, 0x02, 0xff, 0xfe]));
+    f.write_bytes(Bytes::from("IEND"));
+    f.close();
+
+    let g = open(fp, "rb");
+    let head = g.read_bytes(4);
+    let rest = g.read_bytes();
+    g.close();
+
+    Assert::eq(len(head), 4);
+    Assert::eq(head.hex(), "89504e47");
+    Assert::eq(head[1:].decode(), "PNG");
+    Assert::eq(len(rest), 8);
+    Assert::eq(rest[0], 1);
+    Assert::eq(rest.int_le(0, 2), 0x0201);
+    Assert::eq(rest.int_be(0, 2), 0x0102);
+    Assert::eq(rest.int_le(2, 2, true), -257);
+    Assert::eq(rest.find("IEND"), 4);
+    Assert::eq(rest.find(0xff), 2);
+    Assert::eq(rest.find("IEND", 5), -1);
+    Assert::eq(rest[4:] == Bytes::from("IEND"), true);
+    Assert::eq(head + rest[4:], Bytes::from([0x89]) + Bytes::from("PNGIEND"));
+    Assert::eq(Bytes::from("123456789").crc32(), 0xcbf43926);
+
+    $"rm -f /tmp/earl-bytes-test.bin";
+}
+
 fn test_Fd(out) {
     TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
 
@@ -39,4 +146,10 @@ fn run(should_print, crash_on_failure) {
     test_Fd(out);
     test_file_to_str(out);
     test_read_lines(out);
+    test_file_lines(out);
+    test_buffered_writer(out);
+    test_buffered_dump(out);
+    test_print_all(out);
+    test_walk(out);
+    test_bytes(out);
 }
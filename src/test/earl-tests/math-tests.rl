@@ -0,0 +1,59 @@
+module MathTests
+
+import "std/assert.rl";
+import "std/math.rl";
+import "test-utils.rl";
+
+Assert::FILE = __FILE__;
+
+fn test_int_power(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(2**62, 4611686018427387904);
+    Assert::eq(3**40, int("12157665459056928801"));
+    Assert::eq(7**0, 1);
+    Assert::eq(2**-1, 0);
+    Assert::eq((-1)**-3, -1);
+    Assert::eq(2**10, 1024);
+}
+
+fn test_float_power(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(Math::pow(2, 0.5) > 1.4142, true);
+    Assert::eq(Math::pow(2, 0.5) < 1.4143, true);
+    Assert::eq(2.0**24 + 1.0, 16777217.0);
+}
+
+fn test_number_theory(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(Math::powmod(4, 13, 497), 445);
+    Assert::eq(Math::powmod(-2, 3, 5), 2);
+    Assert::eq(Math::powmod(3, 1000, 1000000007), 3**1000 % 1000000007);
+    Assert::eq(Math::gcd(12, 18), 6);
+    Assert::eq(Math::gcd(-12, 0), 12);
+    Assert::eq(Math::lcm(4, 6), 12);
+    Assert::eq(Math::gcd(3**50, 3**45 * 2), 3**45);
+}
+
+fn test_floor_ceil(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(Math::floor(-1.5), -2);
+    Assert::eq(Math::floor(1.5), 1);
+    Assert::eq(Math::ceil(1.2), 2);
+    Assert::eq(Math::ceil(-1.2), -1);
+    Assert::eq(Math::ceil(3), 3);
+}
+
+@pub @world
+fn run(should_print, crash_on_failure) {
+    let out = should_print;
+    Assert::CRASH_ON_FAILURE = crash_on_failure;
+
+    test_int_power(out);
+    test_float_power(out);
+    test_number_theory(out);
+    test_floor_ceil(out);
+}
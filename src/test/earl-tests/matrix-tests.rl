@@ -0,0 +1,64 @@
+module MatrixTests
+
+import "std/assert.rl";
+import "std/containers/matrix.rl";
+import "test-utils.rl";
+
+Assert::FILE = __FILE__;
+
+fn test_matrix_elementwise(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let a = Matrix::new(2, 2, [1, 2, 3, 4]);
+    let b = Matrix::new(2, 2, [[4, 3], [2, 1]]);
+    Assert::eq(a + b, Matrix::new(2, 2, [5, 5, 5, 5]));
+    Assert::eq(a - b, Matrix::new(2, 2, [-3, -1, 1, 3]));
+    Assert::eq(a * b, Matrix::new(2, 2, [4, 6, 6, 4]));
+    Assert::eq(a * 2, Matrix::new(2, 2, [2, 4, 6, 8]));
+    Assert::eq(a / 2.0, Matrix::new(2, 2, [0.5, 1, 1.5, 2]));
+
+    a.set(0, 1, 7);
+    Assert::eq(a.at(0, 1), 7.0);
+    Assert::eq(a.rows(), 2);
+    Assert::eq(a.cols(), 2);
+}
+
+fn test_matrix_matmul(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let a = Matrix::new(2, 3, [1, 2, 3, 4, 5, 6]);
+    let b = a.transpose();
+    Assert::eq(b.rows(), 3);
+    Assert::eq(b.at(2, 1), 6.0);
+    Assert::eq(a.matmul(b), Matrix::new(2, 2, [14, 32, 32, 77]));
+    Assert::eq(a.matmul(b, 2), a.matmul(b));
+
+    let n = 70;
+    let id = Matrix::zeros(n, n);
+    for i in 0 to n { id.set(i, i, 1); }
+    let m = Matrix::zeros(n, n);
+    for i in 0 to n { m.set(i, (i*7)%n, i); }
+    Assert::eq(m.matmul(id), m);
+    Assert::eq(id.matmul(m, 4), m);
+}
+
+fn test_matrix_module(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let m = Matrix::from2d([[1, 2], [3, 4]]);
+    Assert::eq(m.at(1, 0), 3.0);
+    let p = Matrix::mul(m, Matrix::from1d([0, 1, 1, 0], 2, 2));
+    Assert::eq(p.at(0, 0), 2.0);
+    Assert::eq(Matrix::transpose(m).at(0, 1), 3.0);
+}
+
+# ENTRYPOINT
+@pub @world
+fn run(should_print, crash_on_failure) {
+    let out = should_print;
+    Assert::CRASH_ON_FAILURE = crash_on_failure;
+
+    test_matrix_elementwise(out);
+    test_matrix_matmul(out);
+    test_matrix_module(out);
+}
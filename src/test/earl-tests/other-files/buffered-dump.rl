@@ -0,0 +1,16 @@
+module Main
+
+let fp = "/tmp/earl-io-module-tests-dump.txt";
+open(fp, "w").close();
+
+println("empty:");
+let empty = open(fp, "r");
+empty.dump();
+empty.close();
+
+let f = open(fp, "rw", 64);
+f.write("hello\n");
+f.dump();
+f.close();
+
+println("after");
@@ -0,0 +1,7 @@
+module Main
+
+import "std/io.rl";
+
+IO::print_all(["a", 1, true]);
+IO::set_stdout_buffer("full");
+IO::print_all_wsep(["a", 1, true], ", ");
@@ -0,0 +1,52 @@
+module ProcPoolTests
+
+import "std/assert.rl";
+import "std/system.rl";
+import "test-utils.rl";
+
+Assert::FILE = __FILE__;
+
+fn test_procpool_wait(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let pool = System::procpool_wlimit(2);
+    let a = pool.spawn("echo hello");
+    let b = pool.spawn("echo oops >&2; exit 3");
+    Assert::eq(pool.pending(), 2);
+
+    let rb = pool.wait(b);
+    Assert::eq(rb[0], 3);
+    Assert::eq(rb[1], "");
+    Assert::eq(rb[2], "oops\n");
+
+    let ra = pool.wait(a);
+    Assert::eq(ra, (0, "hello\n", ""));
+    Assert::eq(pool.pending(), 0);
+}
+
+fn test_procpool_wait_all(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let pool = System::procpool_wlimit(3);
+    for i in 0 to 8 {
+        let _ = pool.spawn(f"echo {i}");
+    }
+
+    let first = pool.wait_any();
+    Assert::eq(first[1], 0);
+    let h = first[0];
+    Assert::eq(first[2], f"{h}\n");
+
+    let rest = pool.wait_all();
+    Assert::eq(len(rest), 7);
+    Assert::eq(pool.pending(), 0);
+}
+
+@pub @world
+fn run(should_print, crash_on_failure) {
+    let out = should_print;
+    Assert::CRASH_ON_FAILURE = crash_on_failure;
+
+    test_procpool_wait(out);
+    test_procpool_wait_all(out);
+}
@@ -0,0 +1,93 @@
+module ShellTests
+
+import "std/assert.rl";
+import "std/system.rl";
+import "std/io.rl";
+import "test-utils.rl";
+
+Assert::FILE = __FILE__;
+
+# Simple commands are spawned directly and everything else goes
+# through `/bin/sh`. The `: ;` prefix always forces the shell, so
+# both ways have to give the same exit status and output.
+fn run_both(cmd) {
+    let direct = System::cmdstr_wexitcode(cmd);
+    let shell = System::cmdstr_wexitcode(": ; "+cmd);
+    Assert::eq(direct, shell);
+    return direct;
+}
+
+fn test_shell_quoting(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(run_both("printf '%s|' 'a  b' \"c d\" e"), (0, "a  b|c d|e|"));
+    Assert::eq(run_both("printf '%s|' a''b \"x\"y ''"), (0, "ab|xy||"));
+    Assert::eq(run_both("printf '%s|' '$HOME' 'a;b' 'c|d'"), (0, "$HOME|a;b|c|d|"));
+    Assert::eq(run_both("printf '%s|' a=b --opt=1,2 x:y@z"), (0, "a=b|--opt=1,2|x:y@z|"));
+}
+
+fn test_shell_builtins(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    # Builtins that are also programs must run as the shell's builtin.
+    Assert::eq(System::cmdstr_wexitcode("echo 'a\\tb'"), System::cmdstr_wexitcode("sh -c \"echo 'a\\tb'\""));
+    Assert::eq(System::cmdstr_wexitcode("echo -e x"), System::cmdstr_wexitcode("sh -c 'echo -e x'"));
+    Assert::eq(run_both("printf '%s\\n' a"), (0, "a\n"));
+    Assert::eq(run_both("test -d /tmp")[0], 0);
+    Assert::eq(run_both("[ -d /tmp ]")[0], 0);
+    Assert::eq(run_both("pwd"), (0, System::cmdstr("sh -c pwd")));
+}
+
+fn test_shell_expansions(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let home = System::cmdstr("printenv HOME");
+    Assert::eq(run_both("echo $HOME"), (0, home));
+    Assert::eq(run_both("echo \"$HOME\""), (0, home));
+    Assert::eq(run_both("EARL_SHELL_TEST=hi printenv EARL_SHELL_TEST"), (0, "hi\n"));
+    Assert::eq(run_both("echo ~"), (0, home));
+
+    let dir = "/tmp/earl-shell-tests";
+    $"rm -rf /tmp/earl-shell-tests && mkdir -p /tmp/earl-shell-tests && touch /tmp/earl-shell-tests/a.txt /tmp/earl-shell-tests/b.txt /tmp/earl-shell-tests/c.rl";
+    Assert::eq(run_both("ls "+dir+"/*.txt"), (0, dir+"/a.txt\n"+dir+"/b.txt\n"));
+    Assert::eq(run_both("ls "+dir+"/?.rl"), (0, dir+"/c.rl\n"));
+}
+
+fn test_shell_redirects(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    let fp = "/tmp/earl-shell-tests-redirect.txt";
+    Assert::eq(run_both("echo hi > "+fp), (0, ""));
+    Assert::eq(IO::file_to_str(fp), "hi\n");
+    # Runs once each way.
+    Assert::eq(run_both("echo hi >> "+fp), (0, ""));
+    Assert::eq(IO::file_to_str(fp), "hi\nhi\nhi\n");
+    Assert::eq(run_both("tr a-z A-Z < "+fp), (0, "HI\nHI\nHI\n"));
+    Assert::eq(run_both("echo a b | wc -w"), (0, "2\n"));
+}
+
+fn test_shell_exit_status(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::eq(run_both("true")[0], 0);
+    Assert::eq(run_both("false")[0], run_both("exit 1")[0]);
+    Assert::is_true(run_both("false")[0] != 0);
+
+    # Builtins and missing programs cannot be spawned directly.
+    Assert::eq(run_both("cd /tmp"), (0, ""));
+    let missing = run_both("earl-shell-tests-no-such-command 2>/dev/null");
+    Assert::eq(missing, run_both("exit 127"));
+    Assert::eq(System::cmdstr_wexitcode("earl-shell-tests-no-such-command 2>/dev/null")[0], missing[0]);
+}
+
+@pub @world
+fn run(should_print, crash_on_failure) {
+    let out = should_print;
+    Assert::CRASH_ON_FAILURE = crash_on_failure;
+
+    test_shell_quoting(out);
+    test_shell_builtins(out);
+    test_shell_expansions(out);
+    test_shell_redirects(out);
+    test_shell_exit_status(out);
+}
@@ -21,6 +21,12 @@ import "./io-module-tests.rl";
 import "./while-loops-tests.rl";
 import "./foreach-loop-tests.rl";
 import "./fn-test.rl";
+import "./containers-tests.rl";
+import "./matrix-tests.rl";
+import "./math-tests.rl";
+import "./procpool-tests.rl";
+import "./async-tests.rl";
+import "./shell-tests.rl";
 
 fn main() {
     let should_print = true;
@@ -44,6 +50,12 @@ fn main() {
     WhileLoopTests::run(should_print, crash_on_failure);
     ForeachLoopTests::run(should_print, crash_on_failure);
     FnTests::run(should_print, crash_on_failure);
+    ContainersTests::run(should_print, crash_on_failure);
+    MatrixTests::run(should_print, crash_on_failure);
+    MathTests::run(should_print, crash_on_failure);
+    ProcPoolTests::run(should_print, crash_on_failure);
+    AsyncTests::run(should_print, crash_on_failure);
+    ShellTests::run(should_print, crash_on_failure);
 }
 
 main();
\ No newline at end of file
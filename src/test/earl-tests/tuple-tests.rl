@@ -78,6 +78,29 @@ fn test_basic_tuple(out) {
     Assert::eq(t2, (1,));
 }
 
+fn test_tuple_dict_keys(out) {
+    TestUtils::log(out, __FILE__, __FUNC__, Assert::FUNC);
+
+    Assert::is_true((1, 2) != (2, 1));
+
+    let d = {(0, 1): "right", (1, 0): "down"};
+    Assert::eq(d[(0, 1)].unwrap(), "right");
+    Assert::is_true(d[(1, 1)].is_none());
+
+    let x = 3;
+    let key = (x, "node");
+    d.insert(key, "mid");
+    x = 4;
+    Assert::is_true(d.has_key((3, "node")));
+    Assert::is_false(d.has_key((4, "node")));
+
+    let g = Dict();
+    g.insert(true, 1);
+    g.insert((1, (2, 'c')), 2);
+    Assert::eq(g[(1, (2, 'c'))].unwrap(), 2);
+    Assert::eq(g[true].unwrap(), 1);
+}
+
 # ENTRYPOINT
 @pub @world
 fn run(should_print, crash_on_failure) {
@@ -90,4 +113,5 @@ fn run(should_print, crash_on_failure) {
     test_tuple_filter(out);
     test_tuple_foreach(out);
     test_tuple_contains(out);
+    test_tuple_dict_keys(out);
 }
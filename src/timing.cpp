@@ -0,0 +1,227 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "timing.hpp"
+#include "common.hpp"
+
+#define N_PHASES (static_cast<int>(timing::Phase::Interpret)+1)
+
+namespace {
+    struct Frame {
+        timing::Phase phase;
+        int64_t start_ns;
+        int64_t child_ns;
+        // Index into `modules`, or -1.
+        int64_t module;
+    };
+
+    struct PhaseTotal {
+        int64_t ns = 0;
+        uint64_t count = 0;
+    };
+
+    struct Module {
+        std::string path;
+        int64_t ns;
+        // How many imports it is inside of.
+        size_t depth;
+    };
+};
+
+static const char *phase_names[N_PHASES] = {
+    "config",
+    "mem file",
+    "read",
+    "lex",
+    "parse",
+    "import",
+    "interpret",
+};
+
+static const char *phase_keys[N_PHASES] = {
+    "hidden_file",
+    "mem_file",
+    "read_file",
+    "lex_file",
+    "parse_program",
+    "import",
+    "interpret",
+};
+
+static std::vector<Frame> stack = {};
+static PhaseTotal totals[N_PHASES];
+static std::vector<Module> modules = {};
+static std::string json_path = "";
+static bool enabled = false;
+
+static inline int64_t
+now_ns(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void
+report_atexit(void) {
+    timing::report();
+}
+
+void
+timing::enable(const std::string &json_out) {
+    json_path = json_out;
+    if (!enabled)
+        std::atexit(report_atexit);
+    enabled = true;
+}
+
+size_t
+timing::enter(Phase phase, const std::string *module) {
+    int64_t idx = -1;
+    if (module) {
+        size_t depth = 0;
+        for (const Frame &f : stack)
+            depth += f.module >= 0;
+        idx = static_cast<int64_t>(modules.size());
+        modules.push_back(Module{*module, 0, depth});
+    }
+    stack.push_back(Frame{phase, now_ns(), 0, idx});
+    return stack.size()-1;
+}
+
+void
+timing::leave(size_t depth) {
+    int64_t now = now_ns();
+    while (stack.size() > depth) {
+        Frame f = stack.back();
+        stack.pop_back();
+        int64_t elapsed = now-f.start_ns;
+        PhaseTotal &t = totals[static_cast<int>(f.phase)];
+        t.ns += elapsed-f.child_ns;
+        if (f.phase != Phase::Import || f.module >= 0)
+            ++t.count;
+        if (f.module >= 0)
+            modules[f.module].ns = elapsed;
+        if (!stack.empty())
+            stack.back().child_ns += elapsed;
+    }
+}
+
+static std::string
+json_escape(const std::string &s) {
+    std::string res = "";
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            res += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            res += buf;
+        }
+        else
+            res += c;
+    }
+    return res;
+}
+
+static void
+write_json(double total_ms, double startup_ms, double execution_ms) {
+    std::ofstream f(json_path);
+    if (!f) {
+        std::cerr << "[EARL time] error: could not write `" << json_path << "`" << std::endl;
+        return;
+    }
+    f << "{\n  \"total_ms\": " << total_ms
+      << ",\n  \"startup_ms\": " << startup_ms
+      << ",\n  \"execution_ms\": " << execution_ms
+      << ",\n  \"phases\": {";
+    for (int i = 0; i < N_PHASES; ++i) {
+        f << (i == 0 ? "\n" : ",\n")
+          << "    \"" << phase_keys[i] << "\": {\"ms\": " << static_cast<double>(totals[i].ns)/1e6
+          << ", \"count\": " << totals[i].count << "}";
+    }
+    f << "\n  },\n  \"imports\": [";
+    for (size_t i = 0; i < modules.size(); ++i) {
+        f << (i == 0 ? "\n" : ",\n")
+          << "    {\"path\": \"" << json_escape(modules[i].path) << "\", \"ms\": "
+          << static_cast<double>(modules[i].ns)/1e6 << ", \"depth\": " << modules[i].depth << "}";
+    }
+    f << "\n  ]\n}\n";
+}
+
+void
+timing::report(void) {
+    if (!enabled)
+        return;
+    enabled = false;
+
+    // Phases that are still running (the program
+    // exited from inside of them) are finished now.
+    leave(0);
+
+    config::prelude::time::end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = config::prelude::time::end - config::prelude::time::start;
+    double total_ms = elapsed.count()*1e3;
+    double execution_ms = static_cast<double>(totals[static_cast<int>(Phase::Interpret)].ns)/1e6;
+    double phases_ms = 0.0;
+    for (int i = 0; i < N_PHASES; ++i)
+        phases_ms += static_cast<double>(totals[i].ns)/1e6;
+    double startup_ms = phases_ms-execution_ms;
+
+    char line[256];
+    auto pct = [&](double ms) { return total_ms > 0.0 ? 100.0*ms/total_ms : 0.0; };
+
+    std::cout << "[EARL time] Execution time: " << elapsed.count() << " seconds" << std::endl;
+    std::snprintf(line, sizeof(line), "%-12s %12s %7s %8s", "phase", "ms", "%", "count");
+    std::cout << line << std::endl;
+    for (int i = 0; i < N_PHASES; ++i) {
+        double ms = static_cast<double>(totals[i].ns)/1e6;
+        std::snprintf(line, sizeof(line), "%-12s %12.3f %6.1f%% %8llu",
+                      phase_names[i], ms, pct(ms), static_cast<unsigned long long>(totals[i].count));
+        std::cout << line << std::endl;
+    }
+    std::snprintf(line, sizeof(line), "%-12s %12.3f %6.1f%%", "other", total_ms-phases_ms, pct(total_ms-phases_ms));
+    std::cout << line << std::endl;
+    std::snprintf(line, sizeof(line), "startup %.3f ms (%.1f%%), execution %.3f ms (%.1f%%)",
+                  startup_ms, pct(startup_ms), execution_ms, pct(execution_ms));
+    std::cout << line << std::endl;
+
+    if (!modules.empty()) {
+        std::snprintf(line, sizeof(line), "%-12s %12s  %s", "import", "ms", "module (with everything it runs)");
+        std::cout << line << std::endl;
+        for (const Module &m : modules) {
+            std::snprintf(line, sizeof(line), "%-12s %12.3f  ", "", static_cast<double>(m.ns)/1e6);
+            std::cout << line << std::string(2*m.depth, ' ') << m.path << std::endl;
+        }
+    }
+
+    if (json_path != "")
+        write_json(total_ms, startup_ms, execution_ms);
+}
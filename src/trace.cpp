@@ -0,0 +1,258 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "trace.hpp"
+
+// How often the writer thread appends to the file.
+#define TRACE_FLUSH_MS 250
+
+// Events that wake the writer thread early.
+#define TRACE_FLUSH_EVENTS 8192
+
+bool trace::active = false;
+
+static std::string out_path = "";
+static std::ofstream out;
+static int64_t start_ns = 0;
+static int pid = 0;
+static uint64_t written = 0;
+
+static std::mutex pending_lock;
+static std::condition_variable wake;
+static std::vector<std::string> pending = {};
+static bool stopping = false;
+static std::thread writer;
+
+static std::atomic<int> next_tid(1);
+static thread_local int tid = 0;
+
+static inline int64_t
+now_ns(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int
+this_tid(void) {
+    if (tid == 0)
+        tid = next_tid.fetch_add(1);
+    return tid;
+}
+
+static void
+json_escape_into(std::string &res, const std::string &s) {
+    for (char c : s) {
+        switch (c) {
+        case '"':  res += "\\\""; break;
+        case '\\': res += "\\\\"; break;
+        case '\n': res += "\\n"; break;
+        case '\t': res += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                res += buf;
+            }
+            else
+                res += c;
+        }
+    }
+}
+
+static void
+push(std::string event) {
+    std::lock_guard<std::mutex> guard(pending_lock);
+    pending.push_back(std::move(event));
+    if (pending.size() >= TRACE_FLUSH_EVENTS)
+        wake.notify_one();
+}
+
+// Only called by the writer thread, and by `finish` once it is gone.
+static void
+write_events(std::vector<std::string> &events) {
+    for (auto &event : events) {
+        out << (written == 0 ? "\n" : ",\n") << event;
+        ++written;
+    }
+    out.flush();
+    events.clear();
+}
+
+static void
+writer_main(void) {
+    std::vector<std::string> events = {};
+    std::unique_lock<std::mutex> guard(pending_lock);
+    while (!stopping) {
+        wake.wait_for(guard, std::chrono::milliseconds(TRACE_FLUSH_MS));
+        events.swap(pending);
+        guard.unlock();
+        write_events(events);
+        guard.lock();
+    }
+}
+
+static void
+metadata(const char *what, int thread, const std::string &name) {
+    std::string event = "{\"name\": \"";
+    event += what;
+    event += "\", \"ph\": \"M\", \"pid\": "+std::to_string(pid)+", \"tid\": "+std::to_string(thread)+", \"args\": {\"name\": \"";
+    json_escape_into(event, name);
+    event += "\"}}";
+    push(std::move(event));
+}
+
+static void
+finish_atexit(void) {
+    trace::finish();
+}
+
+void
+trace::enable(const std::string &path) {
+    if (active)
+        return;
+    out.open(path);
+    if (!out) {
+        std::cerr << "error: could not open `" << path << "` for the trace" << std::endl;
+        std::exit(1);
+    }
+    out_path = path;
+    out << "[";
+    start_ns = now_ns();
+    pid = static_cast<int>(getpid());
+    active = true;
+
+    metadata("process_name", this_tid(), "earl");
+    metadata("thread_name", this_tid(), "interpreter");
+
+    writer = std::thread(writer_main);
+    std::atexit(finish_atexit);
+}
+
+void
+trace::finish(void) {
+    if (!active)
+        return;
+    active = false;
+    {
+        std::lock_guard<std::mutex> guard(pending_lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    write_events(pending);
+    out << "\n]\n";
+    out.close();
+
+    std::cout.flush();
+    std::cerr << "[EARL trace] " << written << " events written to `" << out_path << "`" << std::endl;
+}
+
+void
+trace::Span::begin(const char *cat, const std::string &name) {
+    m_cat = cat;
+    m_name = name;
+    m_start_ns = now_ns();
+}
+
+void
+trace::Span::end(void) {
+    int64_t end_ns = now_ns();
+    char times[96];
+    std::snprintf(times, sizeof(times), "\"ts\": %.3f, \"dur\": %.3f",
+                  static_cast<double>(m_start_ns-start_ns)/1e3,
+                  static_cast<double>(end_ns-m_start_ns)/1e3);
+
+    std::string event = "{\"name\": \"";
+    json_escape_into(event, m_name);
+    event += "\", \"cat\": \"";
+    event += m_cat;
+    event += "\", \"ph\": \"X\", ";
+    event += times;
+    event += ", \"pid\": "+std::to_string(pid)+", \"tid\": "+std::to_string(this_tid());
+    if (!m_args.empty())
+        event += ", \"args\": {"+m_args+"}";
+    event += "}";
+
+    // Tracing may have stopped while this span was open.
+    if (active)
+        push(std::move(event));
+}
+
+void
+trace::Span::arg(const char *key, const std::string &value) {
+    if (!m_on)
+        return;
+    if (!m_args.empty())
+        m_args += ", ";
+    m_args += "\"";
+    m_args += key;
+    m_args += "\": \"";
+    json_escape_into(m_args, value);
+    m_args += "\"";
+}
+
+void
+trace::Span::arg(const char *key, int64_t value) {
+    if (!m_on)
+        return;
+    if (!m_args.empty())
+        m_args += ", ";
+    m_args += "\"";
+    m_args += key;
+    m_args += "\": "+std::to_string(value);
+}
+
+void
+trace::Span::site(Token *tok) {
+    if (!m_on || !tok)
+        return;
+    arg("site", tok->m_fp+":"+std::to_string(tok->m_row)+":"+std::to_string(tok->m_col));
+}
+
+void
+trace::Span::status(int status) {
+    if (!m_on)
+        return;
+    if (status == -1)
+        arg("exit", static_cast<int64_t>(-1));
+    else if (WIFEXITED(status))
+        arg("exit", static_cast<int64_t>(WEXITSTATUS(status)));
+    else if (WIFSIGNALED(status))
+        arg("signal", static_cast<int64_t>(WTERMSIG(status)));
+}
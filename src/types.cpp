@@ -124,6 +124,14 @@ std::string earl::value::type_to_str(earl::value::Type ty) {
     case earl::value::Type::Return:      return "unit";
     case earl::value::Type::FunctionRef: return "FunctionRef";
     case earl::value::Type::ClassRef:    return "ClassRef";
+    case earl::value::Type::Set:         return "Set";
+    case earl::value::Type::Deque:       return "Deque";
+    case earl::value::Type::PriorityQueue: return "PriorityQueue";
+    case earl::value::Type::Matrix:      return "Matrix";
+    case earl::value::Type::DictAny:     return "DictAny";
+    case earl::value::Type::ProcPool:    return "ProcPool";
+    case earl::value::Type::Task:        return "Task";
+    case earl::value::Type::Bytes:       return "bytes";
     default: ERR_WARGS(Err::Type::Fatal, "unknown type of id (%d) in processing", (int)ty);
     }
 }
@@ -0,0 +1,186 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "walk.hpp"
+
+struct Dir {
+    std::string path;
+    int depth;
+};
+
+static bool
+keep(const char *name, bool is_dir, const walk::Options &opts) {
+    if (is_dir && !opts.dirs)
+        return false;
+    if (!opts.glob.empty() && fnmatch(opts.glob.c_str(), name, 0) != 0)
+        return false;
+    if (!opts.exts.empty()) {
+        if (is_dir)
+            return false;
+        const char *dot = std::strrchr(name, '.');
+        if (!dot || dot == name)
+            return false;
+        return std::find(opts.exts.begin(), opts.exts.end(), dot+1) != opts.exts.end();
+    }
+    return true;
+}
+
+// Read one directory, putting what is kept in `out` and the
+// subdirectories that still have to be read in `subdirs`.
+static bool
+scan(const Dir &dir,
+     const walk::Options &opts,
+     std::vector<std::string> &out,
+     std::vector<Dir> &subdirs) {
+    int fd = open(dir.path.c_str(), O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+    if (fd == -1)
+        return false;
+    DIR *d = fdopendir(fd);
+    if (!d) {
+        close(fd);
+        return false;
+    }
+
+    const std::string prefix = dir.path.back() == '/' ? dir.path : dir.path+"/";
+    bool descend = opts.max_depth < 0 || dir.depth < opts.max_depth;
+
+    struct dirent *ent;
+    while ((ent = readdir(d)) != nullptr) {
+        const char *name = ent->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+            continue;
+
+        bool is_dir = ent->d_type == DT_DIR;
+        if (ent->d_type == DT_UNKNOWN) {
+            struct stat st;
+            if (fstatat(dirfd(d), name, &st, AT_SYMLINK_NOFOLLOW) == 0)
+                is_dir = S_ISDIR(st.st_mode);
+        }
+
+        if (keep(name, is_dir, opts))
+            out.push_back(prefix+name);
+        if (is_dir && descend)
+            subdirs.push_back(Dir{prefix+name, dir.depth+1});
+    }
+
+    closedir(d);
+    return true;
+}
+
+static void
+walk_sequential(std::vector<Dir> start, const walk::Options &opts, std::vector<std::string> &out) {
+    std::vector<Dir> stack = std::move(start);
+    std::vector<Dir> subdirs = {};
+    while (!stack.empty()) {
+        Dir dir = std::move(stack.back());
+        stack.pop_back();
+        subdirs.clear();
+        (void)scan(dir, opts, out, subdirs);
+        for (auto &sub : subdirs)
+            stack.push_back(std::move(sub));
+    }
+}
+
+// Every thread takes directories from a shared queue and puts the
+// subdirectories it finds back on it. The walk is over once the
+// queue is empty and nobody is in the middle of reading one.
+static void
+walk_parallel(std::vector<Dir> start, const walk::Options &opts, std::vector<std::string> &out) {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Dir> queue(std::make_move_iterator(start.begin()), std::make_move_iterator(start.end()));
+    size_t busy = 0;
+    std::vector<std::vector<std::string>> found(opts.threads);
+
+    auto worker = [&](size_t id) {
+        std::vector<Dir> subdirs = {};
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            cv.wait(lock, [&]() { return !queue.empty() || busy == 0; });
+            if (queue.empty())
+                break;
+            Dir dir = std::move(queue.front());
+            queue.pop_front();
+            ++busy;
+            lock.unlock();
+
+            subdirs.clear();
+            (void)scan(dir, opts, found[id], subdirs);
+
+            lock.lock();
+            --busy;
+            for (auto &sub : subdirs)
+                queue.push_back(std::move(sub));
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads = {};
+    for (size_t i = 1; i < opts.threads; ++i)
+        threads.emplace_back(worker, i);
+    worker(0);
+    for (auto &t : threads)
+        t.join();
+
+    for (auto &v : found)
+        out.insert(out.end(), std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+}
+
+std::vector<std::string>
+walk::walk(const std::string &root, const Options &opts) {
+    if (root.empty())
+        throw std::runtime_error("cannot walk an empty path");
+
+    std::vector<std::string> out = {};
+    std::vector<Dir> first = {};
+
+    // The root is read here so that it failing is an error,
+    // unlike any directory below it.
+    if (!scan(Dir{root, 1}, opts, out, first))
+        throw std::runtime_error("could not read directory `"+root+"`: "+strerror(errno));
+
+    if (opts.threads <= 1)
+        walk_sequential(std::move(first), opts, out);
+    else
+        walk_parallel(std::move(first), opts, out);
+
+    std::sort(out.begin(), out.end());
+    return out;
+}